@@ -0,0 +1,379 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugviews.cpp
+// ============
+// overdraw heat map and draw order views of the scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DebugViews.h"
+#include "InstancedMeshes.h"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+// declaration of global variables and constants
+namespace
+{
+	// positions come from attribute 0 of both the shape meshes and
+	// the instanced meshes; instances add their model matrix
+	const std::string OBJECT_VERTEX_SHADER =
+		"#version 330 core\n"
+		"layout(location = 0) in vec3 position;\n"
+		"layout(location = " + std::to_string(InstancedMeshes::INSTANCE_MODEL_ATTRIBUTE) + ") in mat4 instanceModel;\n"
+		"uniform mat4 viewProjection;\n"
+		"uniform mat4 model;\n"
+		"uniform bool bInstanced;\n"
+		"void main()\n"
+		"{\n"
+		"	mat4 objectModel = bInstanced ? instanceModel : model;\n"
+		"	gl_Position = viewProjection * objectModel * vec4(position, 1.0);\n"
+		"}\n";
+
+	const char* const OBJECT_FRAGMENT_SHADER =
+		"#version 330 core\n"
+		"uniform vec4 debugColor;\n"
+		"out vec4 fragmentColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragmentColor = debugColor;\n"
+		"}\n";
+
+	// one triangle covering the target, generated from the vertex index
+	const char* const HEAT_MAP_VERTEX_SHADER =
+		"#version 330 core\n"
+		"void main()\n"
+		"{\n"
+		"	vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\n"
+		"	gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);\n"
+		"}\n";
+
+	const char* const HEAT_MAP_FRAGMENT_SHADER =
+		"#version 330 core\n"
+		"uniform sampler2D overdrawCounts;\n"
+		"uniform float maxOverdraw;\n"
+		"out vec4 fragmentColor;\n"
+		"const vec3 RAMP[5] = vec3[5](vec3(0.0, 0.0, 1.0), vec3(0.0, 1.0, 1.0),\n"
+		"	vec3(0.0, 1.0, 0.0), vec3(1.0, 1.0, 0.0), vec3(1.0, 0.0, 0.0));\n"
+		"void main()\n"
+		"{\n"
+		"	float count = texelFetch(overdrawCounts, ivec2(gl_FragCoord.xy), 0).r;\n"
+		"	if (count < 0.5)\n"
+		"	{\n"
+		"		fragmentColor = vec4(0.0, 0.0, 0.0, 1.0);\n"
+		"		return;\n"
+		"	}\n"
+		"	float ramp = clamp((count - 1.0) / (maxOverdraw - 1.0), 0.0, 1.0) * 4.0;\n"
+		"	int index = min(int(ramp), 3);\n"
+		"	fragmentColor = vec4(mix(RAMP[index], RAMP[index + 1], ramp - float(index)), 1.0);\n"
+		"}\n";
+
+	// fragments per pixel shown in the hottest color
+	const float MAX_OVERDRAW = 8.0f;
+
+	// compile one stage of a debug shader, returning 0 on failure
+	GLuint CompileShader(GLenum stage, const char* source)
+	{
+		GLuint shader = glCreateShader(stage);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		GLint bCompiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &bCompiled);
+		if (GL_FALSE == bCompiled)
+		{
+			char log[512];
+			glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+			std::cout << "Could not compile debug view shader:" << log << std::endl;
+			glDeleteShader(shader);
+			return 0;
+		}
+		return shader;
+	}
+
+	// compile and link a debug program, returning 0 on failure
+	GLuint LinkProgram(const char* vertexSource, const char* fragmentSource)
+	{
+		GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource);
+		GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource);
+		if ((0 == vertexShader) || (0 == fragmentShader))
+		{
+			glDeleteShader(vertexShader);
+			glDeleteShader(fragmentShader);
+			return 0;
+		}
+
+		GLuint program = glCreateProgram();
+		glAttachShader(program, vertexShader);
+		glAttachShader(program, fragmentShader);
+		glLinkProgram(program);
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+
+		GLint bLinked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &bLinked);
+		if (GL_FALSE == bLinked)
+		{
+			std::cout << "Could not link debug view shader" << std::endl;
+			glDeleteProgram(program);
+			return 0;
+		}
+		return program;
+	}
+}
+
+/***********************************************************
+ *  DebugViews()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DebugViews::DebugViews(GLStateCache* pStateCache)
+{
+	m_pStateCache = pStateCache;
+	m_objectProgram = 0;
+	m_viewProjectionLocation = -1;
+	m_modelLocation = -1;
+	m_instancedLocation = -1;
+	m_colorLocation = -1;
+	m_heatMapProgram = 0;
+	m_maxOverdrawLocation = -1;
+	m_emptyVertexArray = 0;
+	m_countFBO = 0;
+	m_countTexture = 0;
+	m_countDepthRBO = 0;
+	m_countWidth = 0;
+	m_countHeight = 0;
+	m_view = VIEW_SHADED;
+	m_targetFramebuffer = 0;
+	m_previousProgram = 0;
+	m_previousBlendSource = GL_ONE;
+	m_previousBlendDestination = GL_ZERO;
+	m_bPreviousBlend = false;
+}
+
+/***********************************************************
+ *  ~DebugViews()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DebugViews::~DebugViews()
+{
+	if (0 != m_countFBO)
+	{
+		glDeleteFramebuffers(1, &m_countFBO);
+		glDeleteTextures(1, &m_countTexture);
+		glDeleteRenderbuffers(1, &m_countDepthRBO);
+		m_countFBO = 0;
+	}
+	if (0 != m_emptyVertexArray)
+	{
+		glDeleteVertexArrays(1, &m_emptyVertexArray);
+		m_emptyVertexArray = 0;
+	}
+	glDeleteProgram(m_objectProgram);
+	glDeleteProgram(m_heatMapProgram);
+	m_objectProgram = m_heatMapProgram = 0;
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method builds the shader programs of the debug views.
+ *  Returns false if either program cannot be built.
+ ***********************************************************/
+bool DebugViews::Initialize()
+{
+	m_objectProgram = LinkProgram(OBJECT_VERTEX_SHADER.c_str(), OBJECT_FRAGMENT_SHADER);
+	m_heatMapProgram = LinkProgram(HEAT_MAP_VERTEX_SHADER, HEAT_MAP_FRAGMENT_SHADER);
+	if ((0 == m_objectProgram) || (0 == m_heatMapProgram))
+	{
+		return false;
+	}
+
+	m_viewProjectionLocation = glGetUniformLocation(m_objectProgram, "viewProjection");
+	m_modelLocation = glGetUniformLocation(m_objectProgram, "model");
+	m_instancedLocation = glGetUniformLocation(m_objectProgram, "bInstanced");
+	m_colorLocation = glGetUniformLocation(m_objectProgram, "debugColor");
+	m_maxOverdrawLocation = glGetUniformLocation(m_heatMapProgram, "maxOverdraw");
+
+	// the counts are always read from texture unit 0
+	const GLuint previousProgram = m_pStateCache->GetProgram();
+	m_pStateCache->UseProgram(m_heatMapProgram);
+	m_pStateCache->SetInt(glGetUniformLocation(m_heatMapProgram, "overdrawCounts"), 0);
+	m_pStateCache->SetFloat(m_maxOverdrawLocation, MAX_OVERDRAW);
+	m_pStateCache->UseProgram(previousProgram);
+
+	// core profiles draw only with a vertex array bound
+	glGenVertexArrays(1, &m_emptyVertexArray);
+	return true;
+}
+
+/***********************************************************
+ *  PrepareCountTarget()
+ *
+ *  This method creates the float overdraw count target with
+ *  its own depth buffer, or resizes it to the passed in size.
+ *  Returns false if the framebuffer is incomplete.
+ ***********************************************************/
+bool DebugViews::PrepareCountTarget(GLsizei width, GLsizei height)
+{
+	if ((0 != m_countFBO) && (width == m_countWidth) && (height == m_countHeight))
+	{
+		return true;
+	}
+
+	if (0 == m_countFBO)
+	{
+		glGenFramebuffers(1, &m_countFBO);
+		glGenTextures(1, &m_countTexture);
+		glGenRenderbuffers(1, &m_countDepthRBO);
+	}
+	m_countWidth = width;
+	m_countHeight = height;
+
+	m_pStateCache->BindTexture(GL_TEXTURE_2D, m_countTexture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, nullptr);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glBindRenderbuffer(GL_RENDERBUFFER, m_countDepthRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_countFBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_countTexture, 0);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_countDepthRBO);
+	const GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_targetFramebuffer);
+
+	if (GL_FRAMEBUFFER_COMPLETE != status)
+	{
+		std::cout << "Could not create overdraw target:" << status << std::endl;
+		return false;
+	}
+	return true;
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method switches to the debug program for the passed
+ *  in view. The overdraw view also clears its count target,
+ *  sized to the passed in target framebuffer, and draws into
+ *  it with additive blending. The state to restore at End()
+ *  is read from the state cache.
+ ***********************************************************/
+void DebugViews::Begin(VIEW view, const glm::mat4& viewProjection, bool bInstanced,
+	GLuint targetFramebuffer, GLsizei targetWidth, GLsizei targetHeight)
+{
+	m_view = view;
+	m_targetFramebuffer = targetFramebuffer;
+	m_previousProgram = m_pStateCache->GetProgram();
+	m_pStateCache->GetBlendFunc(m_previousBlendSource, m_previousBlendDestination);
+	m_bPreviousBlend = m_pStateCache->IsEnabled(GL_BLEND);
+
+	m_pStateCache->UseProgram(m_objectProgram);
+	m_pStateCache->SetMat4(m_viewProjectionLocation, viewProjection);
+	m_pStateCache->SetInt(m_instancedLocation, bInstanced);
+
+	if (VIEW_OVERDRAW == m_view)
+	{
+		if (!PrepareCountTarget(targetWidth, targetHeight))
+		{
+			// show the draw order instead of a broken heat map
+			m_view = VIEW_DRAW_ORDER;
+			return;
+		}
+
+		const GLfloat zero[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		const GLfloat farDepth = 1.0f;
+		glBindFramebuffer(GL_FRAMEBUFFER, m_countFBO);
+		glClearBufferfv(GL_COLOR, 0, zero);
+		glClearBufferfv(GL_DEPTH, 0, &farDepth);
+
+		m_pStateCache->Enable(GL_BLEND);
+		m_pStateCache->BlendFunc(GL_ONE, GL_ONE);
+		m_pStateCache->SetVec4(m_colorLocation, glm::vec4(1.0f));
+	}
+	else
+	{
+		m_pStateCache->Disable(GL_BLEND);
+	}
+}
+
+/***********************************************************
+ *  SetObject()
+ *
+ *  This method sets the model matrix and, in the draw order
+ *  view, the color of the next submission. Neighboring
+ *  submissions alternate in brightness so that they can be
+ *  told apart where the ramp changes slowly.
+ ***********************************************************/
+void DebugViews::SetObject(const glm::mat4& model, int drawOrder, int drawCount)
+{
+	m_pStateCache->SetMat4(m_modelLocation, model);
+
+	if (VIEW_DRAW_ORDER == m_view)
+	{
+		const float position = static_cast<float>(drawOrder) / static_cast<float>(std::max(drawCount - 1, 1));
+		const float brightness = (drawOrder % 2 == 0) ? 1.0f : 0.7f;
+		const glm::vec3 first(0.1f, 0.2f, 1.0f);
+		const glm::vec3 last(1.0f, 0.15f, 0.1f);
+		const glm::vec3 color = (first + (last - first) * position) * brightness;
+		m_pStateCache->SetVec4(m_colorLocation, glm::vec4(color, 1.0f));
+	}
+}
+
+/***********************************************************
+ *  ResolveOverdraw()
+ *
+ *  This method draws the overdraw counts as a heat map over
+ *  the whole framebuffer that was passed to Begin(). The heat
+ *  map writes no depth, and the debug program is current
+ *  again afterwards. The scene keeps texture unit 0 active,
+ *  and the counts stay bound to it, so the caller must
+ *  select its next texture again. Returns false without
+ *  drawing anything unless the overdraw view is active.
+ ***********************************************************/
+bool DebugViews::ResolveOverdraw()
+{
+	if (VIEW_OVERDRAW != m_view)
+	{
+		return false;
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_targetFramebuffer);
+	m_pStateCache->Disable(GL_BLEND);
+	m_pStateCache->Disable(GL_DEPTH_TEST);
+	m_pStateCache->BindTexture(GL_TEXTURE_2D, m_countTexture);
+
+	m_pStateCache->UseProgram(m_heatMapProgram);
+	glBindVertexArray(m_emptyVertexArray);
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+	glBindVertexArray(0);
+	m_pStateCache->UseProgram(m_objectProgram);
+
+	m_pStateCache->Enable(GL_DEPTH_TEST);
+	return true;
+}
+
+/***********************************************************
+ *  End()
+ *
+ *  This method restores the program and blending that were
+ *  current at Begin(), and rebinds the target framebuffer.
+ ***********************************************************/
+void DebugViews::End()
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, m_targetFramebuffer);
+	if (m_bPreviousBlend)
+	{
+		m_pStateCache->Enable(GL_BLEND);
+	}
+	else
+	{
+		m_pStateCache->Disable(GL_BLEND);
+	}
+	m_pStateCache->BlendFunc(m_previousBlendSource, m_previousBlendDestination);
+	m_pStateCache->UseProgram(m_previousProgram);
+}
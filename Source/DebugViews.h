@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+// debugviews.h
+// ============
+// overdraw heat map and draw order views of the scene
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLStateCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  DebugViews
+ *
+ *  This class replaces the shaded scene with a view of where
+ *  its fragment cost goes. Both views draw the scene's own
+ *  geometry, in the scene's draw order and depth mode, with a
+ *  small built-in shader program:
+ *
+ *  - the overdraw view adds one to a float render target for
+ *    every fragment that passes the depth test, i.e. every
+ *    fragment the lighting shader would run for, and shows
+ *    the counts as a heat map (blue = 1 ... red = 8 or more)
+ *  - the draw order view gives every submission a flat color
+ *    from blue (drawn first) to red (drawn last)
+ *
+ *  Program, capability, blend and uniform changes go through
+ *  the scene's state cache, which also supplies the state
+ *  that End() restores.
+ ***********************************************************/
+class DebugViews
+{
+public:
+	// constructor; state changes go through the passed in cache
+	DebugViews(GLStateCache* pStateCache);
+	// destructor
+	~DebugViews();
+
+	// views that can replace the shaded scene
+	enum VIEW
+	{
+		VIEW_SHADED,      // the normal lit scene, no debug view
+		VIEW_OVERDRAW,
+		VIEW_DRAW_ORDER
+	};
+
+	// build the shader programs, returning false if they fail
+	bool Initialize();
+
+	// switch to the debug program for the passed in view; the
+	// overdraw view also redirects drawing into its count target,
+	// sized to the framebuffer the scene is drawn into
+	void Begin(VIEW view, const glm::mat4& viewProjection, bool bInstanced,
+		GLuint targetFramebuffer, GLsizei targetWidth, GLsizei targetHeight);
+	// set the values of the next submission; the model matrix
+	// is ignored when the instances carry their own
+	void SetObject(const glm::mat4& model, int drawOrder, int drawCount);
+	// draw the overdraw counts as a heat map into the target that
+	// was passed to Begin(), leaving the counts bound to texture
+	// unit 0; false (and nothing drawn) for other views
+	bool ResolveOverdraw();
+	// restore the program and blending of Begin() and rebind the
+	// target framebuffer
+	void End();
+
+private:
+	// state cache all state changes go through
+	GLStateCache* m_pStateCache;
+	// program drawing the scene geometry and its uniforms
+	GLuint m_objectProgram;
+	GLint m_viewProjectionLocation;
+	GLint m_modelLocation;
+	GLint m_instancedLocation;
+	GLint m_colorLocation;
+	// program drawing the heat map over the whole target
+	GLuint m_heatMapProgram;
+	GLint m_maxOverdrawLocation;
+	// empty vertex array for the generated full screen triangle
+	GLuint m_emptyVertexArray;
+
+	// overdraw count target, sized to the viewport
+	GLuint m_countFBO;
+	GLuint m_countTexture;
+	GLuint m_countDepthRBO;
+	GLsizei m_countWidth;
+	GLsizei m_countHeight;
+
+	// view and framebuffer of the current Begin() ... End()
+	VIEW m_view;
+	GLuint m_targetFramebuffer;
+	// state replaced by Begin()
+	GLuint m_previousProgram;
+	GLenum m_previousBlendSource;
+	GLenum m_previousBlendDestination;
+	bool m_bPreviousBlend;
+
+	// create or resize the count target to the passed in size
+	bool PrepareCountTarget(GLsizei width, GLsizei height);
+};
@@ -0,0 +1,227 @@
+///////////////////////////////////////////////////////////////////////////////
+// framebenchmark.cpp
+// ============
+// collect per-frame timings and counters and report them as JSON
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameBenchmark.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// declaration of global variables and constants
+namespace
+{
+	/**
+	 * @brief Returns the value at the given percentile of a sorted list
+	 * @param sorted Values sorted in ascending order (must not be empty)
+	 * @param percentile Percentile in the range [0, 100]
+	 * @return The nearest-rank percentile value
+	 */
+	double Percentile(const std::vector<double>& sorted, double percentile)
+	{
+		size_t rank = static_cast<size_t>((percentile / 100.0) * (sorted.size() - 1) + 0.5);
+		return sorted[std::min(rank, sorted.size() - 1)];
+	}
+}
+
+/***********************************************************
+ *  FrameBenchmark()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameBenchmark::FrameBenchmark(int frameCount)
+{
+	m_samples.reserve(frameCount > 0 ? frameCount : 0);
+	m_prepareSceneMs = 0.0;
+	m_firstFrameMs = 0.0;
+	m_bDepthPrepass = false;
+	m_sceneFormat = "built-in";
+	m_sceneLoadMs = 0.0;
+}
+
+/***********************************************************
+ *  SetStartupTimes()
+ *
+ *  Records how long the scene took to prepare and how long
+ *  after launch the first frame was presented.
+ ***********************************************************/
+void FrameBenchmark::SetStartupTimes(double prepareSceneMs, double firstFrameMs)
+{
+	m_prepareSceneMs = prepareSceneMs;
+	m_firstFrameMs = firstFrameMs;
+}
+
+/***********************************************************
+ *  SetDepthPrepass()
+ *
+ *  Records whether the measured frames were rendered with a
+ *  depth pre-pass, so that reports of both modes can be told
+ *  apart.
+ ***********************************************************/
+void FrameBenchmark::SetDepthPrepass(bool bDepthPrepass)
+{
+	m_bDepthPrepass = bDepthPrepass;
+}
+
+/***********************************************************
+ *  SetSceneLoad()
+ *
+ *  Records whether the scene was built in or loaded from a
+ *  text or cooked binary file, and how long loading took, so
+ *  that reports of each format can be compared.
+ ***********************************************************/
+void FrameBenchmark::SetSceneLoad(const char* format, double loadMs)
+{
+	m_sceneFormat = format;
+	m_sceneLoadMs = loadMs;
+}
+
+/***********************************************************
+ *  SetGpuTimes()
+ *
+ *  Records the average GPU time in milliseconds of named
+ *  parts of the frame, reported as the gpu_ms object.
+ ***********************************************************/
+void FrameBenchmark::SetGpuTimes(const std::vector<std::string>& names, const std::vector<double>& averageMs)
+{
+	m_gpuTimeNames = names;
+	m_gpuTimesMs = averageMs;
+}
+
+/***********************************************************
+ *  AddSample()
+ *
+ *  Records the timings and counters of one rendered frame.
+ ***********************************************************/
+void FrameBenchmark::AddSample(const FRAME_SAMPLE& sample)
+{
+	m_samples.push_back(sample);
+}
+
+/***********************************************************
+ *  GetSampleCount()
+ *
+ *  Returns the number of frames recorded so far.
+ ***********************************************************/
+int FrameBenchmark::GetSampleCount() const
+{
+	return static_cast<int>(m_samples.size());
+}
+
+/***********************************************************
+ *  FormatTiming()
+ *
+ *  Builds the {"p50","p95","p99","max"} JSON object for one
+ *  of the millisecond timing fields of the samples.
+ ***********************************************************/
+std::string FrameBenchmark::FormatTiming(double FRAME_SAMPLE::* field) const
+{
+	std::vector<double> values;
+	values.reserve(m_samples.size());
+	for (const FRAME_SAMPLE& sample : m_samples)
+	{
+		values.push_back(sample.*field);
+	}
+	std::sort(values.begin(), values.end());
+
+	std::ostringstream json;
+	json << "{\"p50\": " << Percentile(values, 50.0)
+		<< ", \"p95\": " << Percentile(values, 95.0)
+		<< ", \"p99\": " << Percentile(values, 99.0)
+		<< ", \"max\": " << values.back() << "}";
+	return json.str();
+}
+
+/***********************************************************
+ *  FormatCounter()
+ *
+ *  Builds the {"avg","max"} JSON object for one of the
+ *  per-frame counter fields of the samples.
+ ***********************************************************/
+std::string FrameBenchmark::FormatCounter(int FRAME_SAMPLE::* field) const
+{
+	double total = 0.0;
+	int maxValue = 0;
+	for (const FRAME_SAMPLE& sample : m_samples)
+	{
+		total += sample.*field;
+		maxValue = std::max(maxValue, sample.*field);
+	}
+
+	std::ostringstream json;
+	json << "{\"avg\": " << (total / m_samples.size())
+		<< ", \"max\": " << maxValue << "}";
+	return json.str();
+}
+
+/***********************************************************
+ *  WriteReport()
+ *
+ *  Writes the JSON summary of all recorded frames to the
+ *  given file, or to standard output if no file is given.
+ ***********************************************************/
+bool FrameBenchmark::WriteReport(const char* filename) const
+{
+	if (m_samples.empty())
+	{
+		std::cout << "No benchmark frames were recorded" << std::endl;
+		return false;
+	}
+
+	std::ostringstream json;
+	json << "{\n"
+		<< "  \"frames\": " << m_samples.size() << ",\n"
+		<< "  \"scene_format\": \"" << m_sceneFormat << "\",\n"
+		<< "  \"scene_load_ms\": " << m_sceneLoadMs << ",\n"
+		<< "  \"prepare_scene_ms\": " << m_prepareSceneMs << ",\n"
+		<< "  \"time_to_first_frame_ms\": " << m_firstFrameMs << ",\n"
+		<< "  \"depth_prepass\": " << (m_bDepthPrepass ? "true" : "false") << ",\n"
+		<< "  \"cpu_prepare_view_ms\": " << FormatTiming(&FRAME_SAMPLE::prepareViewMs) << ",\n"
+		<< "  \"cpu_render_scene_ms\": " << FormatTiming(&FRAME_SAMPLE::renderSceneMs) << ",\n"
+		<< "  \"gpu_swap_ms\": " << FormatTiming(&FRAME_SAMPLE::swapMs) << ",\n"
+		<< "  \"frame_ms\": " << FormatTiming(&FRAME_SAMPLE::frameMs) << ",\n"
+		<< "  \"draw_calls\": " << FormatCounter(&FRAME_SAMPLE::drawCalls) << ",\n"
+		<< "  \"uniform_uploads\": " << FormatCounter(&FRAME_SAMPLE::uniformUploads) << ",\n"
+		<< "  \"filtered_uniform_uploads\": " << FormatCounter(&FRAME_SAMPLE::filteredUniforms) << ",\n"
+		<< "  \"state_changes\": " << FormatCounter(&FRAME_SAMPLE::stateChanges) << ",\n"
+		<< "  \"filtered_state_changes\": " << FormatCounter(&FRAME_SAMPLE::filteredStateChanges) << ",\n"
+		<< "  \"light_uploads\": " << FormatCounter(&FRAME_SAMPLE::lightUploads) << ",\n"
+		<< "  \"transform_updates\": " << FormatCounter(&FRAME_SAMPLE::transformUpdates) << ",\n"
+		<< "  \"visible_objects\": " << FormatCounter(&FRAME_SAMPLE::visibleObjects) << ",\n"
+		<< "  \"culled_objects\": " << FormatCounter(&FRAME_SAMPLE::culledObjects) << ",\n"
+		<< "  \"occluded_objects\": " << FormatCounter(&FRAME_SAMPLE::occludedObjects) << ",\n"
+		<< "  \"occlusion_queries\": " << FormatCounter(&FRAME_SAMPLE::occlusionQueries) << ",\n"
+		<< "  \"reduced_lod_objects\": " << FormatCounter(&FRAME_SAMPLE::reducedLodObjects) << ",\n"
+		<< "  \"shaded_fragments\": " << FormatCounter(&FRAME_SAMPLE::shadedFragments) << ",\n"
+		<< "  \"shaded_fragments_per_pixel\": " << FormatTiming(&FRAME_SAMPLE::fragmentsPerPixel);
+	if (!m_gpuTimeNames.empty())
+	{
+		json << ",\n  \"gpu_ms\": {";
+		for (size_t i = 0; i < m_gpuTimeNames.size(); i++)
+		{
+			json << ((i > 0) ? ", " : "") << "\"" << m_gpuTimeNames[i] << "\": " << m_gpuTimesMs[i];
+		}
+		json << "}";
+	}
+	json << "\n}\n";
+
+	if (nullptr == filename)
+	{
+		std::cout << json.str();
+		return true;
+	}
+
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not write benchmark report:" << filename << std::endl;
+		return false;
+	}
+	file << json.str();
+	std::cout << "Wrote benchmark report:" << filename << std::endl;
+	return true;
+}
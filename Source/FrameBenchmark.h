@@ -0,0 +1,83 @@
+///////////////////////////////////////////////////////////////////////////////
+// framebenchmark.h
+// ============
+// collect per-frame timings and counters and report them as JSON
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  FrameBenchmark
+ *
+ *  This class collects one sample per rendered frame and
+ *  summarizes the run as percentiles in a JSON report.
+ ***********************************************************/
+class FrameBenchmark
+{
+public:
+	// constructor
+	FrameBenchmark(int frameCount);
+
+	// timings and counters captured for a single frame
+	struct FRAME_SAMPLE
+	{
+		double prepareViewMs;   // CPU time in ViewManager::PrepareSceneView()
+		double renderSceneMs;   // CPU time in SceneManager::RenderScene()
+		double swapMs;          // GPU completion and buffer swap time
+		double frameMs;         // total time of the loop iteration
+		int drawCalls;          // mesh draws submitted
+		int uniformUploads;     // uniform values written
+		int filteredUniforms;   // uniform writes dropped as unchanged
+		int stateChanges;       // GL state calls issued through the state cache
+		int filteredStateChanges; // GL state calls dropped as unchanged
+		int lightUploads;       // light set uploads
+		int transformUpdates;   // model matrices rebuilt
+		int visibleObjects;     // objects inside the view frustum
+		int culledObjects;      // objects skipped by frustum culling
+		int occludedObjects;    // objects in view skipped by occlusion queries
+		int occlusionQueries;   // bounding box queries issued
+		int reducedLodObjects;  // visible objects drawn below full detail
+		int shadedFragments;    // samples shaded by the color pass
+		double fragmentsPerPixel; // shaded samples per viewport pixel
+	};
+
+	// record the startup cost reported with the frame timings
+	void SetStartupTimes(double prepareSceneMs, double firstFrameMs);
+	// record whether the frames were rendered with a depth pre-pass
+	void SetDepthPrepass(bool bDepthPrepass);
+	// record where the scene came from and how long it took to load
+	void SetSceneLoad(const char* format, double loadMs);
+	// record the average GPU time of named parts of the frame
+	void SetGpuTimes(const std::vector<std::string>& names, const std::vector<double>& averageMs);
+	// add the sample for the frame that was just rendered
+	void AddSample(const FRAME_SAMPLE& sample);
+	// number of samples recorded so far
+	int GetSampleCount() const;
+	// write the summary report (to stdout when filename is null)
+	bool WriteReport(const char* filename) const;
+
+private:
+	// samples recorded for the run
+	std::vector<FRAME_SAMPLE> m_samples;
+	// CPU time in SceneManager::PrepareScene()
+	double m_prepareSceneMs;
+	// time from launch until the first frame was presented
+	double m_firstFrameMs;
+	// true if the frames were rendered with a depth pre-pass
+	bool m_bDepthPrepass;
+	// scene source ("built-in", "text" or "binary") and its load time
+	std::string m_sceneFormat;
+	double m_sceneLoadMs;
+	// average GPU time of named parts of the frame (empty if not timed)
+	std::vector<std::string> m_gpuTimeNames;
+	std::vector<double> m_gpuTimesMs;
+
+	// format p50/p95/p99/max of one timing or ratio field as a JSON object
+	std::string FormatTiming(double FRAME_SAMPLE::* field) const;
+	// format avg/max of one counter field as a JSON object
+	std::string FormatCounter(int FRAME_SAMPLE::* field) const;
+};
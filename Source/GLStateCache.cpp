@@ -0,0 +1,384 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstatecache.cpp
+// ============
+// shadow copy of GL state that drops redundant state and uniform writes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GLStateCache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <cstring>
+
+/***********************************************************
+ *  GLStateCache()
+ *
+ *  The constructor for the class. Every value starts unknown.
+ ***********************************************************/
+GLStateCache::GLStateCache()
+{
+	m_depthFunction = 0;
+	m_depthMask = -1;
+	m_colorMask = -1;
+	m_blendSource = GL_ONE;
+	m_blendDestination = GL_ZERO;
+	m_bBlendFuncKnown = false;
+	m_programID = 0;
+	m_bProgramKnown = false;
+	// uniforms written before any UseProgram() are kept under program 0
+	m_pUniforms = &m_programUniforms[0];
+	m_stats = STATS();
+}
+
+/***********************************************************
+ *  SetCapability()
+ *
+ *  This method enables or disables the passed in capability
+ *  unless it is already in that state.
+ ***********************************************************/
+void GLStateCache::SetCapability(GLenum capability, bool bEnabled)
+{
+	for (CAPABILITY& entry : m_capabilities)
+	{
+		if (entry.capability == capability)
+		{
+			if (entry.bEnabled == bEnabled)
+			{
+				m_stats.filteredStateChanges++;
+				return;
+			}
+			entry.bEnabled = bEnabled;
+			bEnabled ? glEnable(capability) : glDisable(capability);
+			m_stats.issuedStateChanges++;
+			return;
+		}
+	}
+
+	CAPABILITY entry;
+	entry.capability = capability;
+	entry.bEnabled = bEnabled;
+	m_capabilities.push_back(entry);
+	bEnabled ? glEnable(capability) : glDisable(capability);
+	m_stats.issuedStateChanges++;
+}
+
+/***********************************************************
+ *  Enable()
+ *
+ *  This method enables the passed in capability.
+ ***********************************************************/
+void GLStateCache::Enable(GLenum capability)
+{
+	SetCapability(capability, true);
+}
+
+/***********************************************************
+ *  Disable()
+ *
+ *  This method disables the passed in capability.
+ ***********************************************************/
+void GLStateCache::Disable(GLenum capability)
+{
+	SetCapability(capability, false);
+}
+
+/***********************************************************
+ *  DepthFunc()
+ *
+ *  This method sets the depth comparison function.
+ ***********************************************************/
+void GLStateCache::DepthFunc(GLenum function)
+{
+	if (function == m_depthFunction)
+	{
+		m_stats.filteredStateChanges++;
+		return;
+	}
+	glDepthFunc(function);
+	m_depthFunction = function;
+	m_stats.issuedStateChanges++;
+}
+
+/***********************************************************
+ *  DepthMask()
+ *
+ *  This method switches depth writes on or off.
+ ***********************************************************/
+void GLStateCache::DepthMask(bool bWrite)
+{
+	if (static_cast<int>(bWrite) == m_depthMask)
+	{
+		m_stats.filteredStateChanges++;
+		return;
+	}
+	glDepthMask(bWrite ? GL_TRUE : GL_FALSE);
+	m_depthMask = bWrite;
+	m_stats.issuedStateChanges++;
+}
+
+/***********************************************************
+ *  ColorMask()
+ *
+ *  This method switches writes to all color channels on or
+ *  off.
+ ***********************************************************/
+void GLStateCache::ColorMask(bool bWrite)
+{
+	if (static_cast<int>(bWrite) == m_colorMask)
+	{
+		m_stats.filteredStateChanges++;
+		return;
+	}
+	const GLboolean write = bWrite ? GL_TRUE : GL_FALSE;
+	glColorMask(write, write, write, write);
+	m_colorMask = bWrite;
+	m_stats.issuedStateChanges++;
+}
+
+/***********************************************************
+ *  BlendFunc()
+ *
+ *  This method sets the source and destination blend factors
+ *  of the color and alpha channels.
+ ***********************************************************/
+void GLStateCache::BlendFunc(GLenum source, GLenum destination)
+{
+	if (m_bBlendFuncKnown && (source == m_blendSource) && (destination == m_blendDestination))
+	{
+		m_stats.filteredStateChanges++;
+		return;
+	}
+	glBlendFunc(source, destination);
+	m_blendSource = source;
+	m_blendDestination = destination;
+	m_bBlendFuncKnown = true;
+	m_stats.issuedStateChanges++;
+}
+
+/***********************************************************
+ *  UseProgram()
+ *
+ *  This method makes the passed in program current. Uniform
+ *  values are remembered per program, so switching back to a
+ *  program still filters its unchanged uniforms.
+ ***********************************************************/
+void GLStateCache::UseProgram(GLuint programID)
+{
+	if (m_bProgramKnown && (programID == m_programID))
+	{
+		m_stats.filteredStateChanges++;
+		return;
+	}
+	glUseProgram(programID);
+	m_programID = programID;
+	m_bProgramKnown = true;
+	m_pUniforms = &m_programUniforms[programID];
+	m_stats.issuedStateChanges++;
+}
+
+/***********************************************************
+ *  BindTexture()
+ *
+ *  This method binds the passed in texture to the active
+ *  texture unit. Texture creation and streaming rebind the
+ *  unit without the cache, so the bind is never filtered;
+ *  callers skip selecting a texture that is already selected.
+ ***********************************************************/
+void GLStateCache::BindTexture(GLenum target, GLuint textureID)
+{
+	glBindTexture(target, textureID);
+	m_stats.issuedStateChanges++;
+}
+
+/***********************************************************
+ *  UpdateUniform()
+ *
+ *  This method compares the passed in value with the last one
+ *  written to the location of the current program. A changed
+ *  value is stored and counted as issued, and true returned
+ *  so the caller sends it to OpenGL.
+ ***********************************************************/
+bool GLStateCache::UpdateUniform(GLint location, const void* value, int size)
+{
+	if (location >= static_cast<GLint>(m_pUniforms->size()))
+	{
+		UNIFORM_VALUE unknown;
+		unknown.size = 0;
+		m_pUniforms->resize(static_cast<size_t>(location) + 1, unknown);
+	}
+
+	UNIFORM_VALUE& cached = (*m_pUniforms)[location];
+	const size_t bytes = sizeof(GLfloat) * size;
+	if ((cached.size == size) && (memcmp(cached.values, value, bytes) == 0))
+	{
+		m_stats.filteredUniforms++;
+		return false;
+	}
+
+	memcpy(cached.values, value, bytes);
+	cached.size = size;
+	m_stats.issuedUniforms++;
+	return true;
+}
+
+/***********************************************************
+ *  SetInt()
+ *
+ *  This method writes an int, bool or sampler uniform. Writes
+ *  to location -1 are ignored, as OpenGL ignores them.
+ ***********************************************************/
+bool GLStateCache::SetInt(GLint location, GLint value)
+{
+	static_assert(sizeof(GLint) == sizeof(GLfloat), "an int uniform is stored in one float slot");
+	if ((location < 0) || !UpdateUniform(location, &value, 1))
+	{
+		return false;
+	}
+	glUniform1i(location, value);
+	return true;
+}
+
+/***********************************************************
+ *  SetFloat()
+ *
+ *  This method writes a float uniform.
+ ***********************************************************/
+bool GLStateCache::SetFloat(GLint location, GLfloat value)
+{
+	if ((location < 0) || !UpdateUniform(location, &value, 1))
+	{
+		return false;
+	}
+	glUniform1f(location, value);
+	return true;
+}
+
+/***********************************************************
+ *  SetVec2()
+ *
+ *  This method writes a vec2 uniform.
+ ***********************************************************/
+bool GLStateCache::SetVec2(GLint location, const glm::vec2& value)
+{
+	if ((location < 0) || !UpdateUniform(location, glm::value_ptr(value), 2))
+	{
+		return false;
+	}
+	glUniform2fv(location, 1, glm::value_ptr(value));
+	return true;
+}
+
+/***********************************************************
+ *  SetVec3()
+ *
+ *  This method writes a vec3 uniform.
+ ***********************************************************/
+bool GLStateCache::SetVec3(GLint location, const glm::vec3& value)
+{
+	if ((location < 0) || !UpdateUniform(location, glm::value_ptr(value), 3))
+	{
+		return false;
+	}
+	glUniform3fv(location, 1, glm::value_ptr(value));
+	return true;
+}
+
+/***********************************************************
+ *  SetVec4()
+ *
+ *  This method writes a vec4 uniform.
+ ***********************************************************/
+bool GLStateCache::SetVec4(GLint location, const glm::vec4& value)
+{
+	if ((location < 0) || !UpdateUniform(location, glm::value_ptr(value), 4))
+	{
+		return false;
+	}
+	glUniform4fv(location, 1, glm::value_ptr(value));
+	return true;
+}
+
+/***********************************************************
+ *  SetMat3()
+ *
+ *  This method writes a mat3 uniform.
+ ***********************************************************/
+bool GLStateCache::SetMat3(GLint location, const glm::mat3& value)
+{
+	if ((location < 0) || !UpdateUniform(location, glm::value_ptr(value), 9))
+	{
+		return false;
+	}
+	glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	return true;
+}
+
+/***********************************************************
+ *  SetMat4()
+ *
+ *  This method writes a mat4 uniform.
+ ***********************************************************/
+bool GLStateCache::SetMat4(GLint location, const glm::mat4& value)
+{
+	if ((location < 0) || !UpdateUniform(location, glm::value_ptr(value), 16))
+	{
+		return false;
+	}
+	glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value));
+	return true;
+}
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method returns whether the passed in capability was
+ *  last enabled through the cache; capabilities never written
+ *  read as disabled, except GL_DITHER and GL_MULTISAMPLE,
+ *  which OpenGL starts with enabled.
+ ***********************************************************/
+bool GLStateCache::IsEnabled(GLenum capability) const
+{
+	for (const CAPABILITY& entry : m_capabilities)
+	{
+		if (entry.capability == capability)
+		{
+			return entry.bEnabled;
+		}
+	}
+	return (GL_DITHER == capability) || (GL_MULTISAMPLE == capability);
+}
+
+/***********************************************************
+ *  GetBlendFunc()
+ *
+ *  This method returns the blend factors last set through the
+ *  cache, or GL_ONE and GL_ZERO if none were set.
+ ***********************************************************/
+void GLStateCache::GetBlendFunc(GLenum& source, GLenum& destination) const
+{
+	source = m_blendSource;
+	destination = m_blendDestination;
+}
+
+/***********************************************************
+ *  GetProgram()
+ *
+ *  This method returns the program last made current through
+ *  the cache, or 0 if none was.
+ ***********************************************************/
+GLuint GLStateCache::GetProgram() const
+{
+	return m_programID;
+}
+
+/***********************************************************
+ *  GetStats()
+ *
+ *  This method returns the issued and filtered calls since
+ *  the cache was created.
+ ***********************************************************/
+const GLStateCache::STATS& GLStateCache::GetStats() const
+{
+	return m_stats;
+}
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+// glstatecache.h
+// ============
+// shadow copy of GL state that drops redundant state and uniform writes
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  GLStateCache
+ *
+ *  This class sits between the managers and OpenGL. It keeps
+ *  the last value written for each capability, the depth and
+ *  color masks, the depth function, the current program and
+ *  each uniform of every program, and only calls OpenGL when
+ *  a write changes one of them. Each write is counted as
+ *  either issued or filtered.
+ *
+ *  A value is unknown until it is first written through the
+ *  cache, so that first write is always issued. Until then
+ *  the getters return OpenGL's initial value. All code that
+ *  changes this state, including DebugViews and
+ *  OcclusionQueries, goes through the cache; code that saves
+ *  state to restore it later reads it from the cache rather
+ *  than querying OpenGL.
+ ***********************************************************/
+class GLStateCache
+{
+public:
+	// calls issued to OpenGL and calls dropped as redundant
+	struct STATS
+	{
+		int issuedStateChanges;
+		int filteredStateChanges;
+		int issuedUniforms;
+		int filteredUniforms;
+	};
+
+	// constructor
+	GLStateCache();
+
+	// glEnable() / glDisable()
+	void Enable(GLenum capability);
+	void Disable(GLenum capability);
+	// glDepthFunc(), glDepthMask() and glColorMask() for all channels
+	void DepthFunc(GLenum function);
+	void DepthMask(bool bWrite);
+	void ColorMask(bool bWrite);
+	// glBlendFunc() for color and alpha
+	void BlendFunc(GLenum source, GLenum destination);
+	// glUseProgram(); later uniform writes go to this program
+	void UseProgram(GLuint programID);
+	// glBindTexture() on the active unit, always issued because
+	// texture uploads change the binding behind the cache
+	void BindTexture(GLenum target, GLuint textureID);
+
+	// write a uniform of the current program, returning true if
+	// the value changed and was sent to OpenGL
+	bool SetInt(GLint location, GLint value);
+	bool SetFloat(GLint location, GLfloat value);
+	bool SetVec2(GLint location, const glm::vec2& value);
+	bool SetVec3(GLint location, const glm::vec3& value);
+	bool SetVec4(GLint location, const glm::vec4& value);
+	bool SetMat3(GLint location, const glm::mat3& value);
+	bool SetMat4(GLint location, const glm::mat4& value);
+
+	// last state written through the cache
+	bool IsEnabled(GLenum capability) const;
+	void GetBlendFunc(GLenum& source, GLenum& destination) const;
+	GLuint GetProgram() const;
+
+	// totals since the cache was created
+	const STATS& GetStats() const;
+
+private:
+	// last value of one uniform location
+	struct UNIFORM_VALUE
+	{
+		int size;          // floats used in values (0 = unknown)
+		GLfloat values[16];
+	};
+
+	// last state of one capability
+	struct CAPABILITY
+	{
+		GLenum capability;
+		bool bEnabled;
+	};
+
+	std::vector<CAPABILITY> m_capabilities;
+	GLenum m_depthFunction;  // 0 = unknown
+	int m_depthMask;         // -1 = unknown
+	int m_colorMask;         // -1 = unknown
+	GLenum m_blendSource;
+	GLenum m_blendDestination;
+	bool m_bBlendFuncKnown;
+	GLuint m_programID;
+	bool m_bProgramKnown;
+
+	// uniform values of every program used, indexed by location
+	std::unordered_map<GLuint, std::vector<UNIFORM_VALUE>> m_programUniforms;
+	// uniform values of the current program
+	std::vector<UNIFORM_VALUE>* m_pUniforms;
+
+	STATS m_stats;
+
+	// enable or disable a capability if it is not already
+	void SetCapability(GLenum capability, bool bEnabled);
+	// store the value and return true if it differs from the last
+	// one written to the location, counting the write either way
+	bool UpdateUniform(GLint location, const void* value, int size);
+};
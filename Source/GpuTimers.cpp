@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+// gputimers.cpp
+// ============
+// time spans of each frame's GPU work with non-blocking timestamp queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GpuTimers.h"
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables and constants
+namespace
+{
+	// frames the rolling averages cover
+	const int HISTORY_FRAMES = 60;
+}
+
+/***********************************************************
+ *  GpuTimers()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GpuTimers::GpuTimers(int scopeCount)
+{
+	for (FRAME_QUERIES& frame : m_frames)
+	{
+		frame.queryCount = 0;
+		frame.bPending = false;
+	}
+	m_currentFrame = -1;
+	m_nextFrame = 0;
+	m_currentScope = -1;
+	m_scopeCount = scopeCount;
+	m_history.assign(static_cast<size_t>(scopeCount) * HISTORY_FRAMES, 0.0);
+	m_historyCount = 0;
+	m_historyIndex = 0;
+	m_frameCount = 0;
+}
+
+/***********************************************************
+ *  ~GpuTimers()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GpuTimers::~GpuTimers()
+{
+	for (FRAME_QUERIES& frame : m_frames)
+	{
+		if (!frame.queries.empty())
+		{
+			glDeleteQueries(static_cast<GLsizei>(frame.queries.size()), frame.queries.data());
+		}
+		frame.queries.clear();
+	}
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method returns true if the current context supports
+ *  GL_TIMESTAMP queries (OpenGL 3.3).
+ ***********************************************************/
+bool GpuTimers::IsSupported()
+{
+	return (GLEW_VERSION_3_3 || GLEW_ARB_timer_query);
+}
+
+/***********************************************************
+ *  OpenLog()
+ *
+ *  This method creates the CSV file that every frame read is
+ *  appended to, with a frame column, one column per scope and
+ *  a total. Returns false if the file cannot be written.
+ ***********************************************************/
+bool GpuTimers::OpenLog(const std::string& filename, const std::vector<std::string>& scopeNames)
+{
+	m_log.open(filename);
+	if (!m_log)
+	{
+		std::cout << "Could not write GPU timing log:" << filename << std::endl;
+		return false;
+	}
+
+	m_log << "frame";
+	for (const std::string& name : scopeNames)
+	{
+		m_log << "," << name << "_ms";
+	}
+	m_log << ",total_ms\n";
+	return true;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method reads the frames the GPU has finished and
+ *  claims the next ring slot for this frame. If that slot is
+ *  still waiting for the GPU, this frame is not timed.
+ ***********************************************************/
+void GpuTimers::BeginFrame()
+{
+	CollectFrames();
+
+	m_currentScope = -1;
+	if (m_frames[m_nextFrame].bPending)
+	{
+		m_currentFrame = -1;
+		return;
+	}
+
+	m_currentFrame = m_nextFrame;
+	m_nextFrame = (m_nextFrame + 1) % FRAME_LATENCY;
+	m_frames[m_currentFrame].queryCount = 0;
+}
+
+/***********************************************************
+ *  AddTimestamp()
+ *
+ *  This method records a timestamp in the current frame that
+ *  starts the passed in scope, or ends the frame for -1.
+ ***********************************************************/
+void GpuTimers::AddTimestamp(int scope)
+{
+	FRAME_QUERIES& frame = m_frames[m_currentFrame];
+	if (frame.queryCount == static_cast<int>(frame.queries.size()))
+	{
+		GLuint query = 0;
+		glGenQueries(1, &query);
+		frame.queries.push_back(query);
+		frame.scopes.push_back(-1);
+	}
+
+	glQueryCounter(frame.queries[frame.queryCount], GL_TIMESTAMP);
+	frame.scopes[frame.queryCount] = scope;
+	frame.queryCount++;
+}
+
+/***********************************************************
+ *  Mark()
+ *
+ *  This method starts the passed in scope. Marks that repeat
+ *  the current scope are ignored.
+ ***********************************************************/
+void GpuTimers::Mark(int scope)
+{
+	if ((m_currentFrame < 0) || (scope == m_currentScope) || (scope < 0) || (scope >= m_scopeCount))
+	{
+		return;
+	}
+
+	AddTimestamp(scope);
+	m_currentScope = scope;
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method ends the last scope of the frame and leaves
+ *  the frame's queries for a later BeginFrame() to read.
+ ***********************************************************/
+void GpuTimers::EndFrame()
+{
+	if (m_currentFrame < 0)
+	{
+		return;
+	}
+
+	FRAME_QUERIES& frame = m_frames[m_currentFrame];
+	if (frame.queryCount > 0)
+	{
+		AddTimestamp(-1);
+		frame.bPending = true;
+	}
+	m_currentFrame = -1;
+	m_currentScope = -1;
+}
+
+/***********************************************************
+ *  CollectFrames()
+ *
+ *  This method reads the pending frames, oldest first, whose
+ *  final timestamp is available. The GPU finishes a frame's
+ *  timestamps in order, so the others are then available too.
+ *  Each frame read adds its scope times to the history and
+ *  the log.
+ ***********************************************************/
+void GpuTimers::CollectFrames()
+{
+	for (int i = 0; i < FRAME_LATENCY; i++)
+	{
+		FRAME_QUERIES& frame = m_frames[(m_nextFrame + i) % FRAME_LATENCY];
+		if (!frame.bPending)
+		{
+			continue;
+		}
+
+		GLint bAvailable = GL_FALSE;
+		glGetQueryObjectiv(frame.queries[frame.queryCount - 1], GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		if (GL_FALSE == bAvailable)
+		{
+			// later frames cannot have finished either
+			break;
+		}
+
+		double* scopeMs = &m_history[static_cast<size_t>(m_historyIndex) * m_scopeCount];
+		std::fill(scopeMs, scopeMs + m_scopeCount, 0.0);
+
+		GLuint64 previous = 0;
+		glGetQueryObjectui64v(frame.queries[0], GL_QUERY_RESULT, &previous);
+		double totalMs = 0.0;
+		for (int q = 1; q < frame.queryCount; q++)
+		{
+			GLuint64 timestamp = 0;
+			glGetQueryObjectui64v(frame.queries[q], GL_QUERY_RESULT, &timestamp);
+			const double elapsedMs = static_cast<double>(timestamp - previous) / 1.0e6;
+			scopeMs[frame.scopes[q - 1]] += elapsedMs;
+			totalMs += elapsedMs;
+			previous = timestamp;
+		}
+		frame.bPending = false;
+
+		m_historyIndex = (m_historyIndex + 1) % HISTORY_FRAMES;
+		m_historyCount = std::min(m_historyCount + 1, HISTORY_FRAMES);
+		m_frameCount++;
+
+		if (m_log.is_open())
+		{
+			m_log << m_frameCount;
+			for (int scope = 0; scope < m_scopeCount; scope++)
+			{
+				m_log << "," << scopeMs[scope];
+			}
+			m_log << "," << totalMs << "\n";
+		}
+	}
+}
+
+/***********************************************************
+ *  GetAverageMs()
+ *
+ *  This method returns the GPU time of the passed in scope
+ *  averaged over the last frames read, or 0 before any frame
+ *  has been read.
+ ***********************************************************/
+double GpuTimers::GetAverageMs(int scope) const
+{
+	if ((m_historyCount == 0) || (scope < 0) || (scope >= m_scopeCount))
+	{
+		return 0.0;
+	}
+
+	double total = 0.0;
+	for (int i = 0; i < m_historyCount; i++)
+	{
+		total += m_history[static_cast<size_t>(i) * m_scopeCount + scope];
+	}
+	return total / m_historyCount;
+}
+
+/***********************************************************
+ *  GetFrameCount()
+ *
+ *  This method returns the number of frames read so far.
+ ***********************************************************/
+int GpuTimers::GetFrameCount() const
+{
+	return m_frameCount;
+}
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// gputimers.h
+// ============
+// time spans of each frame's GPU work with non-blocking timestamp queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  GpuTimers
+ *
+ *  This class measures how long the GPU spends on named
+ *  scopes of each frame. Mark() records a GL_TIMESTAMP query
+ *  where a scope starts, and the time until the next mark is
+ *  added to that scope, so a scope may be entered any number
+ *  of times per frame. The queries of each frame come from a
+ *  ring of FRAME_LATENCY frames, and a frame is read only once
+ *  the GPU reports its last timestamp available, typically
+ *  two or three frames later, so the CPU never waits. If the
+ *  GPU falls further behind, frames are skipped rather than
+ *  waited for.
+ *
+ *  Each scope keeps a rolling average over the last frames
+ *  read, and every frame read can be appended to a CSV log.
+ ***********************************************************/
+class GpuTimers
+{
+public:
+	// constructor
+	explicit GpuTimers(int scopeCount);
+	// destructor
+	~GpuTimers();
+
+	// true if the context has timestamp queries
+	static bool IsSupported();
+
+	// append a row per frame read to a CSV file with the passed in
+	// scope names as columns
+	bool OpenLog(const std::string& filename, const std::vector<std::string>& scopeNames);
+
+	// read finished frames and start marking a new one
+	void BeginFrame();
+	// start the passed in scope, ending the previous one
+	void Mark(int scope);
+	// end the last scope of the frame
+	void EndFrame();
+
+	// rolling average GPU time of a scope in milliseconds
+	double GetAverageMs(int scope) const;
+	// number of frames measured so far
+	int GetFrameCount() const;
+
+private:
+	// frames of queries in flight before one is reused
+	static constexpr int FRAME_LATENCY = 4;
+
+	// timestamp queries of one frame and the scope each starts
+	struct FRAME_QUERIES
+	{
+		std::vector<GLuint> queries;
+		std::vector<int> scopes;     // scope started by each query (-1 = end)
+		int queryCount;              // queries used this frame
+		bool bPending;               // issued and not yet read
+	};
+	FRAME_QUERIES m_frames[FRAME_LATENCY];
+	// ring slot of the frame being marked (-1 = not timing this frame)
+	int m_currentFrame;
+	// next ring slot to use
+	int m_nextFrame;
+	// scope of the last mark of the current frame
+	int m_currentScope;
+
+	int m_scopeCount;
+	// GPU time of each scope in the last HISTORY_FRAMES frames read
+	std::vector<double> m_history;
+	int m_historyCount;
+	int m_historyIndex;
+	// frames read so far
+	int m_frameCount;
+
+	// optional per-frame CSV log
+	std::ofstream m_log;
+
+	// record a timestamp starting the passed in scope
+	void AddTimestamp(int scope);
+	// read every pending frame whose queries are available
+	void CollectFrames();
+};
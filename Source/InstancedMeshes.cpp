@@ -0,0 +1,775 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedmeshes.cpp
+// ============
+// basic shape meshes drawn with per-instance transforms and colors
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InstancedMeshes.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <cstddef>
+
+// declaration of global variables and constants
+namespace
+{
+	// tessellation of the cone
+	const int CIRCLE_SEGMENTS = 36;
+
+	// tessellation of each level of detail of the curved shapes,
+	// from the finest level down; level 0 matches ShapeMeshes
+	const int LOD_CIRCLE_SEGMENTS[InstancedMeshes::LOD_COUNT] = { 36, 18, 10 };
+	const int LOD_SPHERE_STACKS[InstancedMeshes::LOD_COUNT] = { 18, 10, 6 };
+	const int LOD_TORUS_MAIN_SEGMENTS[InstancedMeshes::LOD_COUNT] = { 30, 16, 8 };
+	const int LOD_TORUS_TUBE_SEGMENTS[InstancedMeshes::LOD_COUNT] = { 30, 12, 6 };
+
+	// shape dimensions, matching ShapeMeshes
+	const float BOX_HALF_SIZE = 0.5f;
+	const float PLANE_HALF_SIZE = 1.0f;
+	const float TORUS_MAIN_RADIUS = 1.0f;
+	const float TORUS_TUBE_RADIUS = 0.1f;
+}
+
+/***********************************************************
+ *  InstancedMeshes()
+ *
+ *  The constructor for the class. It creates the shared
+ *  buffers and the vertex array reading them, so it needs a
+ *  current OpenGL context.
+ ***********************************************************/
+InstancedMeshes::InstancedMeshes()
+{
+	for (int i = 0; i < SHAPE_COUNT; i++)
+	{
+		for (int lod = 0; lod < LOD_COUNT; lod++)
+		{
+			m_meshes[i][lod] = MESH_RANGE();
+		}
+	}
+	m_bGeometryDirty = false;
+	m_instanceCapacity = 0;
+	m_bMultiDrawIndirect = (GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect);
+
+	glGenVertexArrays(1, &m_vao);
+	glGenBuffers(1, &m_vertexBuffer);
+	glGenBuffers(1, &m_indexBuffer);
+	glGenBuffers(1, &m_instanceVBO);
+	glGenBuffers(1, &m_commandBuffer);
+
+	glBindVertexArray(m_vao);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+
+	// per-vertex attributes
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glVertexAttribPointer(POSITION_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, position));
+	glEnableVertexAttribArray(POSITION_ATTRIBUTE);
+	glVertexAttribPointer(NORMAL_ATTRIBUTE, 3, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, normal));
+	glEnableVertexAttribArray(NORMAL_ATTRIBUTE);
+	glVertexAttribPointer(TEXCOORD_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, sizeof(VERTEX), (void*)offsetof(VERTEX, texCoord));
+	glEnableVertexAttribArray(TEXCOORD_ATTRIBUTE);
+
+	// per-instance attributes; the model matrix takes one location per column
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+	for (GLuint column = 0; column < 4; column++)
+	{
+		GLuint location = INSTANCE_MODEL_ATTRIBUTE + column;
+		glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(INSTANCE_DATA),
+			(void*)(offsetof(INSTANCE_DATA, model) + column * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(location);
+		glVertexAttribDivisor(location, 1);
+	}
+	glVertexAttribPointer(INSTANCE_COLOR_ATTRIBUTE, 4, GL_FLOAT, GL_FALSE, sizeof(INSTANCE_DATA),
+		(void*)offsetof(INSTANCE_DATA, color));
+	glEnableVertexAttribArray(INSTANCE_COLOR_ATTRIBUTE);
+	glVertexAttribDivisor(INSTANCE_COLOR_ATTRIBUTE, 1);
+	glVertexAttribIPointer(INSTANCE_MATERIAL_ATTRIBUTE, 1, GL_INT, sizeof(INSTANCE_DATA),
+		(void*)offsetof(INSTANCE_DATA, materialIndex));
+	glEnableVertexAttribArray(INSTANCE_MATERIAL_ATTRIBUTE);
+	glVertexAttribDivisor(INSTANCE_MATERIAL_ATTRIBUTE, 1);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  ~InstancedMeshes()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+InstancedMeshes::~InstancedMeshes()
+{
+	glDeleteVertexArrays(1, &m_vao);
+	glDeleteBuffers(1, &m_vertexBuffer);
+	glDeleteBuffers(1, &m_indexBuffer);
+	glDeleteBuffers(1, &m_instanceVBO);
+	glDeleteBuffers(1, &m_commandBuffer);
+	m_vao = m_vertexBuffer = m_indexBuffer = m_instanceVBO = m_commandBuffer = 0;
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method returns true if the current context has the
+ *  base instance draws (OpenGL 4.2), which let every draw
+ *  start at its own offset into the instance buffer.
+ ***********************************************************/
+bool InstancedMeshes::IsSupported()
+{
+	return (GLEW_VERSION_4_2 || GLEW_ARB_base_instance);
+}
+
+/***********************************************************
+ *  EndMeshPart()
+ *
+ *  This method closes the indices added to the builder since
+ *  the previous part into a new independently drawable part.
+ ***********************************************************/
+void InstancedMeshes::EndMeshPart(MESH_BUILDER& builder)
+{
+	GLsizei firstIndex = 0;
+	if (builder.numParts > 0)
+	{
+		const MESH_PART& previous = builder.parts[builder.numParts - 1];
+		firstIndex = previous.firstIndex + previous.indexCount;
+	}
+
+	MESH_PART& part = builder.parts[builder.numParts++];
+	part.firstIndex = firstIndex;
+	part.indexCount = static_cast<GLsizei>(builder.indices.size()) - firstIndex;
+}
+
+/***********************************************************
+ *  AddDisc()
+ *
+ *  This method adds a unit radius disc in the XZ plane at the
+ *  passed in height, wound to face up (normalY = 1) or down
+ *  (normalY = -1).
+ ***********************************************************/
+void InstancedMeshes::AddDisc(MESH_BUILDER& builder, float y, float normalY, int segments)
+{
+	const GLuint center = static_cast<GLuint>(builder.vertices.size());
+	const glm::vec3 normal(0.0f, normalY, 0.0f);
+
+	builder.vertices.push_back({ glm::vec3(0.0f, y, 0.0f), normal, glm::vec2(0.5f, 0.5f) });
+	for (int j = 0; j <= segments; j++)
+	{
+		float angle = glm::two_pi<float>() * j / segments;
+		float x = cos(angle);
+		float z = -sin(angle);
+		builder.vertices.push_back({ glm::vec3(x, y, z), normal, glm::vec2(0.5f + 0.5f * x, 0.5f - 0.5f * z) });
+	}
+
+	for (int j = 0; j < segments; j++)
+	{
+		GLuint current = center + 1 + j;
+		builder.indices.push_back(center);
+		if (normalY > 0.0f)
+		{
+			builder.indices.push_back(current);
+			builder.indices.push_back(current + 1);
+		}
+		else
+		{
+			builder.indices.push_back(current + 1);
+			builder.indices.push_back(current);
+		}
+	}
+}
+
+/***********************************************************
+ *  LoadBoxMesh()
+ *
+ *  This method is used for generating a unit box centered on
+ *  the origin, with its own normals and UVs on each face.
+ ***********************************************************/
+void InstancedMeshes::LoadBoxMesh()
+{
+	// face normal, then the face's U and V axes (U x V = normal)
+	const glm::vec3 faces[6][3] =
+	{
+		{ glm::vec3( 1, 0, 0), glm::vec3( 0, 0,-1), glm::vec3(0, 1, 0) },
+		{ glm::vec3(-1, 0, 0), glm::vec3( 0, 0, 1), glm::vec3(0, 1, 0) },
+		{ glm::vec3( 0, 1, 0), glm::vec3( 1, 0, 0), glm::vec3(0, 0,-1) },
+		{ glm::vec3( 0,-1, 0), glm::vec3( 1, 0, 0), glm::vec3(0, 0, 1) },
+		{ glm::vec3( 0, 0, 1), glm::vec3( 1, 0, 0), glm::vec3(0, 1, 0) },
+		{ glm::vec3( 0, 0,-1), glm::vec3(-1, 0, 0), glm::vec3(0, 1, 0) }
+	};
+
+	MESH_BUILDER builder = MESH_BUILDER();
+	for (const auto& face : faces)
+	{
+		const glm::vec3 center = face[0] * BOX_HALF_SIZE;
+		const glm::vec3 u = face[1] * BOX_HALF_SIZE;
+		const glm::vec3 v = face[2] * BOX_HALF_SIZE;
+		const GLuint first = static_cast<GLuint>(builder.vertices.size());
+
+		builder.vertices.push_back({ center - u - v, face[0], glm::vec2(0.0f, 0.0f) });
+		builder.vertices.push_back({ center + u - v, face[0], glm::vec2(1.0f, 0.0f) });
+		builder.vertices.push_back({ center + u + v, face[0], glm::vec2(1.0f, 1.0f) });
+		builder.vertices.push_back({ center - u + v, face[0], glm::vec2(0.0f, 1.0f) });
+
+		builder.indices.insert(builder.indices.end(),
+			{ first, first + 1, first + 2, first, first + 2, first + 3 });
+	}
+	EndMeshPart(builder);
+
+	AddMesh(SHAPE_BOX, 0, builder);
+}
+
+/***********************************************************
+ *  LoadConeMesh()
+ *
+ *  This method is used for generating a cone of radius 1
+ *  with its base at y = 0 and its tip at y = 1. Part 0 is
+ *  the sides and part 1 the bottom.
+ ***********************************************************/
+void InstancedMeshes::LoadConeMesh()
+{
+	MESH_BUILDER builder = MESH_BUILDER();
+
+	for (int j = 0; j < CIRCLE_SEGMENTS; j++)
+	{
+		float angle0 = glm::two_pi<float>() * j / CIRCLE_SEGMENTS;
+		float angle1 = glm::two_pi<float>() * (j + 1) / CIRCLE_SEGMENTS;
+		float angleMid = 0.5f * (angle0 + angle1);
+		const GLuint first = static_cast<GLuint>(builder.vertices.size());
+
+		// slant normals of a cone with equal radius and height
+		glm::vec3 normal0 = glm::normalize(glm::vec3(cos(angle0), 1.0f, -sin(angle0)));
+		glm::vec3 normal1 = glm::normalize(glm::vec3(cos(angle1), 1.0f, -sin(angle1)));
+		glm::vec3 normalTip = glm::normalize(glm::vec3(cos(angleMid), 1.0f, -sin(angleMid)));
+
+		builder.vertices.push_back({ glm::vec3(cos(angle0), 0.0f, -sin(angle0)), normal0,
+			glm::vec2(static_cast<float>(j) / CIRCLE_SEGMENTS, 0.0f) });
+		builder.vertices.push_back({ glm::vec3(cos(angle1), 0.0f, -sin(angle1)), normal1,
+			glm::vec2(static_cast<float>(j + 1) / CIRCLE_SEGMENTS, 0.0f) });
+		builder.vertices.push_back({ glm::vec3(0.0f, 1.0f, 0.0f), normalTip,
+			glm::vec2((j + 0.5f) / CIRCLE_SEGMENTS, 1.0f) });
+
+		builder.indices.insert(builder.indices.end(), { first, first + 1, first + 2 });
+	}
+	EndMeshPart(builder);
+
+	AddDisc(builder, 0.0f, -1.0f, CIRCLE_SEGMENTS);
+	EndMeshPart(builder);
+
+	AddMesh(SHAPE_CONE, 0, builder);
+}
+
+/***********************************************************
+ *  BuildCylinder()
+ *
+ *  This method generates one level of a cylinder of radius 1
+ *  from y = 0 to y = 1 with the passed in number of segments
+ *  around it. Parts 0, 1 and 2 are the top, the bottom and
+ *  the sides.
+ ***********************************************************/
+void InstancedMeshes::BuildCylinder(MESH_BUILDER& builder, int segments)
+{
+	AddDisc(builder, 1.0f, 1.0f, segments);
+	EndMeshPart(builder);
+
+	AddDisc(builder, 0.0f, -1.0f, segments);
+	EndMeshPart(builder);
+
+	const GLuint first = static_cast<GLuint>(builder.vertices.size());
+	for (int j = 0; j <= segments; j++)
+	{
+		float angle = glm::two_pi<float>() * j / segments;
+		float u = static_cast<float>(j) / segments;
+		glm::vec3 normal(cos(angle), 0.0f, -sin(angle));
+
+		builder.vertices.push_back({ normal, normal, glm::vec2(u, 0.0f) });
+		builder.vertices.push_back({ normal + glm::vec3(0.0f, 1.0f, 0.0f), normal, glm::vec2(u, 1.0f) });
+	}
+	for (int j = 0; j < segments; j++)
+	{
+		GLuint bottom0 = first + 2 * j;
+		GLuint top0 = bottom0 + 1;
+		GLuint bottom1 = bottom0 + 2;
+		GLuint top1 = bottom0 + 3;
+		builder.indices.insert(builder.indices.end(),
+			{ bottom0, bottom1, top1, bottom0, top1, top0 });
+	}
+	EndMeshPart(builder);
+}
+
+/***********************************************************
+ *  LoadCylinderMesh()
+ *
+ *  This method is used for generating every level of detail
+ *  of a cylinder of radius 1 from y = 0 to y = 1.
+ ***********************************************************/
+void InstancedMeshes::LoadCylinderMesh()
+{
+	for (int lod = 0; lod < LOD_COUNT; lod++)
+	{
+		MESH_BUILDER builder = MESH_BUILDER();
+		BuildCylinder(builder, LOD_CIRCLE_SEGMENTS[lod]);
+		AddMesh(SHAPE_CYLINDER, lod, builder);
+	}
+}
+
+/***********************************************************
+ *  LoadPlaneMesh()
+ *
+ *  This method is used for generating a 2 x 2 plane in the
+ *  XZ plane facing up.
+ ***********************************************************/
+void InstancedMeshes::LoadPlaneMesh()
+{
+	MESH_BUILDER builder = MESH_BUILDER();
+	const glm::vec3 normal(0.0f, 1.0f, 0.0f);
+	const float size = PLANE_HALF_SIZE;
+
+	builder.vertices.push_back({ glm::vec3(-size, 0.0f,  size), normal, glm::vec2(0.0f, 0.0f) });
+	builder.vertices.push_back({ glm::vec3( size, 0.0f,  size), normal, glm::vec2(1.0f, 0.0f) });
+	builder.vertices.push_back({ glm::vec3( size, 0.0f, -size), normal, glm::vec2(1.0f, 1.0f) });
+	builder.vertices.push_back({ glm::vec3(-size, 0.0f, -size), normal, glm::vec2(0.0f, 1.0f) });
+	builder.indices = { 0, 1, 2, 0, 2, 3 };
+	EndMeshPart(builder);
+
+	AddMesh(SHAPE_PLANE, 0, builder);
+}
+
+/***********************************************************
+ *  BuildSphere()
+ *
+ *  This method generates one level of a sphere of radius 1
+ *  centered on the origin, with the passed in number of
+ *  segments around it and stacks from pole to pole.
+ ***********************************************************/
+void InstancedMeshes::BuildSphere(MESH_BUILDER& builder, int segments, int stacks)
+{
+	for (int i = 0; i <= stacks; i++)
+	{
+		// from the north pole (i = 0) to the south pole
+		float stackAngle = glm::half_pi<float>() - glm::pi<float>() * i / stacks;
+		for (int j = 0; j <= segments; j++)
+		{
+			float sectorAngle = glm::two_pi<float>() * j / segments;
+			glm::vec3 normal(
+				cos(stackAngle) * cos(sectorAngle),
+				sin(stackAngle),
+				-cos(stackAngle) * sin(sectorAngle));
+			glm::vec2 texCoord(
+				static_cast<float>(j) / segments,
+				1.0f - static_cast<float>(i) / stacks);
+			builder.vertices.push_back({ normal, normal, texCoord });
+		}
+	}
+
+	for (int i = 0; i < stacks; i++)
+	{
+		for (int j = 0; j < segments; j++)
+		{
+			GLuint upper = i * (segments + 1) + j;
+			GLuint lower = upper + segments + 1;
+
+			// the pole rows collapse to single triangles
+			if (i != 0)
+			{
+				builder.indices.insert(builder.indices.end(), { upper, lower, upper + 1 });
+			}
+			if (i != (stacks - 1))
+			{
+				builder.indices.insert(builder.indices.end(), { upper + 1, lower, lower + 1 });
+			}
+		}
+	}
+	EndMeshPart(builder);
+}
+
+/***********************************************************
+ *  LoadSphereMesh()
+ *
+ *  This method is used for generating every level of detail
+ *  of a sphere of radius 1 centered on the origin.
+ ***********************************************************/
+void InstancedMeshes::LoadSphereMesh()
+{
+	for (int lod = 0; lod < LOD_COUNT; lod++)
+	{
+		MESH_BUILDER builder = MESH_BUILDER();
+		BuildSphere(builder, LOD_CIRCLE_SEGMENTS[lod], LOD_SPHERE_STACKS[lod]);
+		AddMesh(SHAPE_SPHERE, lod, builder);
+	}
+}
+
+/***********************************************************
+ *  BuildTorus()
+ *
+ *  This method generates one level of a torus in the XY
+ *  plane around the origin, with the passed in number of
+ *  segments around the ring and around the tube.
+ ***********************************************************/
+void InstancedMeshes::BuildTorus(MESH_BUILDER& builder, int mainSegments, int tubeSegments)
+{
+	for (int i = 0; i <= mainSegments; i++)
+	{
+		float mainAngle = glm::two_pi<float>() * i / mainSegments;
+		glm::vec3 ringCenter(cos(mainAngle) * TORUS_MAIN_RADIUS, sin(mainAngle) * TORUS_MAIN_RADIUS, 0.0f);
+
+		for (int j = 0; j <= tubeSegments; j++)
+		{
+			float tubeAngle = glm::two_pi<float>() * j / tubeSegments;
+			glm::vec3 normal(
+				cos(tubeAngle) * cos(mainAngle),
+				cos(tubeAngle) * sin(mainAngle),
+				sin(tubeAngle));
+			glm::vec2 texCoord(
+				static_cast<float>(i) / mainSegments,
+				static_cast<float>(j) / tubeSegments);
+			builder.vertices.push_back({ ringCenter + normal * TORUS_TUBE_RADIUS, normal, texCoord });
+		}
+	}
+
+	for (int i = 0; i < mainSegments; i++)
+	{
+		for (int j = 0; j < tubeSegments; j++)
+		{
+			GLuint current = i * (tubeSegments + 1) + j;
+			GLuint next = current + tubeSegments + 1;
+			builder.indices.insert(builder.indices.end(),
+				{ current, next, next + 1, current, next + 1, current + 1 });
+		}
+	}
+	EndMeshPart(builder);
+}
+
+/***********************************************************
+ *  LoadTorusMesh()
+ *
+ *  This method is used for generating every level of detail
+ *  of a torus in the XY plane around the origin.
+ ***********************************************************/
+void InstancedMeshes::LoadTorusMesh()
+{
+	for (int lod = 0; lod < LOD_COUNT; lod++)
+	{
+		MESH_BUILDER builder = MESH_BUILDER();
+		BuildTorus(builder, LOD_TORUS_MAIN_SEGMENTS[lod], LOD_TORUS_TUBE_SEGMENTS[lod]);
+		AddMesh(SHAPE_TORUS, lod, builder);
+	}
+}
+
+/***********************************************************
+ *  AddMesh()
+ *
+ *  This method appends a generated mesh to the shared vertex
+ *  and index data as the passed in level of a shape. Its
+ *  indices stay relative to its first vertex, which draws
+ *  pass as the base vertex.
+ ***********************************************************/
+void InstancedMeshes::AddMesh(SHAPE shape, int lod, const MESH_BUILDER& builder)
+{
+	MESH_RANGE& mesh = m_meshes[shape][lod];
+	if (mesh.bLoaded)
+	{
+		return;
+	}
+
+	const GLsizei firstIndex = static_cast<GLsizei>(m_indices.size());
+	mesh.bLoaded = true;
+	mesh.baseVertex = static_cast<GLint>(m_vertices.size());
+	mesh.numParts = builder.numParts;
+	for (int i = 0; i < builder.numParts; i++)
+	{
+		mesh.parts[i].indexCount = builder.parts[i].indexCount;
+		mesh.parts[i].firstIndex = firstIndex + builder.parts[i].firstIndex;
+	}
+
+	m_vertices.insert(m_vertices.end(), builder.vertices.begin(), builder.vertices.end());
+	m_indices.insert(m_indices.end(), builder.indices.begin(), builder.indices.end());
+	m_bGeometryDirty = true;
+}
+
+/***********************************************************
+ *  GetMesh()
+ *
+ *  This method returns the passed in level of a shape, or
+ *  level 0 if the shape was generated without that level.
+ ***********************************************************/
+const InstancedMeshes::MESH_RANGE& InstancedMeshes::GetMesh(SHAPE shape, int lod) const
+{
+	if ((lod > 0) && (lod < LOD_COUNT) && m_meshes[shape][lod].bLoaded)
+	{
+		return m_meshes[shape][lod];
+	}
+	return m_meshes[shape][0];
+}
+
+/***********************************************************
+ *  HasLevelsOfDetail()
+ *
+ *  This method returns true if the passed in shape was
+ *  generated with more than one level of detail.
+ ***********************************************************/
+bool InstancedMeshes::HasLevelsOfDetail(SHAPE shape) const
+{
+	return m_meshes[shape][1].bLoaded;
+}
+
+/***********************************************************
+ *  UploadGeometry()
+ *
+ *  This method copies the vertices and indices of all loaded
+ *  shapes to the shared buffers, once after loading.
+ ***********************************************************/
+void InstancedMeshes::UploadGeometry()
+{
+	if (!m_bGeometryDirty)
+	{
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(VERTEX), m_vertices.data(), GL_STATIC_DRAW);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	// the index buffer binding is vertex array state
+	glBindVertexArray(m_vao);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(GLuint), m_indices.data(), GL_STATIC_DRAW);
+	glBindVertexArray(0);
+
+	m_bGeometryDirty = false;
+}
+
+/***********************************************************
+ *  SetInstances()
+ *
+ *  This method replaces the contents of the instance buffer,
+ *  growing it if the passed in instances do not fit.
+ ***********************************************************/
+void InstancedMeshes::SetInstances(const std::vector<INSTANCE_DATA>& instances)
+{
+	const int count = static_cast<int>(instances.size());
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+	if (count > m_instanceCapacity)
+	{
+		glBufferData(GL_ARRAY_BUFFER, count * sizeof(INSTANCE_DATA), instances.data(), GL_DYNAMIC_DRAW);
+		m_instanceCapacity = count;
+	}
+	else if (count > 0)
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(INSTANCE_DATA), instances.data());
+	}
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  UpdateInstance()
+ *
+ *  This method overwrites the instance at the passed in
+ *  index, which must already be in the instance buffer.
+ ***********************************************************/
+void InstancedMeshes::UpdateInstance(int index, const INSTANCE_DATA& instance)
+{
+	if ((index < 0) || (index >= m_instanceCapacity))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instanceVBO);
+	glBufferSubData(GL_ARRAY_BUFFER, index * sizeof(INSTANCE_DATA), sizeof(INSTANCE_DATA), &instance);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  DrawMeshParts()
+ *
+ *  This method draws instanceCount copies of each part of
+ *  the passed in level of a shape whose bit is set in
+ *  partMask.
+ ***********************************************************/
+void InstancedMeshes::DrawMeshParts(SHAPE shape, int lod, unsigned int partMask, int firstInstance, int instanceCount)
+{
+	const MESH_RANGE& mesh = GetMesh(shape, lod);
+	if (!mesh.bLoaded || (instanceCount <= 0))
+	{
+		return;
+	}
+
+	UploadGeometry();
+
+	glBindVertexArray(m_vao);
+	for (int i = 0; i < mesh.numParts; i++)
+	{
+		if ((partMask & (1u << i)) != 0)
+		{
+			glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, mesh.parts[i].indexCount, GL_UNSIGNED_INT,
+				(void*)(mesh.parts[i].firstIndex * sizeof(GLuint)), instanceCount, mesh.baseVertex, firstInstance);
+		}
+	}
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  DrawBoxMeshInstanced()
+ *
+ *  This method draws copies of the box mesh.
+ ***********************************************************/
+void InstancedMeshes::DrawBoxMeshInstanced(int firstInstance, int instanceCount)
+{
+	DrawMeshParts(SHAPE_BOX, 0, 1, firstInstance, instanceCount);
+}
+
+/***********************************************************
+ *  DrawConeMeshInstanced()
+ *
+ *  This method draws copies of the cone mesh, optionally
+ *  without its bottom.
+ ***********************************************************/
+void InstancedMeshes::DrawConeMeshInstanced(int firstInstance, int instanceCount, bool bDrawBottom)
+{
+	unsigned int partMask = 1;
+	if (bDrawBottom)
+	{
+		partMask |= 2;
+	}
+	DrawMeshParts(SHAPE_CONE, 0, partMask, firstInstance, instanceCount);
+}
+
+/***********************************************************
+ *  DrawCylinderMeshInstanced()
+ *
+ *  This method draws copies of the selected parts of a level
+ *  of the cylinder mesh.
+ ***********************************************************/
+void InstancedMeshes::DrawCylinderMeshInstanced(int firstInstance, int instanceCount,
+	bool bDrawTop, bool bDrawBottom, bool bDrawSides, int lod)
+{
+	unsigned int partMask = 0;
+	if (bDrawTop)
+	{
+		partMask |= 1;
+	}
+	if (bDrawBottom)
+	{
+		partMask |= 2;
+	}
+	if (bDrawSides)
+	{
+		partMask |= 4;
+	}
+	DrawMeshParts(SHAPE_CYLINDER, lod, partMask, firstInstance, instanceCount);
+}
+
+/***********************************************************
+ *  DrawPlaneMeshInstanced()
+ *
+ *  This method draws copies of the plane mesh.
+ ***********************************************************/
+void InstancedMeshes::DrawPlaneMeshInstanced(int firstInstance, int instanceCount)
+{
+	DrawMeshParts(SHAPE_PLANE, 0, 1, firstInstance, instanceCount);
+}
+
+/***********************************************************
+ *  DrawSphereMeshInstanced()
+ *
+ *  This method draws copies of a level of the sphere mesh.
+ ***********************************************************/
+void InstancedMeshes::DrawSphereMeshInstanced(int firstInstance, int instanceCount, int lod)
+{
+	DrawMeshParts(SHAPE_SPHERE, lod, 1, firstInstance, instanceCount);
+}
+
+/***********************************************************
+ *  DrawTorusMeshInstanced()
+ *
+ *  This method draws copies of a level of the torus mesh.
+ ***********************************************************/
+void InstancedMeshes::DrawTorusMeshInstanced(int firstInstance, int instanceCount, int lod)
+{
+	DrawMeshParts(SHAPE_TORUS, lod, 1, firstInstance, instanceCount);
+}
+
+/***********************************************************
+ *  AddDrawCommands()
+ *
+ *  This method appends one indirect command per selected part
+ *  of the passed in level of a shape, drawing instanceCount
+ *  copies from firstInstance onward.
+ ***********************************************************/
+void InstancedMeshes::AddDrawCommands(SHAPE shape, unsigned int partMask, int lod, int firstInstance, int instanceCount,
+	std::vector<DRAW_COMMAND>& commands) const
+{
+	const MESH_RANGE& mesh = GetMesh(shape, lod);
+	if (!mesh.bLoaded || (instanceCount <= 0))
+	{
+		return;
+	}
+
+	for (int i = 0; i < mesh.numParts; i++)
+	{
+		if ((partMask & (1u << i)) != 0)
+		{
+			DRAW_COMMAND command;
+			command.indexCount = static_cast<GLuint>(mesh.parts[i].indexCount);
+			command.instanceCount = static_cast<GLuint>(instanceCount);
+			command.firstIndex = static_cast<GLuint>(mesh.parts[i].firstIndex);
+			command.baseVertex = mesh.baseVertex;
+			command.baseInstance = static_cast<GLuint>(firstInstance);
+			commands.push_back(command);
+		}
+	}
+}
+
+/***********************************************************
+ *  SetDrawCommands()
+ *
+ *  This method replaces the contents of the indirect command
+ *  buffer.
+ ***********************************************************/
+void InstancedMeshes::SetDrawCommands(const std::vector<DRAW_COMMAND>& commands)
+{
+	m_commands = commands;
+
+	if (m_bMultiDrawIndirect)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, m_commands.size() * sizeof(DRAW_COMMAND), m_commands.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+}
+
+/***********************************************************
+ *  DrawCommands()
+ *
+ *  This method executes commandCount commands of the indirect
+ *  command buffer from firstCommand onward, with one call if
+ *  the context supports multi-draw indirect and one call per
+ *  command otherwise.
+ ***********************************************************/
+void InstancedMeshes::DrawCommands(int firstCommand, int commandCount)
+{
+	if (commandCount <= 0)
+	{
+		return;
+	}
+
+	UploadGeometry();
+
+	glBindVertexArray(m_vao);
+	if (m_bMultiDrawIndirect)
+	{
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+			(void*)(firstCommand * sizeof(DRAW_COMMAND)), commandCount, 0);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+	}
+	else
+	{
+		for (int i = firstCommand; i < firstCommand + commandCount; i++)
+		{
+			const DRAW_COMMAND& command = m_commands[i];
+			glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, command.indexCount, GL_UNSIGNED_INT,
+				(void*)(command.firstIndex * sizeof(GLuint)), command.instanceCount,
+				command.baseVertex, command.baseInstance);
+		}
+	}
+	glBindVertexArray(0);
+}
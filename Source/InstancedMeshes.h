@@ -0,0 +1,206 @@
+///////////////////////////////////////////////////////////////////////////////
+// instancedmeshes.h
+// ============
+// basic shape meshes drawn with per-instance transforms and colors
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  InstancedMeshes
+ *
+ *  This class mirrors the basic shapes of ShapeMeshes (same
+ *  dimensions and orientation) but draws them instanced, so
+ *  any number of copies of one shape is a single draw call.
+ *  The model matrix, color and material index of each copy
+ *  are read from a shared per-instance buffer.
+ *
+ *  All shapes are suballocated from one vertex buffer and one
+ *  index buffer behind a single vertex array, so a whole
+ *  scene can be submitted as a list of indirect draw commands
+ *  with one glMultiDrawElementsIndirect() call.
+ *
+ *  The sphere, cylinder and torus are generated at LOD_COUNT
+ *  levels of detail, level 0 being the finest; every draw
+ *  selects the level it uses. The other shapes have a single
+ *  level, which every level selects.
+ ***********************************************************/
+class InstancedMeshes
+{
+public:
+	// constructor
+	InstancedMeshes();
+	// destructor
+	~InstancedMeshes();
+
+	// vertex attribute locations. A vertex shader reads the
+	// per-instance values as
+	//   layout(location = 3) in mat4 instanceModel;     // locations 3 to 6
+	//   layout(location = 7) in vec4 instanceColor;
+	//   layout(location = 8) in int instanceMaterial;
+	static constexpr GLuint POSITION_ATTRIBUTE = 0;
+	static constexpr GLuint NORMAL_ATTRIBUTE = 1;
+	static constexpr GLuint TEXCOORD_ATTRIBUTE = 2;
+	static constexpr GLuint INSTANCE_MODEL_ATTRIBUTE = 3;
+	static constexpr GLuint INSTANCE_COLOR_ATTRIBUTE = 7;
+	static constexpr GLuint INSTANCE_MATERIAL_ATTRIBUTE = 8;
+
+	// shapes held in the shared geometry buffers
+	enum SHAPE
+	{
+		SHAPE_BOX,
+		SHAPE_CONE,
+		SHAPE_CYLINDER,
+		SHAPE_PLANE,
+		SHAPE_SPHERE,
+		SHAPE_TORUS,
+		SHAPE_COUNT
+	};
+
+	// part mask selecting every part of a shape. Cylinder parts
+	// are bits 0 to 2 (top, bottom, sides); cone parts are bits
+	// 0 and 1 (sides, bottom)
+	static constexpr unsigned int ALL_PARTS = 0xFFu;
+
+	// number of levels of detail generated per curved shape
+	static constexpr int LOD_COUNT = 3;
+
+	// values of one drawn copy of a mesh
+	struct INSTANCE_DATA
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		GLint materialIndex;
+	};
+
+	// one indirect draw, laid out as OpenGL's DrawElementsIndirectCommand
+	struct DRAW_COMMAND
+	{
+		GLuint indexCount;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	// true if the context can offset instance data per draw
+	static bool IsSupported();
+
+	// methods for loading the shape mesh data
+	void LoadBoxMesh();
+	void LoadConeMesh();
+	void LoadCylinderMesh();
+	void LoadPlaneMesh();
+	void LoadSphereMesh();
+	void LoadTorusMesh();
+
+	// replace the contents of the instance buffer
+	void SetInstances(const std::vector<INSTANCE_DATA>& instances);
+	// overwrite one instance in the instance buffer
+	void UpdateInstance(int index, const INSTANCE_DATA& instance);
+
+	// methods for drawing instanceCount copies of a mesh, using
+	// the instance buffer entries from firstInstance onward
+	void DrawBoxMeshInstanced(int firstInstance, int instanceCount);
+	void DrawConeMeshInstanced(int firstInstance, int instanceCount, bool bDrawBottom = true);
+	void DrawCylinderMeshInstanced(int firstInstance, int instanceCount,
+		bool bDrawTop = true, bool bDrawBottom = true, bool bDrawSides = true, int lod = 0);
+	void DrawPlaneMeshInstanced(int firstInstance, int instanceCount);
+	void DrawSphereMeshInstanced(int firstInstance, int instanceCount, int lod = 0);
+	void DrawTorusMeshInstanced(int firstInstance, int instanceCount, int lod = 0);
+
+	// true if the shape has more than one level of detail
+	bool HasLevelsOfDetail(SHAPE shape) const;
+
+	// append the commands drawing the selected parts of a shape
+	// at the passed in level of detail
+	void AddDrawCommands(SHAPE shape, unsigned int partMask, int lod, int firstInstance, int instanceCount,
+		std::vector<DRAW_COMMAND>& commands) const;
+	// replace the contents of the indirect command buffer
+	void SetDrawCommands(const std::vector<DRAW_COMMAND>& commands);
+	// execute a range of the indirect command buffer
+	void DrawCommands(int firstCommand, int commandCount);
+
+private:
+	struct VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 texCoord;
+	};
+
+	// range of a mesh's indices that can be drawn on its own
+	struct MESH_PART
+	{
+		GLsizei indexCount;
+		GLsizei firstIndex;
+	};
+
+	static constexpr int MAX_MESH_PARTS = 3;
+
+	// location of a shape in the shared geometry buffers
+	struct MESH_RANGE
+	{
+		bool bLoaded;
+		GLint baseVertex;
+		int numParts;
+		MESH_PART parts[MAX_MESH_PARTS];
+	};
+
+	// geometry collected while a mesh is generated
+	struct MESH_BUILDER
+	{
+		std::vector<VERTEX> vertices;
+		std::vector<GLuint> indices;
+		int numParts;
+		MESH_PART parts[MAX_MESH_PARTS];
+	};
+
+	// every level of every shape; single level shapes fill level 0
+	MESH_RANGE m_meshes[SHAPE_COUNT][LOD_COUNT];
+
+	// geometry of all loaded shapes, kept until it is uploaded
+	std::vector<VERTEX> m_vertices;
+	std::vector<GLuint> m_indices;
+	// true when shapes were loaded since the last upload
+	bool m_bGeometryDirty;
+
+	// single vertex array over the shared buffers
+	GLuint m_vao;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+	// per-instance values shared by all meshes
+	GLuint m_instanceVBO;
+	// number of instances the instance buffer holds
+	int m_instanceCapacity;
+
+	// indirect draw commands, with a copy for the fallback path
+	GLuint m_commandBuffer;
+	std::vector<DRAW_COMMAND> m_commands;
+	// true if glMultiDrawElementsIndirect() is available
+	bool m_bMultiDrawIndirect;
+
+	// close the indices added since the last part into a new part
+	static void EndMeshPart(MESH_BUILDER& builder);
+	// add a flat disc of triangles facing the passed in normal
+	static void AddDisc(MESH_BUILDER& builder, float y, float normalY, int segments);
+	// generate one level of the curved shapes
+	static void BuildCylinder(MESH_BUILDER& builder, int segments);
+	static void BuildSphere(MESH_BUILDER& builder, int segments, int stacks);
+	static void BuildTorus(MESH_BUILDER& builder, int mainSegments, int tubeSegments);
+
+	// append a generated mesh to the shared geometry as a level of a shape
+	void AddMesh(SHAPE shape, int lod, const MESH_BUILDER& builder);
+	// the passed in level of a shape, or level 0 if the shape has no such level
+	const MESH_RANGE& GetMesh(SHAPE shape, int lod) const;
+	// copy the shared geometry to its buffers if it changed
+	void UploadGeometry();
+	// draw the passed in parts of a level of a shape
+	void DrawMeshParts(SHAPE shape, int lod, unsigned int partMask, int firstInstance, int instanceCount);
+};
@@ -1,5 +1,8 @@
 #include <iostream>         // error handling and output
 #include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // strcmp
+#include <cstdio>           // snprintf
+#include <chrono>           // benchmark timing
 
 #include <GL/glew.h>        // GLEW library
 #include "GLFW/glfw3.h"     // GLFW library
@@ -13,6 +16,11 @@
 #include "ViewManager.h"
 #include "ShapeMeshes.h"
 #include "ShaderManager.h"
+#include "ShaderCache.h"
+#include "ShaderUniforms.h"
+#include "FrameBenchmark.h"
+#include "SceneFile.h"
+#include "Trace.h"
 
 // Namespace for declaring global variables
 namespace
@@ -20,6 +28,11 @@ namespace
 	// Macro for window title
 	const char* const WINDOW_TITLE = "7-1 FinalProject and Milestones"; 
 
+	// scene shader sources, and the directory caching the linked program
+	const char* const VERTEX_SHADER_FILE = "../../Utilities/shaders/vertexShader.glsl";
+	const char* const FRAGMENT_SHADER_FILE = "../../Utilities/shaders/fragmentShader.glsl";
+	const char* const SHADER_CACHE_DIRECTORY = "shader_cache";
+
 	// Main GLFW window
 	GLFWwindow* g_Window = nullptr;
 
@@ -27,12 +40,92 @@ namespace
 	SceneManager* g_SceneManager = nullptr;
 	// shader manager object for dynamic interaction with the shader code
 	ShaderManager* g_ShaderManager = nullptr;
+	// uniform locations resolved once from the linked shader program
+	ShaderUniforms* g_ShaderUniforms = nullptr;
 	// view manager object for managing the 3D view setup and projection to 2D
 	ViewManager* g_ViewManager = nullptr;
+
+	// command-line run options
+	bool g_bHeadless = false;                // render offscreen without a visible window
+	bool g_bUseEGL = false;                  // headless context from EGL instead of OSMesa
+	int g_frameLimit = 0;                    // number of frames to render (0 = until closed)
+	const char* g_outputImagePath = nullptr; // optional dump of the final frame
+	int g_benchmarkFrames = 0;               // frames to measure (0 = no benchmark)
+	const char* g_benchmarkPath = nullptr;   // benchmark report file (null = stdout)
+	const char* g_streamTextureTag = nullptr;  // texture replaced while rendering
+	const char* g_streamTexturePath = nullptr; // image file streamed in for it
+	bool g_bDepthPrepass = false;            // lay down depth before shading
+	const char* g_gpuTimingPath = nullptr;   // per-frame GPU group timing CSV (null = off)
+	const char* g_tracePath = nullptr;       // CPU scope trace written on exit (null = off)
+	const char* g_scenePath = nullptr;       // text or cooked scene file (null = built-in scene)
+	const char* g_cookSourcePath = nullptr;  // text scene cooked to a binary, then exit
+	const char* g_cookBinaryPath = nullptr;  // cooked binary written for it
+	const char* g_sceneExportPath = nullptr; // built-in scene written as text (null = off)
+
+	// frames rendered before measuring so that startup costs are excluded
+	const int BENCHMARK_WARMUP_FRAMES = 10;
+
+	// frames between window title updates while a debug view is shown
+	const int DEBUG_TITLE_INTERVAL = 15;
+	// debug view named in the window title, and frames since the update
+	DebugViews::VIEW g_titleView = DebugViews::VIEW_SHADED;
+	int g_titleFrames = 0;
+
+	typedef std::chrono::steady_clock BenchmarkClock;
+
+	/**
+	 * @brief Returns the elapsed milliseconds between two clock samples
+	 * @param start The earlier time point
+	 * @param end The later time point
+	 * @return Elapsed time in milliseconds
+	 */
+	inline double ElapsedMs(BenchmarkClock::time_point start, BenchmarkClock::time_point end)
+	{
+		return std::chrono::duration<double, std::milli>(end - start).count();
+	}
+
+	/**
+	 * @brief Returns the fragments the color pass shaded per viewport pixel
+	 * @param stats The statistics of the frame
+	 * @return Shaded fragments divided by the viewport's pixels
+	 */
+	inline double FragmentsPerPixel(const SceneManager::FRAME_STATS& stats)
+	{
+		return (stats.viewportPixels > 0) ? static_cast<double>(stats.shadedFragments) / stats.viewportPixels : 0.0;
+	}
+
+	/**
+	 * @brief Shows the selected debug view and the shaded fragments per
+	 *        pixel in the window title, restoring the title afterwards
+	 * @param view The debug view drawn this frame
+	 * @param stats The statistics of the frame
+	 */
+	void UpdateDebugTitle(DebugViews::VIEW view, const SceneManager::FRAME_STATS& stats)
+	{
+		if ((view == g_titleView) && ((DebugViews::VIEW_SHADED == view) || (++g_titleFrames < DEBUG_TITLE_INTERVAL)))
+		{
+			return;
+		}
+		g_titleView = view;
+		g_titleFrames = 0;
+
+		if (DebugViews::VIEW_SHADED == view)
+		{
+			glfwSetWindowTitle(g_Window, WINDOW_TITLE);
+			return;
+		}
+
+		char title[256];
+		snprintf(title, sizeof(title), "%s - %s view - %.2f shaded fragments per pixel", WINDOW_TITLE,
+			(DebugViews::VIEW_OVERDRAW == view) ? "overdraw" : "draw order", FragmentsPerPixel(stats));
+		glfwSetWindowTitle(g_Window, title);
+	}
 }
 
 // Function declarations - all functions that are called manually
 // need to be pre-declared at the beginning of the source code.
+bool ParseCommandLine(int argc, char* argv[]);
+bool CookSceneFile(const char* sourcePath, const char* binaryPath);
 bool InitializeGLFW();
 bool InitializeGLEW();
 
@@ -45,6 +138,32 @@ bool InitializeGLEW();
  ***********************************************************/
 int main(int argc, char* argv[])
 {
+	// read the run options before any window or context is created
+	if (ParseCommandLine(argc, argv) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// cooking a scene needs no window or context
+	if (nullptr != g_cookSourcePath)
+	{
+		return CookSceneFile(g_cookSourcePath, g_cookBinaryPath) ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	// record CPU scopes from launch so that startup is on the timeline
+	if (nullptr != g_tracePath)
+	{
+#ifdef TRACING_COMPILED
+		Trace::Start();
+		TRACE_THREAD_NAME("main");
+#else
+		std::cout << "Tracing is not compiled into this build (define ENABLE_TRACING)" << std::endl;
+#endif
+	}
+
+	// startup is measured from here until the first frame is presented
+	BenchmarkClock::time_point launchTime = BenchmarkClock::now();
+
 	// if GLFW fails initialization, then terminate the application
 	if (InitializeGLFW() == false)
 	{
@@ -58,7 +177,11 @@ int main(int argc, char* argv[])
 		g_ShaderManager);
 
 	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE, g_bHeadless);
+	if (g_Window == nullptr)
+	{
+		return(EXIT_FAILURE);
+	}
 
 	// if GLEW fails initialization, then terminate the application
 	if (InitializeGLEW() == false)
@@ -66,39 +189,222 @@ int main(int argc, char* argv[])
 		return(EXIT_FAILURE);
 	}
 
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"../../Utilities/shaders/vertexShader.glsl",
-		"../../Utilities/shaders/fragmentShader.glsl");
+	// headless runs draw into a framebuffer object instead of the window
+	if (g_bHeadless && (g_ViewManager->CreateOffscreenTarget() == false))
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// a cached program binary skips compiling and linking the GLSL files
+	BenchmarkClock::time_point shaderStart = BenchmarkClock::now();
+	ShaderCache shaderCache(SHADER_CACHE_DIRECTORY);
+	GLuint cachedProgramID = shaderCache.Load(VERTEX_SHADER_FILE, FRAGMENT_SHADER_FILE);
+	if (0 != cachedProgramID)
+	{
+		g_ShaderManager->m_programID = cachedProgramID;
+	}
+	else
+	{
+		TRACE_SCOPE("LoadShaders");
+		// load the shader code from the external GLSL files
+		g_ShaderManager->LoadShaders(
+			VERTEX_SHADER_FILE,
+			FRAGMENT_SHADER_FILE);
+		shaderCache.Save(VERTEX_SHADER_FILE, FRAGMENT_SHADER_FILE, g_ShaderManager->m_programID);
+	}
 	g_ShaderManager->use();
+	std::cout << "Shader program ready in " << ElapsedMs(shaderStart, BenchmarkClock::now()) << " ms ("
+		<< ((0 != cachedProgramID) ? "cached binary" : "compiled from source") << ")" << std::endl;
+
+	// resolve the uniform locations once so that per-frame uploads
+	// skip the glGetUniformLocation() string lookups
+	g_ShaderUniforms = new ShaderUniforms();
+	g_ShaderUniforms->Resolve(g_ShaderManager->m_programID);
 
 	// try to create a new scene manager object and prepare the 3D scene
 	g_SceneManager = new SceneManager(g_ShaderManager);
+	g_SceneManager->SetShaderUniforms(g_ShaderUniforms);
+	// all GL state and uniform writes share the scene's state cache,
+	// which drops the ones that would not change anything
+	GLStateCache* stateCache = g_SceneManager->GetStateCache();
+	g_ViewManager->SetShaderUniforms(g_ShaderUniforms, stateCache);
+
+	// enable alpha blending for transparent rendering support
+	stateCache->Enable(GL_BLEND);
+	stateCache->BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// the render target and viewport keep their size for the run
+	int targetWidth = 0;
+	int targetHeight = 0;
+	g_ViewManager->GetTargetSize(targetWidth, targetHeight);
+	g_SceneManager->SetRenderTarget(g_ViewManager->GetTargetFramebuffer(), targetWidth, targetHeight);
+
+	// a scene file replaces the built-in scene; its load time is
+	// reported separately from the rest of the scene preparation
+	double sceneLoadMs = 0.0;
+	if (nullptr != g_scenePath)
+	{
+		BenchmarkClock::time_point sceneLoadStart = BenchmarkClock::now();
+		if (g_SceneManager->LoadSceneFile(g_scenePath) == false)
+		{
+			return(EXIT_FAILURE);
+		}
+		sceneLoadMs = ElapsedMs(sceneLoadStart, BenchmarkClock::now());
+		std::cout << "Loaded scene " << g_scenePath << " in " << sceneLoadMs << " ms ("
+			<< g_SceneManager->GetSceneFormat() << ")" << std::endl;
+	}
+	if (nullptr != g_sceneExportPath)
+	{
+		g_SceneManager->SetSceneExport(g_sceneExportPath);
+	}
+
+	BenchmarkClock::time_point prepareStart = BenchmarkClock::now();
 	g_SceneManager->PrepareScene();
+	g_SceneManager->SetDepthPrepass(g_bDepthPrepass);
+	if (nullptr != g_gpuTimingPath)
+	{
+		g_SceneManager->EnableGpuTiming(g_gpuTimingPath);
+	}
+	double prepareSceneMs = ElapsedMs(prepareStart, BenchmarkClock::now());
 
-	// loop will keep running until the application is closed 
+	// benchmark runs fly a fixed camera path and measure every frame
+	FrameBenchmark* benchmark = nullptr;
+	if (g_benchmarkFrames > 0)
+	{
+		benchmark = new FrameBenchmark(g_benchmarkFrames);
+		benchmark->SetDepthPrepass(g_bDepthPrepass);
+		benchmark->SetSceneLoad(g_SceneManager->GetSceneFormat(), sceneLoadMs);
+		g_ViewManager->EnableScriptedCamera(BENCHMARK_WARMUP_FRAMES + g_benchmarkFrames);
+		// measure render cost rather than the display refresh rate
+		glfwSwapInterval(0);
+	}
+
+	// loop will keep running until the application is closed,
+	// the requested number of frames has been rendered,
 	// or until an error has occurred
+	int renderedFrames = 0;
 	while (!glfwWindowShouldClose(g_Window))
 	{
+		TRACE_SCOPE("Frame");
+		BenchmarkClock::time_point frameStart = BenchmarkClock::now();
+		const GLStateCache::STATS stateStart = stateCache->GetStats();
+
 		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
+		stateCache->Enable(GL_DEPTH_TEST);
 
 		// Clear the frame and z buffers
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		// convert from 3D object space to 2D view
+		BenchmarkClock::time_point viewStart = BenchmarkClock::now();
 		g_ViewManager->PrepareSceneView();
+		g_SceneManager->SetViewProjection(g_ViewManager->GetViewProjection());
+		g_SceneManager->SetDebugView(g_ViewManager->GetDebugView());
 
 		// refresh the 3D scene
+		BenchmarkClock::time_point sceneStart = BenchmarkClock::now();
 		g_SceneManager->RenderScene();
+		BenchmarkClock::time_point sceneEnd = BenchmarkClock::now();
 
+		// when benchmarking, wait for the GPU so its time is not
+		// hidden inside the next frame's CPU work
+		if (nullptr != benchmark)
+			glFinish();
+
+		// save the final frame before the swap leaves the back
+		// buffer undefined (the read back adds to its swap time)
+		if ((nullptr != g_outputImagePath) && (renderedFrames + 1 >= g_frameLimit))
+		{
+			g_ViewManager->SaveFrameImage(g_outputImagePath);
+		}
 
 		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
+		// The offscreen target has no front buffer, so just submit the work.
+		{
+			TRACE_SCOPE("glfwSwapBuffers");
+			if (g_bHeadless)
+				glFlush();
+			else
+				glfwSwapBuffers(g_Window);
+		}
+		BenchmarkClock::time_point swapEnd = BenchmarkClock::now();
+
+		// report how long the user waited for the first image
+		if (0 == renderedFrames)
+		{
+			double firstFrameMs = ElapsedMs(launchTime, swapEnd);
+			std::cout << "Time to first frame: " << firstFrameMs << " ms (scene preparation: "
+				<< prepareSceneMs << " ms)" << std::endl;
+			if (nullptr != benchmark)
+			{
+				benchmark->SetStartupTimes(prepareSceneMs, firstFrameMs);
+			}
+
+			// the replacement is swapped in while the scene keeps rendering
+			if (nullptr != g_streamTextureTag)
+			{
+				g_SceneManager->StreamTexture(g_streamTextureTag, g_streamTexturePath);
+			}
+		}
 
 		// query the latest GLFW events
-		glfwPollEvents();
+		{
+			TRACE_SCOPE("glfwPollEvents");
+			glfwPollEvents();
+		}
+
+		// report the shading cost while a debug view is shown
+		if (!g_bHeadless)
+		{
+			UpdateDebugTitle(g_ViewManager->GetDebugView(), g_SceneManager->GetFrameStats());
+		}
+
+		// record the frame once the warm-up frames are done
+		if ((nullptr != benchmark) && (renderedFrames >= BENCHMARK_WARMUP_FRAMES))
+		{
+			FrameBenchmark::FRAME_SAMPLE sample;
+			sample.prepareViewMs = ElapsedMs(viewStart, sceneStart);
+			sample.renderSceneMs = ElapsedMs(sceneStart, sceneEnd);
+			sample.swapMs = ElapsedMs(sceneEnd, swapEnd);
+			sample.frameMs = ElapsedMs(frameStart, BenchmarkClock::now());
+			sample.drawCalls = g_SceneManager->GetFrameStats().drawCalls;
+			sample.uniformUploads = g_SceneManager->GetFrameStats().uniformUploads
+				+ g_ViewManager->GetUniformUploadCount();
+			const GLStateCache::STATS& stateEnd = stateCache->GetStats();
+			sample.filteredUniforms = stateEnd.filteredUniforms - stateStart.filteredUniforms;
+			sample.stateChanges = stateEnd.issuedStateChanges - stateStart.issuedStateChanges;
+			sample.filteredStateChanges = stateEnd.filteredStateChanges - stateStart.filteredStateChanges;
+			sample.lightUploads = g_SceneManager->GetFrameStats().lightUploads;
+			sample.transformUpdates = g_SceneManager->GetFrameStats().transformUpdates;
+			sample.visibleObjects = g_SceneManager->GetFrameStats().visibleObjects;
+			sample.culledObjects = g_SceneManager->GetFrameStats().culledObjects;
+			sample.occludedObjects = g_SceneManager->GetFrameStats().occludedObjects;
+			sample.occlusionQueries = g_SceneManager->GetFrameStats().occlusionQueries;
+			sample.reducedLodObjects = g_SceneManager->GetFrameStats().reducedLodObjects;
+			sample.shadedFragments = g_SceneManager->GetFrameStats().shadedFragments;
+			sample.fragmentsPerPixel = FragmentsPerPixel(g_SceneManager->GetFrameStats());
+			benchmark->AddSample(sample);
+		}
+
+		// stop once the requested number of frames has been rendered
+		renderedFrames++;
+		if ((g_frameLimit > 0) && (renderedFrames >= g_frameLimit))
+		{
+			break;
+		}
+	}
+
+	// report the benchmark results
+	if (nullptr != benchmark)
+	{
+		std::vector<std::string> gpuTimeNames;
+		std::vector<double> gpuTimesMs;
+		g_SceneManager->GetGpuTimes(gpuTimeNames, gpuTimesMs);
+		benchmark->SetGpuTimes(gpuTimeNames, gpuTimesMs);
+		benchmark->WriteReport(g_benchmarkPath);
+		delete benchmark;
+		benchmark = nullptr;
 	}
 
 	// clear the allocated manager objects from memory
@@ -112,16 +418,195 @@ int main(int argc, char* argv[])
 		delete g_ViewManager;
 		g_ViewManager = NULL;
 	}
+	if (NULL != g_ShaderUniforms)
+	{
+		delete g_ShaderUniforms;
+		g_ShaderUniforms = NULL;
+	}
 	if (NULL != g_ShaderManager)
 	{
 		delete g_ShaderManager;
 		g_ShaderManager = NULL;
 	}
 
+	// the texture worker threads have finished with the scene manager
+	if ((nullptr != g_tracePath) && Trace::IsRecording())
+	{
+		Trace::Write(g_tracePath);
+	}
+
 	// Terminates the program successfully
 	exit(EXIT_SUCCESS); 
 }
 
+/***********************************************************
+ *	ParseCommandLine()
+ *
+ *  This function is used to read the run options from the
+ *  command line.
+ *
+ *  --headless        render into an offscreen framebuffer with
+ *                    no visible window (OSMesa context)
+ *  --egl             create the headless context through EGL
+ *  --frames <N>      render N frames and exit
+ *  --output <file>   save the final frame as a binary PPM image
+ *                    (the first frame unless --frames is given)
+ *  --benchmark <N>   fly a scripted camera path, measure N frames
+ *                    after a short warm-up, and report as JSON
+ *  --benchmark-output <file>
+ *                    write the benchmark JSON to a file instead
+ *                    of standard output
+ *  --stream-texture <tag> <file>
+ *                    after the first frame, load the image in
+ *                    the background and swap it in for the
+ *                    texture with the tag
+ *  --depth-prepass   render depth first and shade only the
+ *                    visible fragments (compare benchmark
+ *                    reports with and without it)
+ *  --gpu-timing <file>
+ *                    time each render group on the GPU, write
+ *                    every frame to a CSV file and add rolling
+ *                    averages to the benchmark report
+ *  --trace <file>    record CPU scopes of startup and every
+ *                    frame and write them on exit as Chrome
+ *                    trace-event JSON (debug builds, or
+ *                    release builds with ENABLE_TRACING)
+ *  --scene <file>    draw a text or cooked binary scene file
+ *                    instead of the built-in scene
+ *  --cook-scene <text> <binary>
+ *                    compile a text scene to a binary that
+ *                    loads without parsing, report both load
+ *                    times and exit
+ *  --export-scene <file>
+ *                    write the scene as text when it is
+ *                    prepared, as a start for scene files
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--headless") == 0)
+		{
+			g_bHeadless = true;
+		}
+		else if (strcmp(argv[i], "--egl") == 0)
+		{
+			g_bUseEGL = true;
+		}
+		else if ((strcmp(argv[i], "--frames") == 0) && (i + 1 < argc))
+		{
+			g_frameLimit = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--output") == 0) && (i + 1 < argc))
+		{
+			g_outputImagePath = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--benchmark") == 0) && (i + 1 < argc))
+		{
+			g_benchmarkFrames = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--benchmark-output") == 0) && (i + 1 < argc))
+		{
+			g_benchmarkPath = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--stream-texture") == 0) && (i + 2 < argc))
+		{
+			g_streamTextureTag = argv[++i];
+			g_streamTexturePath = argv[++i];
+		}
+		else if (strcmp(argv[i], "--depth-prepass") == 0)
+		{
+			g_bDepthPrepass = true;
+		}
+		else if ((strcmp(argv[i], "--gpu-timing") == 0) && (i + 1 < argc))
+		{
+			g_gpuTimingPath = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--trace") == 0) && (i + 1 < argc))
+		{
+			g_tracePath = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--scene") == 0) && (i + 1 < argc))
+		{
+			g_scenePath = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--cook-scene") == 0) && (i + 2 < argc))
+		{
+			g_cookSourcePath = argv[++i];
+			g_cookBinaryPath = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--export-scene") == 0) && (i + 1 < argc))
+		{
+			g_sceneExportPath = argv[++i];
+		}
+		else
+		{
+			std::cerr << "Unknown option: " << argv[i] << "\n"
+				<< "Usage: " << argv[0]
+				<< " [--headless] [--egl] [--frames N] [--output image.ppm]"
+				<< " [--benchmark N] [--benchmark-output report.json]"
+				<< " [--stream-texture tag image] [--depth-prepass]"
+				<< " [--gpu-timing timing.csv] [--trace trace.json]"
+				<< " [--scene scene.txt|scene.bin] [--cook-scene scene.txt scene.bin]"
+				<< " [--export-scene scene.txt]" << std::endl;
+			return false;
+		}
+	}
+
+	// a benchmark run ends after its warm-up and measured frames
+	if (g_benchmarkFrames > 0)
+	{
+		g_frameLimit = BENCHMARK_WARMUP_FRAMES + g_benchmarkFrames;
+	}
+
+	// a headless run has no window to close, and a saved frame is
+	// read before its swap, so both need a known last frame
+	if ((g_bHeadless || (nullptr != g_outputImagePath)) && (g_frameLimit <= 0))
+	{
+		g_frameLimit = 1;
+	}
+
+	return true;
+}
+
+/***********************************************************
+ *	CookSceneFile()
+ *
+ *  This function is used to compile a text scene file into a
+ *  cooked binary, then load both the way the renderer does
+ *  and report how long each takes.
+ ***********************************************************/
+bool CookSceneFile(const char* sourcePath, const char* binaryPath)
+{
+	SceneFile source;
+	BenchmarkClock::time_point parseStart = BenchmarkClock::now();
+	if (source.LoadText(sourcePath) == false)
+	{
+		return false;
+	}
+	double parseMs = ElapsedMs(parseStart, BenchmarkClock::now());
+
+	if (source.WriteBinary(binaryPath) == false)
+	{
+		return false;
+	}
+
+	SceneFile cooked;
+	BenchmarkClock::time_point loadStart = BenchmarkClock::now();
+	if (cooked.LoadBinary(binaryPath) == false)
+	{
+		return false;
+	}
+	double loadMs = ElapsedMs(loadStart, BenchmarkClock::now());
+
+	std::cout << "Cooked " << source.GetObjectCount() << " objects, " << source.GetMaterialCount()
+		<< " materials, " << source.GetLightCount() << " lights and " << source.GetTextureCount()
+		<< " textures into " << binaryPath << std::endl;
+	std::cout << "Text scene parsed in " << parseMs << " ms, cooked scene loaded in "
+		<< loadMs << " ms" << std::endl;
+	return true;
+}
+
 /***********************************************************
  *	InitializeGLFW()
  * 
@@ -131,7 +616,32 @@ bool InitializeGLFW()
 {
 	// GLFW: initialize and configure library
 	// --------------------------------------
-	glfwInit();
+#ifdef GLFW_PLATFORM_NULL
+	// headless hosts have no display server to connect to
+	if (g_bHeadless)
+	{
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+	}
+#endif
+	if (!glfwInit())
+	{
+		std::cerr << "Failed to initialize GLFW" << std::endl;
+		return false;
+	}
+
+	if (g_bHeadless)
+	{
+		// the window only owns the context - rendering goes to an FBO
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+		// software and EGL drivers report their highest core version
+		// when asked for 3.3, rather than failing a 4.6 request
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API,
+			g_bUseEGL ? GLFW_EGL_CONTEXT_API : GLFW_OSMESA_CONTEXT_API);
+		return(true);
+	}
 
 #ifdef __APPLE__
 	// set the version of OpenGL and profile to use
@@ -153,6 +663,11 @@ bool InitializeGLFW()
  *	InitializeGLEW()
  *
  *  This function is used to initialize the GLEW library.
+ *
+ *  Headless contexts come from OSMesa or EGL on GLFW's null
+ *  platform. A GLX build of GLEW 2.x then fails glewInit()
+ *  with GLEW_ERROR_NO_GLX_DISPLAY after the core entry points
+ *  are already loaded, so that error is accepted there.
  ***********************************************************/
 bool InitializeGLEW()
 {
@@ -160,8 +675,22 @@ bool InitializeGLEW()
 	// -----------------------------------------
 	GLenum GLEWInitResult = GLEW_OK;
 
+	// core profile contexts do not list every extension GLEW
+	// checks for, so load the entry points regardless
+	if (g_bHeadless)
+	{
+		glewExperimental = GL_TRUE;
+	}
+
 	// try to initialize the GLEW library
 	GLEWInitResult = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+	// only the GLX extension strings are missing without a display
+	if (g_bHeadless && (GLEW_ERROR_NO_GLX_DISPLAY == GLEWInitResult))
+	{
+		GLEWInitResult = GLEW_OK;
+	}
+#endif
 	if (GLEW_OK != GLEWInitResult)
 	{
 		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
@@ -0,0 +1,361 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionqueries.cpp
+// ============
+// find hidden objects with asynchronous bounding box occlusion queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "OcclusionQueries.h"
+
+#include <iostream>
+
+// declaration of global variables and constants
+namespace
+{
+	const char* const BOX_VERTEX_SHADER =
+		"#version 330 core\n"
+		"layout(location = 0) in vec3 position;\n"
+		"uniform mat4 viewProjection;\n"
+		"void main()\n"
+		"{\n"
+		"	gl_Position = viewProjection * vec4(position, 1.0);\n"
+		"}\n";
+
+	const char* const BOX_FRAGMENT_SHADER =
+		"#version 330 core\n"
+		"out vec4 fragmentColor;\n"
+		"void main()\n"
+		"{\n"
+		"	fragmentColor = vec4(1.0);\n"
+		"}\n";
+
+	// query boxes are grown by this fraction of their largest
+	// extent, plus a fixed margin for flat boxes, so that no face
+	// lies on the object's own surface in the depth buffer
+	const float BOX_PADDING_FRACTION = 0.01f;
+	const float BOX_PADDING_MIN = 0.001f;
+
+	// the twelve triangles of a box whose corner i has
+	// x = max if bit 0 is set, y = max if bit 1, z = max if bit 2
+	const GLubyte BOX_INDICES[36] =
+	{
+		0, 2, 1,  1, 2, 3,    // -z
+		4, 5, 6,  5, 7, 6,    // +z
+		0, 1, 4,  1, 5, 4,    // -y
+		2, 6, 3,  3, 6, 7,    // +y
+		0, 4, 2,  2, 4, 6,    // -x
+		1, 3, 5,  3, 7, 5     // +x
+	};
+
+	// compile one stage of the box shader, returning 0 on failure
+	GLuint CompileShader(GLenum stage, const char* source)
+	{
+		GLuint shader = glCreateShader(stage);
+		glShaderSource(shader, 1, &source, nullptr);
+		glCompileShader(shader);
+
+		GLint bCompiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &bCompiled);
+		if (GL_FALSE == bCompiled)
+		{
+			char log[512];
+			glGetShaderInfoLog(shader, sizeof(log), nullptr, log);
+			std::cout << "Could not compile occlusion box shader:" << log << std::endl;
+			glDeleteShader(shader);
+			return 0;
+		}
+		return shader;
+	}
+}
+
+/***********************************************************
+ *  OcclusionQueries()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+OcclusionQueries::OcclusionQueries(GLStateCache* pStateCache)
+{
+	m_pStateCache = pStateCache;
+	m_queryTarget = GL_ANY_SAMPLES_PASSED;
+	m_programID = 0;
+	m_viewProjectionLocation = -1;
+	m_vertexArray = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_previousProgram = 0;
+	m_queryCount = 0;
+}
+
+/***********************************************************
+ *  ~OcclusionQueries()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+OcclusionQueries::~OcclusionQueries()
+{
+	for (OBJECT_QUERY& objectQuery : m_queries)
+	{
+		glDeleteQueries(1, &objectQuery.query);
+	}
+	m_queries.clear();
+
+	if (0 != m_programID)
+	{
+		glDeleteProgram(m_programID);
+		m_programID = 0;
+	}
+	if (0 != m_vertexArray)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		glDeleteBuffers(1, &m_vertexBuffer);
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_vertexArray = 0;
+	}
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method builds the box shader and geometry and creates
+ *  a query for each of the passed in number of objects, all
+ *  of which start out visible. Conservative queries, which
+ *  may report a hidden box as visible but are cheaper, are
+ *  used when the context supports them. Returns false if the
+ *  box shader cannot be built.
+ ***********************************************************/
+bool OcclusionQueries::Initialize(int objectCount)
+{
+	GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, BOX_VERTEX_SHADER);
+	GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, BOX_FRAGMENT_SHADER);
+	if ((0 == vertexShader) || (0 == fragmentShader))
+	{
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		return false;
+	}
+
+	m_programID = glCreateProgram();
+	glAttachShader(m_programID, vertexShader);
+	glAttachShader(m_programID, fragmentShader);
+	glLinkProgram(m_programID);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	GLint bLinked = GL_FALSE;
+	glGetProgramiv(m_programID, GL_LINK_STATUS, &bLinked);
+	if (GL_FALSE == bLinked)
+	{
+		std::cout << "Could not link occlusion box shader" << std::endl;
+		glDeleteProgram(m_programID);
+		m_programID = 0;
+		return false;
+	}
+	m_viewProjectionLocation = glGetUniformLocation(m_programID, "viewProjection");
+
+	// the corners of each queried box are written before it is drawn
+	glGenVertexArrays(1, &m_vertexArray);
+	glGenBuffers(1, &m_vertexBuffer);
+	glGenBuffers(1, &m_indexBuffer);
+	glBindVertexArray(m_vertexArray);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, 8 * sizeof(glm::vec3), nullptr, GL_STREAM_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(BOX_INDICES), BOX_INDICES, GL_STATIC_DRAW);
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	if (GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility)
+	{
+		m_queryTarget = GL_ANY_SAMPLES_PASSED_CONSERVATIVE;
+	}
+
+	m_queries.resize(objectCount);
+	for (OBJECT_QUERY& objectQuery : m_queries)
+	{
+		glGenQueries(1, &objectQuery.query);
+		objectQuery.bPending = false;
+		objectQuery.bOccluded = false;
+	}
+	return true;
+}
+
+/***********************************************************
+ *  CollectResults()
+ *
+ *  This method reads the result of every pending query that
+ *  the GPU has finished. Queries that are not yet available
+ *  are left pending, and their objects keep their previous
+ *  state. Returns true if any object's state changed.
+ ***********************************************************/
+bool OcclusionQueries::CollectResults()
+{
+	bool bChanged = false;
+
+	for (OBJECT_QUERY& objectQuery : m_queries)
+	{
+		if (!objectQuery.bPending)
+		{
+			continue;
+		}
+
+		GLuint bAvailable = GL_FALSE;
+		glGetQueryObjectuiv(objectQuery.query, GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+		if (GL_FALSE == bAvailable)
+		{
+			continue;
+		}
+
+		GLuint anySamples = 0;
+		glGetQueryObjectuiv(objectQuery.query, GL_QUERY_RESULT, &anySamples);
+		objectQuery.bPending = false;
+
+		const bool bOccluded = (0 == anySamples);
+		if (bOccluded != objectQuery.bOccluded)
+		{
+			objectQuery.bOccluded = bOccluded;
+			bChanged = true;
+		}
+	}
+	return bChanged;
+}
+
+/***********************************************************
+ *  IsOccluded()
+ *
+ *  This method returns true if the latest result found the
+ *  passed in object hidden.
+ ***********************************************************/
+bool OcclusionQueries::IsOccluded(int object) const
+{
+	return m_queries[object].bOccluded;
+}
+
+/***********************************************************
+ *  Reset()
+ *
+ *  This method marks the passed in object visible until its
+ *  next query says otherwise.
+ ***********************************************************/
+void OcclusionQueries::Reset(int object)
+{
+	m_queries[object].bOccluded = false;
+}
+
+/***********************************************************
+ *  BeginQueries()
+ *
+ *  This method prepares to query boxes against the depth
+ *  buffer of the frame that was just drawn. The box shader
+ *  replaces the current program until EndQueries().
+ ***********************************************************/
+void OcclusionQueries::BeginQueries(const glm::mat4& viewProjection)
+{
+	m_previousProgram = m_pStateCache->GetProgram();
+	m_pStateCache->UseProgram(m_programID);
+	m_pStateCache->SetMat4(m_viewProjectionLocation, viewProjection);
+
+	m_pStateCache->ColorMask(false);
+	m_pStateCache->DepthMask(false);
+	glBindVertexArray(m_vertexArray);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	m_queryCount = 0;
+}
+
+/***********************************************************
+ *  QueryBox()
+ *
+ *  This method draws the passed in world bounding box inside
+ *  the object's query. Nothing is issued while the object's
+ *  previous query is still pending. Returns true if a query
+ *  was issued.
+ *
+ *  The depth buffer already holds the object itself, so the
+ *  query box must not lie on the object's surface: a box face
+ *  at equal depth would fail the test and flag the object as
+ *  hidden behind its own geometry. Unrotated boxes and planes
+ *  have such faces, so the box is padded outward here, and
+ *  the caller queries with a GL_LEQUAL depth test.
+ ***********************************************************/
+bool OcclusionQueries::QueryBox(int object, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+{
+	OBJECT_QUERY& objectQuery = m_queries[object];
+	if (objectQuery.bPending)
+	{
+		return false;
+	}
+
+	const glm::vec3 extent = boundsMax - boundsMin;
+	const glm::vec3 padding(BOX_PADDING_MIN +
+		BOX_PADDING_FRACTION * glm::max(extent.x, glm::max(extent.y, extent.z)));
+	const glm::vec3 paddedMin = boundsMin - padding;
+	const glm::vec3 paddedMax = boundsMax + padding;
+
+	glm::vec3 corners[8];
+	for (int i = 0; i < 8; i++)
+	{
+		corners[i] = glm::vec3(
+			(i & 1) ? paddedMax.x : paddedMin.x,
+			(i & 2) ? paddedMax.y : paddedMin.y,
+			(i & 4) ? paddedMax.z : paddedMin.z);
+	}
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(corners), corners);
+
+	glBeginQuery(m_queryTarget, objectQuery.query);
+	glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, nullptr);
+	glEndQuery(m_queryTarget);
+
+	objectQuery.bPending = true;
+	m_queryCount++;
+	return true;
+}
+
+/***********************************************************
+ *  EndQueries()
+ *
+ *  This method restores the color and depth writes and the
+ *  program that was active before BeginQueries().
+ ***********************************************************/
+void OcclusionQueries::EndQueries()
+{
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+	m_pStateCache->DepthMask(true);
+	m_pStateCache->ColorMask(true);
+	m_pStateCache->UseProgram(m_previousProgram);
+}
+
+/***********************************************************
+ *  BeginConditionalRender()
+ *
+ *  This method makes the following draws depend on the
+ *  result of the passed in object's query, which the GPU
+ *  evaluates without the CPU waiting for it.
+ ***********************************************************/
+void OcclusionQueries::BeginConditionalRender(int object) const
+{
+	glBeginConditionalRender(m_queries[object].query, GL_QUERY_NO_WAIT);
+}
+
+/***********************************************************
+ *  EndConditionalRender()
+ *
+ *  This method ends the draws started by
+ *  BeginConditionalRender().
+ ***********************************************************/
+void OcclusionQueries::EndConditionalRender() const
+{
+	glEndConditionalRender();
+}
+
+/***********************************************************
+ *  GetQueryCount()
+ *
+ *  This method returns the number of queries issued since
+ *  the last BeginQueries().
+ ***********************************************************/
+int OcclusionQueries::GetQueryCount() const
+{
+	return m_queryCount;
+}
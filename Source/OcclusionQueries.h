@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// occlusionqueries.h
+// ============
+// find hidden objects with asynchronous bounding box occlusion queries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "GLStateCache.h"
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  OcclusionQueries
+ *
+ *  This class keeps one occlusion query per scene object.
+ *  After the scene is drawn, the world bounding box of each
+ *  object is drawn, with color and depth writes off, inside
+ *  its query; the result says whether any part of the box
+ *  would be visible. Results are read on later frames only
+ *  once the GPU reports them available, so the CPU never
+ *  waits, and an object found hidden is skipped until a
+ *  later query finds it visible again.
+ *
+ *  The boxes are drawn with a small built-in shader program,
+ *  so the scene shader and its instance attributes are not
+ *  involved. Program, mask and uniform changes go through the
+ *  scene's state cache.
+ ***********************************************************/
+class OcclusionQueries
+{
+public:
+	// constructor; state changes go through the passed in cache
+	OcclusionQueries(GLStateCache* pStateCache);
+	// destructor
+	~OcclusionQueries();
+
+	// create the box shader, geometry and one query per object
+	bool Initialize(int objectCount);
+
+	// read every available result, returning true if any object
+	// changed between hidden and visible
+	bool CollectResults();
+	// true if the latest result found the object hidden
+	bool IsOccluded(int object) const;
+	// forget the result of an object, e.g. when it leaves the view
+	void Reset(int object);
+
+	// switch to the box shader with color and depth writes off
+	void BeginQueries(const glm::mat4& viewProjection);
+	// query an object's box, padded off its surface, unless its previous
+	// query is still pending; returns true if a query was issued
+	bool QueryBox(int object, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+	// restore the color and depth writes and the previous program
+	void EndQueries();
+
+	// draw only if the object's query, issued this frame, passed,
+	// without waiting for it on the CPU
+	void BeginConditionalRender(int object) const;
+	void EndConditionalRender() const;
+
+	// queries issued since the last BeginQueries()
+	int GetQueryCount() const;
+
+private:
+	// state cache all state changes go through
+	GLStateCache* m_pStateCache;
+
+	struct OBJECT_QUERY
+	{
+		GLuint query;
+		bool bPending;    // issued and its result not yet read
+		bool bOccluded;   // latest result found no visible samples
+	};
+	std::vector<OBJECT_QUERY> m_queries;
+
+	// query target, conservative when the context supports it
+	GLenum m_queryTarget;
+
+	// box shader and its view-projection uniform
+	GLuint m_programID;
+	GLint m_viewProjectionLocation;
+	// one unit box drawn per query from the world corners
+	GLuint m_vertexArray;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+
+	// program active before BeginQueries()
+	GLuint m_previousProgram;
+	int m_queryCount;
+};
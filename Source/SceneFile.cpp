@@ -0,0 +1,882 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// load scene descriptions from text files or memory-mapped cooked binaries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// declaration of global variables and constants
+namespace
+{
+	// identifies a cooked scene and its layout version
+	const char SCENE_MAGIC[4] = { 'S', 'C', 'N', 'B' };
+	const uint32_t SCENE_VERSION = 1;
+
+	// start of a cooked scene, followed by the entry arrays and
+	// the string table at the recorded byte offsets
+	struct SCENE_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		uint32_t textureCount;
+		uint32_t materialCount;
+		uint32_t lightCount;
+		uint32_t objectCount;
+		uint32_t stringBytes;
+		uint32_t textureOffset;
+		uint32_t materialOffset;
+		uint32_t lightOffset;
+		uint32_t objectOffset;
+		uint32_t stringOffset;
+	};
+
+	// names used by text scenes
+	const char* const MESH_NAMES[SceneFile::MESH_COUNT] =
+		{ "box", "cone", "cylinder", "plane", "sphere", "torus" };
+	const char* const GROUP_NAMES[SceneFile::GROUP_COUNT] =
+		{ "wall", "table", "mug", "sphere", "keyboard", "touchpad", "monitor" };
+	const char* const PART_NAMES[3] = { "top", "bottom", "sides" };
+	const uint32_t MESH_CYLINDER = 2;
+
+	// significant digits written for text scene values
+	const int TEXT_PRECISION = 7;
+
+	/**
+	 * @brief Finds a name in a table
+	 * @param names The table of names
+	 * @param count The number of names in the table
+	 * @param name The name to find
+	 * @return The index of the name, or -1 if it is not in the table
+	 */
+	int FindName(const char* const* names, uint32_t count, const std::string& name)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			if (name == names[i])
+			{
+				return static_cast<int>(i);
+			}
+		}
+		return -1;
+	}
+
+	/**
+	 * @brief Reads whitespace separated numbers from a line
+	 * @param in The rest of the line
+	 * @param values Receives the numbers
+	 * @param count The number of values to read
+	 * @return True if all values were read
+	 */
+	bool ReadFloats(std::istringstream& in, float* values, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			if (!(in >> values[i]))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief Writes numbers separated by spaces
+	 * @param out The text being written
+	 * @param values The numbers
+	 * @param count The number of values to write
+	 */
+	void WriteFloats(std::ostream& out, const float* values, int count)
+	{
+		for (int i = 0; i < count; i++)
+		{
+			out << " " << values[i];
+		}
+	}
+
+	/**
+	 * @brief Tests whether a section of a cooked scene lies inside the file
+	 * @param offset The byte offset of the section
+	 * @param count The number of entries in the section
+	 * @param entrySize The size of one entry
+	 * @param fileSize The size of the file
+	 * @return True if the section is aligned and inside the file
+	 */
+	bool IsSectionValid(uint32_t offset, uint32_t count, size_t entrySize, size_t fileSize)
+	{
+		return ((offset % 4) == 0) &&
+			(static_cast<uint64_t>(offset) + static_cast<uint64_t>(count) * entrySize <= fileSize);
+	}
+}
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_pMapped = nullptr;
+	m_mappedSize = 0;
+	UseOwnedEntries();
+}
+
+/***********************************************************
+ *  ~SceneFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneFile::~SceneFile()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method drops the loaded entries and unmaps a cooked
+ *  binary.
+ ***********************************************************/
+void SceneFile::Clear()
+{
+	if (nullptr != m_pMapped)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(m_pMapped);
+#else
+		munmap(const_cast<char*>(m_pMapped), m_mappedSize);
+#endif
+		m_pMapped = nullptr;
+		m_mappedSize = 0;
+	}
+
+	m_textures.clear();
+	m_materials.clear();
+	m_lights.clear();
+	m_objects.clear();
+	m_strings.clear();
+	UseOwnedEntries();
+}
+
+/***********************************************************
+ *  UseOwnedEntries()
+ *
+ *  This method points the arrays in use at the vectors, after
+ *  a text scene is parsed or an entry is added.
+ ***********************************************************/
+void SceneFile::UseOwnedEntries()
+{
+	m_pTextures = m_textures.data();
+	m_pMaterials = m_materials.data();
+	m_pLights = m_lights.data();
+	m_pObjects = m_objects.data();
+	m_pStrings = m_strings.data();
+	m_textureCount = static_cast<uint32_t>(m_textures.size());
+	m_materialCount = static_cast<uint32_t>(m_materials.size());
+	m_lightCount = static_cast<uint32_t>(m_lights.size());
+	m_objectCount = static_cast<uint32_t>(m_objects.size());
+	m_stringBytes = static_cast<uint32_t>(m_strings.size());
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method loads a cooked binary if the file starts with
+ *  the cooked scene header, and parses it as text otherwise.
+ ***********************************************************/
+bool SceneFile::Load(const std::string& filename)
+{
+	char magic[4] = {};
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not open scene:" << filename << std::endl;
+		return false;
+	}
+	file.read(magic, sizeof(magic));
+	file.close();
+
+	if (std::equal(std::begin(SCENE_MAGIC), std::end(SCENE_MAGIC), magic))
+	{
+		return LoadBinary(filename);
+	}
+	return LoadText(filename);
+}
+
+/***********************************************************
+ *  LoadText()
+ *
+ *  This method parses a text scene. Textures and materials
+ *  must be defined before the objects that use them. Returns
+ *  false, leaving the scene empty, at the first line that
+ *  cannot be parsed.
+ ***********************************************************/
+bool SceneFile::LoadText(const std::string& filename)
+{
+	Clear();
+
+	std::ifstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not open scene:" << filename << std::endl;
+		return false;
+	}
+
+	uint32_t group = 0;
+	int material = -1;
+	int lineNumber = 0;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		lineNumber++;
+		if (!ParseLine(line, group, material))
+		{
+			std::cout << "Could not parse scene line " << lineNumber << ":" << filename << std::endl;
+			Clear();
+			return false;
+		}
+	}
+	return true;
+}
+
+/***********************************************************
+ *  ParseLine()
+ *
+ *  This method adds the item described by one line of a text
+ *  scene. The group and material carried from line to line
+ *  are updated as group lines and objects are read.
+ ***********************************************************/
+bool SceneFile::ParseLine(const std::string& line, uint32_t& group, int& material)
+{
+	std::istringstream in(line.substr(0, line.find('#')));
+	std::string keyword;
+	if (!(in >> keyword))
+	{
+		// blank line or comment
+		return true;
+	}
+
+	std::string key;
+	if (keyword == "texture")
+	{
+		std::string tag;
+		std::string filename;
+		if (!(in >> tag >> filename))
+		{
+			return false;
+		}
+		bool bAtlas = false;
+		while (in >> key)
+		{
+			if (key != "atlas")
+			{
+				return false;
+			}
+			bAtlas = true;
+		}
+		AddTexture(tag, filename, bAtlas);
+		return true;
+	}
+
+	if (keyword == "material")
+	{
+		std::string tag;
+		if (!(in >> tag))
+		{
+			return false;
+		}
+		MATERIAL_ENTRY entry = {};
+		entry.shininess = 1.0f;
+		while (in >> key)
+		{
+			bool bRead = false;
+			if (key == "ambient") bRead = ReadFloats(in, entry.ambientColor, 3);
+			else if (key == "strength") bRead = ReadFloats(in, &entry.ambientStrength, 1);
+			else if (key == "diffuse") bRead = ReadFloats(in, entry.diffuseColor, 3);
+			else if (key == "specular") bRead = ReadFloats(in, entry.specularColor, 3);
+			else if (key == "shininess") bRead = ReadFloats(in, &entry.shininess, 1);
+			if (!bRead)
+			{
+				return false;
+			}
+		}
+		AddMaterial(tag, entry);
+		return true;
+	}
+
+	if (keyword == "light")
+	{
+		LIGHT_ENTRY entry = {};
+		entry.direction[1] = -1.0f;
+		while (in >> key)
+		{
+			bool bRead = false;
+			if (key == "direction") bRead = ReadFloats(in, entry.direction, 3);
+			else if (key == "ambient") bRead = ReadFloats(in, entry.ambient, 3);
+			else if (key == "diffuse") bRead = ReadFloats(in, entry.diffuse, 3);
+			else if (key == "specular") bRead = ReadFloats(in, entry.specular, 3);
+			else if (key == "focal") bRead = ReadFloats(in, &entry.focalStrength, 1);
+			else if (key == "intensity") bRead = ReadFloats(in, &entry.specularIntensity, 1);
+			if (!bRead)
+			{
+				return false;
+			}
+		}
+		AddLight(entry);
+		return true;
+	}
+
+	if (keyword == "group")
+	{
+		std::string name;
+		if (!(in >> name))
+		{
+			return false;
+		}
+		const int index = FindName(GROUP_NAMES, GROUP_COUNT, name);
+		if (index < 0)
+		{
+			return false;
+		}
+		group = static_cast<uint32_t>(index);
+		return true;
+	}
+
+	if (keyword == "object")
+	{
+		std::string meshName;
+		if (!(in >> meshName))
+		{
+			return false;
+		}
+		const int mesh = FindName(MESH_NAMES, MESH_COUNT, meshName);
+		if (mesh < 0)
+		{
+			return false;
+		}
+
+		OBJECT_ENTRY entry = {};
+		std::fill(std::begin(entry.scale), std::end(entry.scale), 1.0f);
+		std::fill(std::begin(entry.color), std::end(entry.color), 1.0f);
+		std::fill(std::begin(entry.uvScale), std::end(entry.uvScale), 1.0f);
+		entry.texture = -1;
+		entry.mesh = static_cast<uint32_t>(mesh);
+		entry.meshParts = PARTS_ALL;
+		entry.group = group;
+		while (in >> key)
+		{
+			bool bRead = false;
+			std::string name;
+			if (key == "scale") bRead = ReadFloats(in, entry.scale, 3);
+			else if (key == "rotate") bRead = ReadFloats(in, entry.rotationDegrees, 3);
+			else if (key == "position") bRead = ReadFloats(in, entry.position, 3);
+			else if (key == "color") bRead = ReadFloats(in, entry.color, 4);
+			else if (key == "uv") bRead = ReadFloats(in, entry.uvScale, 2);
+			else if ((key == "texture") && (in >> name))
+			{
+				entry.texture = FindTexture(name);
+				bRead = (entry.texture >= 0);
+			}
+			else if ((key == "material") && (in >> name))
+			{
+				material = FindMaterial(name);
+				bRead = (material >= 0);
+			}
+			else if ((key == "parts") && (in >> name))
+			{
+				// comma separated part names, e.g. top,sides
+				entry.meshParts = 0;
+				std::istringstream parts(name);
+				std::string part;
+				bRead = true;
+				while (bRead && std::getline(parts, part, ','))
+				{
+					const int bit = FindName(PART_NAMES, 3, part);
+					bRead = (bit >= 0);
+					entry.meshParts |= bRead ? (1u << bit) : 0u;
+				}
+			}
+			if (!bRead)
+			{
+				return false;
+			}
+		}
+		entry.material = material;
+		AddObject(entry);
+		return true;
+	}
+
+	return false;
+}
+
+/***********************************************************
+ *  LoadBinary()
+ *
+ *  This method maps a cooked binary scene into memory and
+ *  points the entry arrays into the mapping. After checking
+ *  that every section and index is in range, nothing is read
+ *  or copied until the entries are used.
+ ***********************************************************/
+bool SceneFile::LoadBinary(const std::string& filename)
+{
+	Clear();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		std::cout << "Could not open scene:" << filename << std::endl;
+		return false;
+	}
+	LARGE_INTEGER fileSize;
+	HANDLE mapping = nullptr;
+	if (GetFileSizeEx(file, &fileSize) && (fileSize.QuadPart > 0))
+	{
+		mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	}
+	if (nullptr != mapping)
+	{
+		m_pMapped = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		m_mappedSize = static_cast<size_t>(fileSize.QuadPart);
+		// the view keeps the mapping open
+		CloseHandle(mapping);
+	}
+	CloseHandle(file);
+#else
+	int file = open(filename.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		std::cout << "Could not open scene:" << filename << std::endl;
+		return false;
+	}
+	struct stat fileInfo;
+	if ((fstat(file, &fileInfo) == 0) && (fileInfo.st_size > 0))
+	{
+		void* pMapped = mmap(nullptr, static_cast<size_t>(fileInfo.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+		if (MAP_FAILED != pMapped)
+		{
+			m_pMapped = static_cast<const char*>(pMapped);
+			m_mappedSize = static_cast<size_t>(fileInfo.st_size);
+		}
+	}
+	// the mapping stays valid after the file is closed
+	close(file);
+#endif
+
+	if (nullptr == m_pMapped)
+	{
+		std::cout << "Could not map scene:" << filename << std::endl;
+		m_mappedSize = 0;
+		return false;
+	}
+
+	// the mapping is page aligned, so the header can be read in place
+	const SCENE_HEADER* header = reinterpret_cast<const SCENE_HEADER*>(m_pMapped);
+	bool bValid = (m_mappedSize >= sizeof(SCENE_HEADER)) &&
+		std::equal(std::begin(SCENE_MAGIC), std::end(SCENE_MAGIC), header->magic) &&
+		(header->version == SCENE_VERSION) &&
+		IsSectionValid(header->textureOffset, header->textureCount, sizeof(TEXTURE_ENTRY), m_mappedSize) &&
+		IsSectionValid(header->materialOffset, header->materialCount, sizeof(MATERIAL_ENTRY), m_mappedSize) &&
+		IsSectionValid(header->lightOffset, header->lightCount, sizeof(LIGHT_ENTRY), m_mappedSize) &&
+		IsSectionValid(header->objectOffset, header->objectCount, sizeof(OBJECT_ENTRY), m_mappedSize) &&
+		IsSectionValid(header->stringOffset, header->stringBytes, 1, m_mappedSize) &&
+		((header->stringBytes == 0) || (m_pMapped[header->stringOffset + header->stringBytes - 1] == '\0'));
+
+	if (bValid)
+	{
+		m_pTextures = reinterpret_cast<const TEXTURE_ENTRY*>(m_pMapped + header->textureOffset);
+		m_pMaterials = reinterpret_cast<const MATERIAL_ENTRY*>(m_pMapped + header->materialOffset);
+		m_pLights = reinterpret_cast<const LIGHT_ENTRY*>(m_pMapped + header->lightOffset);
+		m_pObjects = reinterpret_cast<const OBJECT_ENTRY*>(m_pMapped + header->objectOffset);
+		m_pStrings = m_pMapped + header->stringOffset;
+		m_textureCount = header->textureCount;
+		m_materialCount = header->materialCount;
+		m_lightCount = header->lightCount;
+		m_objectCount = header->objectCount;
+		m_stringBytes = header->stringBytes;
+
+		// indices are used without checks while the scene is built
+		for (uint32_t i = 0; bValid && (i < m_textureCount); i++)
+		{
+			bValid = (m_pTextures[i].tag < m_stringBytes) && (m_pTextures[i].filename < m_stringBytes);
+		}
+		for (uint32_t i = 0; bValid && (i < m_materialCount); i++)
+		{
+			bValid = (m_pMaterials[i].tag < m_stringBytes);
+		}
+		for (uint32_t i = 0; bValid && (i < m_objectCount); i++)
+		{
+			const OBJECT_ENTRY& object = m_pObjects[i];
+			bValid = (object.texture >= -1) && (object.texture < static_cast<int32_t>(m_textureCount)) &&
+				(object.material >= -1) && (object.material < static_cast<int32_t>(m_materialCount)) &&
+				(object.mesh < MESH_COUNT) && (object.group < GROUP_COUNT);
+		}
+	}
+
+	if (!bValid)
+	{
+		std::cout << "Could not load cooked scene:" << filename << std::endl;
+		Clear();
+		return false;
+	}
+	return true;
+}
+
+/***********************************************************
+ *  IsBinary()
+ *
+ *  This method returns true if the scene was mapped from a
+ *  cooked binary.
+ ***********************************************************/
+bool SceneFile::IsBinary() const
+{
+	return (nullptr != m_pMapped);
+}
+
+/***********************************************************
+ *  WriteBinary()
+ *
+ *  This method cooks the scene: it writes the header, then
+ *  the texture, material, light and object arrays and the
+ *  string table exactly as they are laid out in memory.
+ ***********************************************************/
+bool SceneFile::WriteBinary(const std::string& filename) const
+{
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write cooked scene:" << filename << std::endl;
+		return false;
+	}
+
+	SCENE_HEADER header;
+	std::copy(std::begin(SCENE_MAGIC), std::end(SCENE_MAGIC), header.magic);
+	header.version = SCENE_VERSION;
+	header.textureCount = m_textureCount;
+	header.materialCount = m_materialCount;
+	header.lightCount = m_lightCount;
+	header.objectCount = m_objectCount;
+	header.stringBytes = m_stringBytes;
+	header.textureOffset = sizeof(SCENE_HEADER);
+	header.materialOffset = header.textureOffset + m_textureCount * sizeof(TEXTURE_ENTRY);
+	header.lightOffset = header.materialOffset + m_materialCount * sizeof(MATERIAL_ENTRY);
+	header.objectOffset = header.lightOffset + m_lightCount * sizeof(LIGHT_ENTRY);
+	header.stringOffset = header.objectOffset + m_objectCount * sizeof(OBJECT_ENTRY);
+
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(reinterpret_cast<const char*>(m_pTextures), m_textureCount * sizeof(TEXTURE_ENTRY));
+	file.write(reinterpret_cast<const char*>(m_pMaterials), m_materialCount * sizeof(MATERIAL_ENTRY));
+	file.write(reinterpret_cast<const char*>(m_pLights), m_lightCount * sizeof(LIGHT_ENTRY));
+	file.write(reinterpret_cast<const char*>(m_pObjects), m_objectCount * sizeof(OBJECT_ENTRY));
+	file.write(m_pStrings, m_stringBytes);
+	return file.good();
+}
+
+/***********************************************************
+ *  WriteText()
+ *
+ *  This method writes the scene as text that LoadText()
+ *  reads back, with a group line wherever the group changes.
+ ***********************************************************/
+bool SceneFile::WriteText(const std::string& filename) const
+{
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not write scene:" << filename << std::endl;
+		return false;
+	}
+	file << std::setprecision(TEXT_PRECISION);
+
+	for (uint32_t i = 0; i < m_textureCount; i++)
+	{
+		const TEXTURE_ENTRY& texture = m_pTextures[i];
+		file << "texture " << GetString(texture.tag) << " " << GetString(texture.filename)
+			<< (texture.bAtlas ? " atlas" : "") << "\n";
+	}
+
+	for (uint32_t i = 0; i < m_materialCount; i++)
+	{
+		const MATERIAL_ENTRY& material = m_pMaterials[i];
+		file << "material " << GetString(material.tag) << " ambient";
+		WriteFloats(file, material.ambientColor, 3);
+		file << " strength " << material.ambientStrength << " diffuse";
+		WriteFloats(file, material.diffuseColor, 3);
+		file << " specular";
+		WriteFloats(file, material.specularColor, 3);
+		file << " shininess " << material.shininess << "\n";
+	}
+
+	for (uint32_t i = 0; i < m_lightCount; i++)
+	{
+		const LIGHT_ENTRY& light = m_pLights[i];
+		file << "light direction";
+		WriteFloats(file, light.direction, 3);
+		file << " ambient";
+		WriteFloats(file, light.ambient, 3);
+		file << " diffuse";
+		WriteFloats(file, light.diffuse, 3);
+		file << " specular";
+		WriteFloats(file, light.specular, 3);
+		file << " focal " << light.focalStrength << " intensity " << light.specularIntensity << "\n";
+	}
+
+	uint32_t group = GROUP_COUNT;
+	for (uint32_t i = 0; i < m_objectCount; i++)
+	{
+		const OBJECT_ENTRY& object = m_pObjects[i];
+		if (object.group != group)
+		{
+			group = object.group;
+			file << "group " << GROUP_NAMES[group] << "\n";
+		}
+
+		file << "object " << MESH_NAMES[object.mesh] << " scale";
+		WriteFloats(file, object.scale, 3);
+		file << " rotate";
+		WriteFloats(file, object.rotationDegrees, 3);
+		file << " position";
+		WriteFloats(file, object.position, 3);
+		if (object.texture >= 0)
+		{
+			file << " texture " << GetString(m_pTextures[object.texture].tag) << " uv";
+			WriteFloats(file, object.uvScale, 2);
+		}
+		else
+		{
+			file << " color";
+			WriteFloats(file, object.color, 4);
+		}
+		if (object.material >= 0)
+		{
+			file << " material " << GetString(m_pMaterials[object.material].tag);
+		}
+		if ((object.mesh == MESH_CYLINDER) && (object.meshParts != PARTS_ALL))
+		{
+			file << " parts";
+			const char* separator = " ";
+			for (int bit = 0; bit < 3; bit++)
+			{
+				if (object.meshParts & (1u << bit))
+				{
+					file << separator << PART_NAMES[bit];
+					separator = ",";
+				}
+			}
+		}
+		file << "\n";
+	}
+	return file.good();
+}
+
+/***********************************************************
+ *  AddString()
+ *
+ *  This method appends a name to the string table and
+ *  returns its offset.
+ ***********************************************************/
+uint32_t SceneFile::AddString(const std::string& text)
+{
+	const uint32_t offset = static_cast<uint32_t>(m_strings.size());
+	m_strings.insert(m_strings.end(), text.begin(), text.end());
+	m_strings.push_back('\0');
+	return offset;
+}
+
+/***********************************************************
+ *  AddTexture()
+ *
+ *  This method adds a texture image to the scene.
+ ***********************************************************/
+void SceneFile::AddTexture(const std::string& tag, const std::string& filename, bool bAtlas)
+{
+	TEXTURE_ENTRY entry;
+	entry.tag = AddString(tag);
+	entry.filename = AddString(filename);
+	entry.bAtlas = bAtlas ? 1 : 0;
+	m_textures.push_back(entry);
+	UseOwnedEntries();
+}
+
+/***********************************************************
+ *  AddMaterial()
+ *
+ *  This method adds a material to the scene under the passed
+ *  in tag.
+ ***********************************************************/
+void SceneFile::AddMaterial(const std::string& tag, const MATERIAL_ENTRY& material)
+{
+	MATERIAL_ENTRY entry = material;
+	entry.tag = AddString(tag);
+	m_materials.push_back(entry);
+	UseOwnedEntries();
+}
+
+/***********************************************************
+ *  AddLight()
+ *
+ *  This method adds a directional light to the scene.
+ ***********************************************************/
+void SceneFile::AddLight(const LIGHT_ENTRY& light)
+{
+	m_lights.push_back(light);
+	UseOwnedEntries();
+}
+
+/***********************************************************
+ *  AddObject()
+ *
+ *  This method adds an object to the scene.
+ ***********************************************************/
+void SceneFile::AddObject(const OBJECT_ENTRY& object)
+{
+	m_objects.push_back(object);
+	UseOwnedEntries();
+}
+
+/***********************************************************
+ *  FindTexture()
+ *
+ *  This method returns the index of the texture with the
+ *  passed in tag, or -1 if there is none.
+ ***********************************************************/
+int SceneFile::FindTexture(const std::string& tag) const
+{
+	for (uint32_t i = 0; i < m_textureCount; i++)
+	{
+		if (tag == GetString(m_pTextures[i].tag))
+		{
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method returns the index of the material with the
+ *  passed in tag, or -1 if there is none.
+ ***********************************************************/
+int SceneFile::FindMaterial(const std::string& tag) const
+{
+	for (uint32_t i = 0; i < m_materialCount; i++)
+	{
+		if (tag == GetString(m_pMaterials[i].tag))
+		{
+			return static_cast<int>(i);
+		}
+	}
+	return -1;
+}
+
+/***********************************************************
+ *  GetTextureCount()
+ *
+ *  This method returns the number of textures in the scene.
+ ***********************************************************/
+uint32_t SceneFile::GetTextureCount() const
+{
+	return m_textureCount;
+}
+
+/***********************************************************
+ *  GetMaterialCount()
+ *
+ *  This method returns the number of materials in the scene.
+ ***********************************************************/
+uint32_t SceneFile::GetMaterialCount() const
+{
+	return m_materialCount;
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method returns the number of lights in the scene.
+ ***********************************************************/
+uint32_t SceneFile::GetLightCount() const
+{
+	return m_lightCount;
+}
+
+/***********************************************************
+ *  GetObjectCount()
+ *
+ *  This method returns the number of objects in the scene.
+ ***********************************************************/
+uint32_t SceneFile::GetObjectCount() const
+{
+	return m_objectCount;
+}
+
+/***********************************************************
+ *  GetTextureEntry()
+ *
+ *  This method returns the texture at the passed in index.
+ ***********************************************************/
+const SceneFile::TEXTURE_ENTRY& SceneFile::GetTextureEntry(uint32_t index) const
+{
+	return m_pTextures[index];
+}
+
+/***********************************************************
+ *  GetMaterialEntry()
+ *
+ *  This method returns the material at the passed in index.
+ ***********************************************************/
+const SceneFile::MATERIAL_ENTRY& SceneFile::GetMaterialEntry(uint32_t index) const
+{
+	return m_pMaterials[index];
+}
+
+/***********************************************************
+ *  GetLightEntry()
+ *
+ *  This method returns the light at the passed in index.
+ ***********************************************************/
+const SceneFile::LIGHT_ENTRY& SceneFile::GetLightEntry(uint32_t index) const
+{
+	return m_pLights[index];
+}
+
+/***********************************************************
+ *  GetObjectEntry()
+ *
+ *  This method returns the object at the passed in index.
+ ***********************************************************/
+const SceneFile::OBJECT_ENTRY& SceneFile::GetObjectEntry(uint32_t index) const
+{
+	return m_pObjects[index];
+}
+
+/***********************************************************
+ *  GetString()
+ *
+ *  This method returns the name at the passed in string
+ *  table offset.
+ ***********************************************************/
+const char* SceneFile::GetString(uint32_t offset) const
+{
+	return m_pStrings + offset;
+}
@@ -0,0 +1,172 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// load scene descriptions from text files or memory-mapped cooked binaries
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class holds the textures, materials, lights and
+ *  objects of a scene in flat arrays of fixed-size entries
+ *  that refer to each other by index and to their names by
+ *  offset into one string table.
+ *
+ *  A scene is written by hand as a text file, one item per
+ *  line, with named values in any order:
+ *
+ *    # comment
+ *    texture oak ../../Utilities/textures/oak-wood.jpg
+ *    texture rubber ../../Utilities/textures/rubber-coating.jpg atlas
+ *    material wood ambient 0.35 0.28 0.2 strength 0.2 diffuse 0.55 0.4 0.22 specular 0.03 0.03 0.03 shininess 8
+ *    light direction 0.5 0.57 0.2 ambient 0.14 0.1 0.08 diffuse 1 0.75 0.55 specular 0.25 0.18 0.12 focal 24 intensity 0.2
+ *    group table
+ *    object box scale 20 1 10 position 0 -0.5 0 texture oak uv 4 2 material wood
+ *    object cylinder parts top,sides color 0.2 0.2 0.2 1 rotate 0 45 0
+ *
+ *  Objects take the render group of the last group line and,
+ *  when they name no material, keep the previous object's.
+ *  Omitted object values default to unit scale, no rotation,
+ *  the origin, opaque white and a UV scale of 1.
+ *
+ *  The cooker writes the same arrays to a binary file, which
+ *  is mapped into memory and used in place: loading it checks
+ *  the header and the indices and copies nothing.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// mesh names, in SceneManager::SHAPE_MESH order
+	static constexpr uint32_t MESH_COUNT = 6;
+	// render group names, in SceneManager::RENDER_GROUP order
+	static constexpr uint32_t GROUP_COUNT = 7;
+	// cylinder parts, as in SceneManager::CYLINDER_PARTS
+	static constexpr uint32_t PARTS_ALL = 7;
+
+	// every entry holds 4-byte values only, so the cooked file
+	// needs no padding and can be used where it is mapped
+	struct TEXTURE_ENTRY
+	{
+		uint32_t tag;         // string table offset
+		uint32_t filename;    // string table offset
+		uint32_t bAtlas;      // small image packed into the texture atlas
+	};
+
+	struct MATERIAL_ENTRY
+	{
+		uint32_t tag;         // string table offset
+		float ambientColor[3];
+		float ambientStrength;
+		float diffuseColor[3];
+		float specularColor[3];
+		float shininess;
+	};
+
+	struct LIGHT_ENTRY
+	{
+		float direction[3];
+		float ambient[3];
+		float diffuse[3];
+		float specular[3];
+		float focalStrength;
+		float specularIntensity;
+	};
+
+	struct OBJECT_ENTRY
+	{
+		float scale[3];
+		float rotationDegrees[3];
+		float position[3];
+		float color[4];
+		float uvScale[2];
+		int32_t texture;      // texture index (-1 = object color)
+		int32_t material;     // material index (-1 = none)
+		uint32_t mesh;        // SceneManager::SHAPE_MESH
+		uint32_t meshParts;   // cylinder parts (ignored by other meshes)
+		uint32_t group;       // SceneManager::RENDER_GROUP
+	};
+
+	// constructor
+	SceneFile();
+	// destructor
+	~SceneFile();
+
+	// load a text scene or a cooked binary, told apart by the
+	// binary's header
+	bool Load(const std::string& filename);
+	// parse a text scene
+	bool LoadText(const std::string& filename);
+	// map a cooked binary scene
+	bool LoadBinary(const std::string& filename);
+	// true if the scene was mapped from a cooked binary
+	bool IsBinary() const;
+
+	// write the scene as a cooked binary
+	bool WriteBinary(const std::string& filename) const;
+	// write the scene as text
+	bool WriteText(const std::string& filename) const;
+
+	// add entries to a scene being built in memory; names are
+	// copied into the string table
+	void AddTexture(const std::string& tag, const std::string& filename, bool bAtlas);
+	void AddMaterial(const std::string& tag, const MATERIAL_ENTRY& material);
+	void AddLight(const LIGHT_ENTRY& light);
+	void AddObject(const OBJECT_ENTRY& object);
+	// index of the texture with the passed in tag, -1 if none
+	int FindTexture(const std::string& tag) const;
+
+	// entries of the loaded scene
+	uint32_t GetTextureCount() const;
+	uint32_t GetMaterialCount() const;
+	uint32_t GetLightCount() const;
+	uint32_t GetObjectCount() const;
+	const TEXTURE_ENTRY& GetTextureEntry(uint32_t index) const;
+	const MATERIAL_ENTRY& GetMaterialEntry(uint32_t index) const;
+	const LIGHT_ENTRY& GetLightEntry(uint32_t index) const;
+	const OBJECT_ENTRY& GetObjectEntry(uint32_t index) const;
+	// name at a string table offset
+	const char* GetString(uint32_t offset) const;
+
+private:
+	// entries of a text scene or a scene built in memory
+	std::vector<TEXTURE_ENTRY> m_textures;
+	std::vector<MATERIAL_ENTRY> m_materials;
+	std::vector<LIGHT_ENTRY> m_lights;
+	std::vector<OBJECT_ENTRY> m_objects;
+	std::vector<char> m_strings;
+
+	// mapped cooked binary (null unless loaded with LoadBinary())
+	const char* m_pMapped;
+	size_t m_mappedSize;
+
+	// the arrays in use, in the vectors or in the mapped file
+	const TEXTURE_ENTRY* m_pTextures;
+	const MATERIAL_ENTRY* m_pMaterials;
+	const LIGHT_ENTRY* m_pLights;
+	const OBJECT_ENTRY* m_pObjects;
+	const char* m_pStrings;
+	uint32_t m_textureCount;
+	uint32_t m_materialCount;
+	uint32_t m_lightCount;
+	uint32_t m_objectCount;
+	uint32_t m_stringBytes;
+
+	// drop the loaded scene and any mapping
+	void Clear();
+	// point the arrays in use at the vectors
+	void UseOwnedEntries();
+	// copy a name into the string table, returning its offset
+	uint32_t AddString(const std::string& text);
+	// index of the material with the passed in tag, -1 if none
+	int FindMaterial(const std::string& tag) const;
+	// parse one line of a text scene
+	bool ParseLine(const std::string& line, uint32_t& group, int& material);
+};
@@ -1,1435 +1,4069 @@
-﻿///////////////////////////////////////////////////////////////////////////////
-// shadermanager.cpp
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables and constants
-namespace
-{
-	// Shader uniform names
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-
-	// UV Scale Constants - Complex Texturing Technique Requirements
-	const float UV_SCALE_TILED_TEXTURE = 6.0f;      // Table oak wood (tiled - CS330 requirement)
-	const float UV_SCALE_PARTIAL_TEXTURE = 0.75f;   // Sphere rubber (partial - CS330 requirement)
-	const float UV_SCALE_WALL_TEXTURE = 2.0f;       // Background wall
-	const float UV_SCALE_MUG_BODY_U = 2.0f;         // Mug body horizontal wrap
-	const float UV_SCALE_MUG_BODY_V = 1.0f;         // Mug body vertical
-	const float UV_SCALE_DEFAULT = 1.0f;            // Standard 1:1 mapping
-
-	// Color Constants
-	const float COLOR_BLACK_PLASTIC_R = 0.08f;
-	const float COLOR_BLACK_PLASTIC_G = 0.08f;
-	const float COLOR_BLACK_PLASTIC_B = 0.08f;
-	const float COLOR_GREY_KEYS_R = 0.25f;
-	const float COLOR_GREY_KEYS_G = 0.25f;
-	const float COLOR_GREY_KEYS_B = 0.25f;
-	const float COLOR_COFFEE_R = 0.32f;
-	const float COLOR_COFFEE_G = 0.20f;
-	const float COLOR_COFFEE_B = 0.10f;
-	const float COLOR_SCREEN_R = 0.02f;
-	const float COLOR_SCREEN_G = 0.02f;
-	const float COLOR_SCREEN_B = 0.02f;
-	const float COLOR_ALPHA_OPAQUE = 1.0f;
-
-	// Transformation rotation constants
-	const float ROTATION_NONE = 0.0f;
-	const float ROTATION_QUARTER_TURN = 90.0f;
-	const float ROTATION_MUG_SEAM = 25.0f;  // Rotates marble seam away from camera
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager *pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	m_basicMeshes = new ShapeMeshes();
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	m_pShaderManager = NULL;
-	delete m_basicMeshes;
-	m_basicMeshes = NULL;
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glDeleteTextures(1, &m_textureIDs[i].ID);
-		m_textureIDs[i].ID = 0;
-		m_textureIDs[i].tag.clear();
-	}
-	m_loadedTextures = 0;
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.ambientColor = m_objectMaterials[index].ambientColor;
-			material.ambientStrength = m_objectMaterials[index].ambientStrength;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return bFound;
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationX * rotationY * rotationZ * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		int textureSlot = FindTextureSlot(textureTag);
-
-		if (textureSlot >= 0)
-		{
-			m_pShaderManager->setIntValue(g_UseTextureName, true);
-			m_pShaderManager->setSampler2DValue(g_TextureValueName, textureSlot);
-		}
-		else
-		{
-			// Texture tag not found: use solid color path to avoid sampling garbage.
-			m_pShaderManager->setIntValue(g_UseTextureName, false);
-			// (No SetShaderColor here; caller decides the fallback color.)
-		}
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.ambientColor", material.ambientColor);
-			m_pShaderManager->setFloatValue("material.ambientStrength", material.ambientStrength);
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-/**************************************************************/
-/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
-/*** preparing and rendering their own 3D replicated scenes.***/
-/*** Please refer to the code in the OpenGL sample project  ***/
-/*** for assistance.                                        ***/
-/**************************************************************/
-
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadBoxMesh();  // For table with thickness
-
-	// Load our coffee mug components
-	m_basicMeshes->LoadCylinderMesh();  // Main mug body
-	m_basicMeshes->LoadTorusMesh();     // Handle and base rim
-
-	// Load sphere for stress ball
-	m_basicMeshes->LoadSphereMesh();
-
-	// Load cone for monitor stand connector
-	m_basicMeshes->LoadConeMesh();
-
-	// Set vertical adjustment for mug components
-	m_mugVerticalOffset = -0.9375f;  // Adjusted so mug sits properly on base (scaled down 25%)
-
-	// Load all scene textures
-	LoadSceneTextures();
-
-	// Define material properties for all objects
-	DefineObjectMaterials();
-
-	// Define lighting for the scene
-	DefineLights();
-}
-
-/***********************************************************
- *  LoadSceneTextures()
- *
- *  This method is used for loading all texture images from
- *  files and associating them with texture tags for easy
- *  reference during rendering.
- ***********************************************************/
-void SceneManager::LoadSceneTextures()
-{
-	bool bReturn = false;
-
-	// Load oak wood texture for table plane (tiled - complex technique)
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/oak-wood.jpg",
-		"oak");
-	if (!bReturn) {
-		std::cout << "Failed to load oak-wood.jpg texture" << std::endl;
-	}
-
-	// Load grey marble texture for mug body
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/grey-marble.jpg",
-		"marble");
-	if (!bReturn) {
-		std::cout << "Failed to load grey-marble.jpg texture" << std::endl;
-	}
-
-	// Load pale wall texture for mug handle
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/pale-wall.jpg",
-		"pale_wall");
-	if (!bReturn) {
-		std::cout << "Failed to load pale-wall.jpg texture" << std::endl;
-	}
-
-	// Load cracked cement texture for mug base
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/cracked-cement.jpg",
-		"cement");
-	if (!bReturn) {
-		std::cout << "Failed to load cracked-cement.jpg texture" << std::endl;
-	}
-
-	// Load rubber coating texture for stress ball
-	bReturn = CreateGLTexture(
-		"../../Utilities/textures/rubber-coating.jpg",
-		"rubber");
-	if (!bReturn) {
-		std::cout << "Failed to load rubber-coating.jpg texture" << std::endl;
-	}
-
-	// Bind all loaded textures to OpenGL texture slots
-	BindGLTextures();
-}
-
-/***********************************************************
- *  DefineLights()
- *
- *  Defines a five-light system using directional lights to
- *  simulate realistic indoor lighting with natural sunlight.
- *  Enhanced fill lighting eliminates dark shadows per
- *  instructor feedback while maintaining visual depth.
- *
- *  CS330 REQUIREMENTS FULFILLED:
- *  - LIGHTING: 5 light sources (required: minimum 2)
- *  - NO COMPLETE SHADOWS: All objects remain visible
- *
- *  LIGHTING STRATEGY:
- *  - Light 0: Primary sunset sunlight (warm, directional)
- *  - Lights 1-4: Fill lights from multiple angles
- *  - Brightened fill values ensure no dark areas
- ***********************************************************/
-void SceneManager::DefineLights()
-{
-	// ============================================================
-	// LIGHT 0: Primary Sunlight (warm sunset, main illumination)
-	// ============================================================
-	// Direction: Low angle (~35° elevation) from front-right
-	//   - Positive X (0.50) = coming from right side
-	//   - Positive Y (0.57) = angled downward from above
-	//   - Positive Z (0.20) = slight forward component
-	m_dirLights[0].direction = glm::normalize(glm::vec3(0.50f, 0.57f, 0.20f));
-
-	// Ambient: Warm base illumination present everywhere
-	m_dirLights[0].ambient = glm::vec3(0.14f, 0.10f, 0.08f);  // Red-biased for sunset warmth
-
-	// Diffuse: Strong warm orange/red tones simulate golden hour sunlight
-	m_dirLights[0].diffuse = glm::vec3(1.0f, 0.75f, 0.55f);  // Full red, reduced green/blue
-
-	// Specular: Warm highlights on glossy surfaces
-	m_dirLights[0].specular = glm::vec3(0.25f, 0.18f, 0.12f);
-
-	// Focal strength: Moderate focus for soft sunset lighting
-	m_dirLights[0].focalStrength = 24.0f;
-
-	// Specular intensity: Subtle highlights
-	m_dirLights[0].specularIntensity = 0.15f;
-
-	// ============================================================
-	// LIGHT 1: Sky Fill (cool blue, from above) - BRIGHTENED
-	// ============================================================
-	// Direction: Nearly vertical from above, slight diagonal
-	//   - Near-vertical Y (0.985) = overhead sky dome lighting
-	//   - Minimal X,Z (-0.123) = very slight angle variation
-	m_dirLights[1].direction = glm::normalize(glm::vec3(-0.123f, 0.985f, -0.123f));
-
-	// Ambient: Cool blue ambient (brightened per instructor feedback)
-	m_dirLights[1].ambient = glm::vec3(0.04f, 0.04f, 0.05f);  // DOUBLED from 0.02
-
-	// Diffuse: Cool blue skylight (brightened significantly)
-	m_dirLights[1].diffuse = glm::vec3(0.38f, 0.42f, 0.50f);  // INCREASED ~70% from (0.22, 0.26, 0.34)
-
-	// Specular: None (diffuse fill only)
-	m_dirLights[1].specular = glm::vec3(0.0f);
-	m_dirLights[1].focalStrength = 12.0f;
-	m_dirLights[1].specularIntensity = 0.0f;
-
-	// ============================================================
-	// LIGHT 2: Wall Bounce (warm, from left-front) - BRIGHTENED
-	// ============================================================
-	// Direction: Low angle from left-front, simulates light bouncing off wall
-	//   - Negative X (-0.612) = coming from left side
-	//   - Positive Y (0.500) = angled downward
-	//   - Negative Z (-0.612) = coming from front
-	m_dirLights[2].direction = glm::normalize(glm::vec3(-0.612f, 0.500f, -0.612f));
-
-	// Ambient: Neutral warm (brightened per instructor feedback)
-	m_dirLights[2].ambient = glm::vec3(0.02f);  // DOUBLED from 0.01
-
-	// Diffuse: Warm bounce light (doubled intensity)
-	m_dirLights[2].diffuse = glm::vec3(0.28f, 0.24f, 0.20f);  // DOUBLED from (0.14, 0.12, 0.10)
-
-	// Specular: None (simulates diffuse bounce)
-	m_dirLights[2].specular = glm::vec3(0.0f);
-	m_dirLights[2].focalStrength = 10.0f;
-	m_dirLights[2].specularIntensity = 0.0f;
-
-	// ============================================================
-	// LIGHT 3: Back Fill (neutral, from behind) - BRIGHTENED
-	// ============================================================
-	// Direction: Low angle from back-left, fills rear shadows
-	//   - Negative X (-0.683) = coming from left
-	//   - Low Y (0.259) = nearly horizontal
-	//   - Positive Z (0.683) = coming from behind
-	m_dirLights[3].direction = glm::normalize(glm::vec3(-0.683f, 0.259f, 0.683f));
-
-	// Ambient: Neutral (brightened per instructor feedback)
-	m_dirLights[3].ambient = glm::vec3(0.02f);  // DOUBLED from 0.01
-
-	// Diffuse: Neutral grey (more than doubled)
-	m_dirLights[3].diffuse = glm::vec3(0.18f);  // INCREASED 125% from 0.08
-
-	// Specular: None (ambient fill only)
-	m_dirLights[3].specular = glm::vec3(0.0f);
-	m_dirLights[3].focalStrength = 8.0f;
-	m_dirLights[3].specularIntensity = 0.0f;
-
-	// ============================================================
-	// LIGHT 4: Overhead Indoor (neutral cool, directly down)
-	// ============================================================
-	// Direction: Straight down, simulates ceiling light
-	//   - Zero X,Z = perfectly vertical
-	//   - Negative Y (-1.0) = pointing downward
-	m_dirLights[4].direction = glm::normalize(glm::vec3(0.0f, -1.0f, 0.0f));
-
-	// Ambient: Cool neutral
-	m_dirLights[4].ambient = glm::vec3(0.03f);
-
-	// Diffuse: Cool neutral white (slight blue tint for indoor fluorescent feel)
-	m_dirLights[4].diffuse = glm::vec3(0.25f, 0.25f, 0.28f);
-
-	// Specular: None (ambient indoor lighting)
-	m_dirLights[4].specular = glm::vec3(0.0f);
-	m_dirLights[4].focalStrength = 16.0f;
-	m_dirLights[4].specularIntensity = 0.0f;
-}
-
-/***********************************************************
- *  UploadLights()
- *
- *  This method uploads the directional light data to the
- *  active shader program. Called once per frame before
- *  drawing the scene.
- ***********************************************************/
-void SceneManager::UploadLights()
-{
-	GLuint program = m_pShaderManager->m_programID;
-	glUseProgram(program);
-	m_pShaderManager->setIntValue("bUseLighting", true);
-
-	auto setLight = [&](int index, const DIRECTIONAL_LIGHT& light)
-		{
-			std::string base = "lightSources[" + std::to_string(index) + "]";
-			glm::vec3 position = glm::normalize(light.direction) * 1e6f; // keep the “distant point” approach
-			m_pShaderManager->setVec3Value(base + ".position", position);
-			m_pShaderManager->setVec3Value(base + ".ambientColor", light.ambient);
-			m_pShaderManager->setVec3Value(base + ".diffuseColor", light.diffuse);
-			m_pShaderManager->setVec3Value(base + ".specularColor", light.specular);
-			m_pShaderManager->setFloatValue(base + ".focalStrength", light.focalStrength);
-			m_pShaderManager->setFloatValue(base + ".specularIntensity", light.specularIntensity);
-		};
-
-	for (int i = 0; i < NUM_DIR_LIGHTS; ++i) setLight(i, m_dirLights[i]);
-}
-
-/***********************************************************
- *  DefineObjectMaterials()
- *
- *  This method is used for defining material properties
- *  for all objects in the scene. Materials control how
- *  surfaces interact with light and texture colors.
- ***********************************************************/
-void SceneManager::DefineObjectMaterials()
-{
-	// Wood material for table plane
-	OBJECT_MATERIAL woodMaterial;
-	woodMaterial.ambientColor = glm::vec3(0.35f, 0.28f, 0.20f);
-	woodMaterial.ambientStrength = 0.20f;
-	woodMaterial.diffuseColor = glm::vec3(0.55f, 0.40f, 0.22f);
-	woodMaterial.specularColor = glm::vec3(0.03f);
-	woodMaterial.shininess = 8.0f;
-	woodMaterial.tag = "wood";
-	m_objectMaterials.push_back(woodMaterial);
-
-	// Marble material for mug body
-	OBJECT_MATERIAL marbleMaterial;
-	marbleMaterial.ambientColor = glm::vec3(0.22f);
-	marbleMaterial.ambientStrength = 0.22f;
-	marbleMaterial.diffuseColor = glm::vec3(0.36f);
-	marbleMaterial.specularColor = glm::vec3(0.01f);
-	marbleMaterial.shininess = 4.0f;
-	marbleMaterial.tag = "marble";
-	m_objectMaterials.push_back(marbleMaterial);
-
-	// Ceramic material for mug handle
-	OBJECT_MATERIAL ceramicMaterial;
-	ceramicMaterial.ambientColor = glm::vec3(0.34f);
-	ceramicMaterial.ambientStrength = 0.16f;
-	ceramicMaterial.diffuseColor = glm::vec3(0.60f);
-	ceramicMaterial.specularColor = glm::vec3(0.02f);
-	ceramicMaterial.shininess = 4.0f;
-	ceramicMaterial.tag = "ceramic";
-	m_objectMaterials.push_back(ceramicMaterial);
-
-	// Concrete material for mug base
-	OBJECT_MATERIAL concreteMaterial;
-	concreteMaterial.ambientColor = glm::vec3(0.20f);
-	concreteMaterial.ambientStrength = 0.30f;
-	concreteMaterial.diffuseColor = glm::vec3(0.40f);
-	concreteMaterial.specularColor = glm::vec3(0.04f);
-	concreteMaterial.shininess = 6.0f;
-	concreteMaterial.tag = "concrete";
-	m_objectMaterials.push_back(concreteMaterial);
-
-	// Coffee (liquid)
-	OBJECT_MATERIAL coffeeMaterial;
-	coffeeMaterial.ambientColor = glm::vec3(0.24f, 0.15f, 0.08f);
-	coffeeMaterial.ambientStrength = 0.25f;
-	coffeeMaterial.diffuseColor = glm::vec3(0.32f, 0.20f, 0.10f);
-	coffeeMaterial.specularColor = glm::vec3(0.08f, 0.06f, 0.04f);
-	coffeeMaterial.shininess = 5.0f;
-	coffeeMaterial.tag = "coffee";
-	m_objectMaterials.push_back(coffeeMaterial);
-
-	// Blue stress ball (rubber)
-	OBJECT_MATERIAL rubberMaterial;
-	rubberMaterial.ambientColor = glm::vec3(0.15f, 0.20f, 0.35f);
-	rubberMaterial.ambientStrength = 0.35f;
-	rubberMaterial.diffuseColor = glm::vec3(0.30f, 0.40f, 0.70f);
-	rubberMaterial.specularColor = glm::vec3(0.05f, 0.05f, 0.08f);  // Low specular for matte rubber
-	rubberMaterial.shininess = 6.0f;  // Low shininess for rubber
-	rubberMaterial.tag = "rubber";
-	m_objectMaterials.push_back(rubberMaterial);
-
-	// Black plastic for keyboard frame
-	OBJECT_MATERIAL plasticMaterial;
-	plasticMaterial.ambientColor = glm::vec3(0.02f, 0.02f, 0.02f);
-	plasticMaterial.ambientStrength = 0.15f;
-	plasticMaterial.diffuseColor = glm::vec3(0.08f, 0.08f, 0.08f);
-	plasticMaterial.specularColor = glm::vec3(0.10f, 0.10f, 0.10f);
-	plasticMaterial.shininess = 12.0f;
-	plasticMaterial.tag = "plastic";
-	m_objectMaterials.push_back(plasticMaterial);
-
-	// Semi-gloss plastic for monitor frame
-	OBJECT_MATERIAL semiGlossPlasticMaterial;
-	semiGlossPlasticMaterial.ambientColor = glm::vec3(0.02f, 0.02f, 0.02f);
-	semiGlossPlasticMaterial.ambientStrength = 0.15f;
-	semiGlossPlasticMaterial.diffuseColor = glm::vec3(0.08f, 0.08f, 0.08f);
-	semiGlossPlasticMaterial.specularColor = glm::vec3(0.15f, 0.15f, 0.15f);
-	semiGlossPlasticMaterial.shininess = 28.0f;
-	semiGlossPlasticMaterial.tag = "semi_gloss_plastic";
-	m_objectMaterials.push_back(semiGlossPlasticMaterial);
-
-	// Glossy black screen for monitor display
-	OBJECT_MATERIAL screenMaterial;
-	screenMaterial.ambientColor = glm::vec3(0.01f, 0.01f, 0.01f);
-	screenMaterial.ambientStrength = 0.1f;
-	screenMaterial.diffuseColor = glm::vec3(0.02f, 0.02f, 0.02f);
-	screenMaterial.specularColor = glm::vec3(0.3f, 0.3f, 0.3f);
-	screenMaterial.shininess = 64.0f;
-	screenMaterial.tag = "screen";
-	m_objectMaterials.push_back(screenMaterial);
-
-	// Wall material (uses ceramic material values for matte appearance)
-	OBJECT_MATERIAL wallMaterial;
-	wallMaterial.ambientColor = glm::vec3(0.34f);
-	wallMaterial.ambientStrength = 0.16f;
-	wallMaterial.diffuseColor = glm::vec3(0.60f);
-	wallMaterial.specularColor = glm::vec3(0.02f);
-	wallMaterial.shininess = 4.0f;
-	wallMaterial.tag = "wall";
-	m_objectMaterials.push_back(wallMaterial);
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// Upload lighting data to shader
-	UploadLights();
-
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	// Render the background wall (furthest back)
-	RenderWall();
-
-	// Render the table surface
-	RenderTablePlane();
-
-	// Render the coffee mug
-	RenderMug();
-
-	// Render desk objects
-	RenderBlueSphere();
-	RenderKeyboard();
-	RenderTouchpad();
-	RenderMonitor();
-}
-
-/***********************************************************
- *  RenderMug()
- *
- *  Renders complete coffee mug with components by calling
- *  component render methods in proper sequence.
- *
- *  ARTISTIC CHOICE: Coffee mug as centerpiece of workspace
- *  scene. Complex object demonstrating multi-primitive
- *  composition with varied materials and textures.
- ***********************************************************/
-void SceneManager::RenderMug()
-{
-	RenderMugBody();
-	RenderMugInterior();
-	RenderCoffee();
-	RenderMugHandle();
-	RenderMugBase();
-}
-
-/***********************************************************
- *  RenderTablePlane()
- *
- *  Renders desk table surface as a low-profile box with
- *  tiled oak wood texture. This forms the base plane of the
- *  entire scene upon which all other objects rest.
- *
- *  ARTISTIC CHOICE: Natural oak wood provides warm, organic
- *  foundation for the scene. Tiling at 6x demonstrates the
- *  complex texturing technique requirement while creating
- *  realistic wood grain detail across the large 20x20 plane.
- *
- *  CS330 REQUIREMENTS FULFILLED:
- *  - TILED TEXTURE: UV scale 6.0x6.0 (required: >1.0)
- ***********************************************************/
-void SceneManager::RenderTablePlane()
-{
-	// Apply TILED oak wood texture (Complex Texturing Technique Requirement)
-	SetShaderTexture("oak");
-	SetTextureUVScale(UV_SCALE_TILED_TEXTURE, UV_SCALE_TILED_TEXTURE);  // 6x6 tiling
-	SetShaderMaterial("wood");
-
-	// Transformation parameters for table surface
-	// Scale: 20x20 plane with 0.5 height for thickness
-	// Position: Centered at origin (0,0,0), lowered by -0.25 so top surface is at Y=0
-	glm::vec3 scaleXYZ = glm::vec3(20.0f, 0.5f, 20.0f);
-	float XrotationDegrees = ROTATION_NONE;
-	float YrotationDegrees = ROTATION_NONE;
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(0.0f, -0.25f, 0.0f);
-
-	// Apply transformations (Scale → Rotate → Translate)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-
-	// Draw the box mesh (creates table with visible thickness)
-	m_basicMeshes->DrawBoxMesh();
-}
-
-/***********************************************************
- *  RenderMugBody()
- *
- *  Renders the outer shell of the coffee mug as an open-top
- *  cylinder with grey marble texture. This is part of the
- *  complex multi-primitive mug object.
- *
- *  ARTISTIC CHOICE: Grey marble creates an elegant, premium
- *  appearance. The natural veining adds visual interest while
- *  maintaining the neutral color palette. Cylindrical mapping
- *  on complex shape demonstrates advanced texture techniques.
- ***********************************************************/
-void SceneManager::RenderMugBody()
-{
-	// Apply grey marble texture to mug body
-	// UV scale 2.0 horizontal wraps texture twice around circumference
-	SetShaderTexture("marble");
-	SetTextureUVScale(UV_SCALE_MUG_BODY_U, UV_SCALE_MUG_BODY_V);  // 2.0x1.0
-	SetShaderMaterial("marble");
-
-	// Transformation parameters for mug outer cylinder
-	// Scale: 0.9 diameter, 2.25 height (scaled down 25% from original design)
-	// Rotation Y: 25° rotates marble seam away from camera view
-	// Position: Left side of table at (-5, 1.125, 1), adjusted by vertical offset
-	glm::vec3 scaleXYZ = glm::vec3(0.9f, 2.25f, 0.9f);
-	float XrotationDegrees = ROTATION_NONE;          // Upright cylinder
-	float YrotationDegrees = ROTATION_MUG_SEAM;      // Rotate texture seam away from view
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(-5.0f, 1.125f + m_mugVerticalOffset, 1.0f);
-
-	// Apply transformations (Scale → Rotate → Translate)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-
-	// Draw cylinder without top cap to create open mug
-	m_basicMeshes->DrawCylinderMesh(false, true, true);  // top=false, bottom=true, sides=true
-}
-
-/***********************************************************
- *  RenderMugInterior()
- *
- *  Renders interior cylinder of mug with pale wall texture.
- *  Slightly smaller diameter than outer body creates visible
- *  wall thickness and hollow cavity.
- *
- *  ARTISTIC CHOICE: Creates hollow mug interior visible from
- *  above. Uses pale wall texture to contrast with marble
- *  exterior and suggest a ceramic glazed interior surface.
- ***********************************************************/
-void SceneManager::RenderMugInterior()
-{
-	// Apply pale wall texture to interior (creates light interior surface)
-	SetShaderTexture("pale_wall");
-	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);  // 1:1 mapping
-	SetShaderMaterial("ceramic");
-
-	// Transformation parameters for interior cylinder
-	// Scale: 0.81 diameter (0.09 smaller than 0.9 outer = visible wall thickness)
-	//        2.025 height (slightly shorter than 2.25 outer)
-	// Rotation Y: 25° matches outer body seam alignment
-	// Position: Same X,Z as body, slightly lower Y for positioning
-	glm::vec3 scaleXYZ = glm::vec3(0.81f, 2.025f, 0.81f);
-	float XrotationDegrees = ROTATION_NONE;
-	float YrotationDegrees = ROTATION_MUG_SEAM;  // Align with outer body
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(-5.0f, 1.0125f + m_mugVerticalOffset, 1.0f);
-
-	// Apply transformations (Scale → Rotate → Translate)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-
-	// Draw cylinder sides only (no caps) to create hollow interior cavity
-	m_basicMeshes->DrawCylinderMesh(false, false, true);  // top=false, bottom=false, sides=true
-}
-
-/***********************************************************
- *  RenderCoffee()
- *
- *  Renders coffee liquid inside the mug as a solid-color
- *  cylinder. Uses color-based rendering (no texture) to
- *  demonstrate both texture and color rendering techniques.
- *
- *  ARTISTIC CHOICE: Brown cylinder fills mug to ~85% height
- *  to simulate coffee. Top cap creates visible liquid surface.
- ***********************************************************/
-void SceneManager::RenderCoffee()
-{
-	// Transformation parameters for coffee cylinder
-	// Scale: 0.795 diameter (slightly smaller than 0.81 interior)
-	//        1.95 height (fills mug to ~85%, high enough to hide handle attachment)
-	// Position: Same X,Z as mug, positioned to sit inside interior
-	glm::vec3 scaleXYZ = glm::vec3(0.795f, 1.95f, 0.795f);
-	float XrotationDegrees = ROTATION_NONE;
-	float YrotationDegrees = ROTATION_NONE;
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(-5.0f, 1.095f + m_mugVerticalOffset, 1.0f);
-
-	// Apply transformations (Scale → Rotate → Translate)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-
-	// Render as solid color (no texture) to demonstrate color rendering technique
-	// Explicitly disable texture to avoid inheriting previous object's texture state
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("coffee");
-	SetShaderColor(COLOR_COFFEE_R, COLOR_COFFEE_G, COLOR_COFFEE_B, COLOR_ALPHA_OPAQUE);
-
-	// Draw cylinder with top cap (creates visible liquid surface)
-	m_basicMeshes->DrawCylinderMesh(true, false, true);  // top=true, bottom=false, sides=true
-
-	// Restore texture state for subsequent draws
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
-}
-
-/***********************************************************
- *  RenderMugHandle()
- *
- *  Renders mug handle as a vertical torus (donut shape)
- *  rotated 90° on Z-axis. Attached to right side of mug body.
- *
- *  ARTISTIC CHOICE: Pale plaster/wall texture provides light
- *  contrast against the darker marble body. This creates visual
- *  separation and hierarchy, drawing attention to the handle
- *  while maintaining cohesion through neutral tones.
- ***********************************************************/
-void SceneManager::RenderMugHandle()
-{
-	// Apply pale wall texture to handle
-	SetShaderTexture("pale_wall");
-	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
-	SetShaderMaterial("ceramic");
-
-	// Transformation parameters for handle torus
-	// Scale: 0.6 outer radius, 0.3 inner radius, 0.225 thickness
-	// Rotation Z: 90° rotates torus vertical (default torus is horizontal)
-	// Position: Right side of mug at X=-4.04 (mug center -5.0 + radius 0.9 + offset 0.06)
-	//           Mid-height at Y=2.16 for ergonomic placement
-	glm::vec3 scaleXYZ = glm::vec3(0.6f, 0.3f, 0.225f);
-	float XrotationDegrees = ROTATION_NONE;
-	float YrotationDegrees = ROTATION_NONE;
-	float ZrotationDegrees = ROTATION_QUARTER_TURN;  // Make torus vertical
-	glm::vec3 positionXYZ = glm::vec3(-4.04f, 2.16f + m_mugVerticalOffset, 1.0f);
-
-	// Apply transformations (Scale → Rotate → Translate)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-
-	// Draw the torus mesh
-	m_basicMeshes->DrawTorusMesh();
-}
-
-/***********************************************************
- *  RenderMugBase()
- *
- *  Renders mug base rim as a horizontal torus (donut shape)
- *  rotated 90° on X-axis. Forms decorative rim at bottom of mug.
- *
- *  ARTISTIC CHOICE: Industrial cracked cement provides visual
- *  weight and grounds the composition. The weathered, textured
- *  appearance adds character and contrasts with the smooth
- *  marble body, creating an eclectic artistic aesthetic.
- ***********************************************************/
-void SceneManager::RenderMugBase()
-{
-	// Apply cracked cement texture to base rim
-	SetShaderTexture("cement");
-	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
-	SetShaderMaterial("concrete");
-
-	// Transformation parameters for base rim torus
-	// Scale: 0.7125 outer radius (slightly smaller than mug body 0.9)
-	//        0.75 inner radius, creates thick rim appearance
-	// Rotation X: 90° makes torus horizontal (default is in XY plane)
-	// Position: Bottom of mug at Y=0.1875, same X,Z as mug body
-	glm::vec3 scaleXYZ = glm::vec3(0.7125f, 0.75f, 0.7125f);
-	float XrotationDegrees = ROTATION_QUARTER_TURN;  // Make torus horizontal
-	float YrotationDegrees = ROTATION_NONE;
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(-5.0f, 0.1875f, 1.0f);
-
-	// Apply transformations (Scale → Rotate → Translate)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-
-	// Draw the torus mesh
-	m_basicMeshes->DrawTorusMesh();
-}
-
-/***********************************************************
- *  RenderBlueSphere()
- *
- *  Renders blue rubber stress ball with partial texture
- *  mapping. This demonstrates the CS330 partial texture
- *  requirement by using UV coordinates < 1.0 to display
- *  only a portion of the texture image.
- *
- *  ARTISTIC CHOICE: Vibrant blue stress ball adds pop of
- *  color to the neutral workspace palette and reinforces
- *  the desk workspace theme. Positioned front-left to create
- *  visual balance and draw the eye.
- *
- *  CS330 REQUIREMENTS FULFILLED:
- *  - PARTIAL TEXTURE: UV scale 0.75x0.75 (displays upper-left 75%)
- ***********************************************************/
-void SceneManager::RenderBlueSphere()
-{
-	// Apply rubber coating texture with PARTIAL UV mapping (Complex Texturing Technique Requirement)
-	// UV scale < 1.0 displays only a portion of the texture
-	SetShaderTexture("rubber");
-	SetTextureUVScale(UV_SCALE_PARTIAL_TEXTURE, UV_SCALE_PARTIAL_TEXTURE);  // 0.75x0.75
-	SetShaderMaterial("rubber");
-
-	// Transformation parameters for stress ball
-	// Scale: 0.8 uniform (creates sphere with radius 0.8)
-	// Position: Front-left at (-5.5, 0.8, 3.5)
-	//   - Y=0.8 places sphere tangent to table surface (table top at Y=0.0, radius=0.8)
-	//   - X=-5.5 positions near mug for visual grouping
-	//   - Z=3.5 places forward for depth layering
-	glm::vec3 scaleXYZ = glm::vec3(0.8f, 0.8f, 0.8f);
-	float XrotationDegrees = ROTATION_NONE;
-	float YrotationDegrees = ROTATION_NONE;
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(-5.5f, 0.8f, 3.5f);
-
-	// Apply transformations (Scale → Rotate → Translate)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-
-	// Draw the sphere mesh
-	m_basicMeshes->DrawSphereMesh();
-}
-
-/***********************************************************
- *  RenderKeyboard()
- *
- *  Renders keyboard with realistic three-section layout:
- *  - Layer 1: Black plastic housing/frame
- *  - Layer 2: Three separate key sections (left main, middle nav, right numpad)
- *
- *  ARTISTIC CHOICE: Three-section layout mimics real keyboard design
- *  with visible gaps showing black frame underneath. Uses only 4 box
- *  primitives total while creating convincing keyboard appearance.
- ***********************************************************/
-void SceneManager::RenderKeyboard()
-{
-	// Layer 1: Black plastic keyboard frame/housing
-	// Using solid color rendering (no texture) for matte plastic appearance
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("plastic");
-	SetShaderColor(COLOR_BLACK_PLASTIC_R, COLOR_BLACK_PLASTIC_G, COLOR_BLACK_PLASTIC_B, COLOR_ALPHA_OPAQUE);
-
-	// Transformation parameters for keyboard base frame
-	// Scale: 9.0 wide x 0.10 thin x 3.0 deep (3:1 width:depth ratio)
-	// Position: Centered at X=0, forward at Z=4.0 (front-center of desk)
-	//   - Y=0.05 sits just above table surface (table top at Y=0.0)
-	glm::vec3 scaleXYZ = glm::vec3(9.0f, 0.10f, 3.0f);
-	float XrotationDegrees = ROTATION_NONE;
-	float YrotationDegrees = ROTATION_NONE;
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(0.0f, 0.05f, 4.0f);
-
-	// Apply transformations and draw frame
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Layer 2: Three separate key sections (raised above frame)
-	// Lighter grey color distinguishes keys from black frame
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("plastic");
-	SetShaderColor(COLOR_GREY_KEYS_R, COLOR_GREY_KEYS_G, COLOR_GREY_KEYS_B, COLOR_ALPHA_OPAQUE);
-
-	// Left section - Main keyboard area
-	// Largest section containing letter keys, numbers, and main function keys
-	scaleXYZ = glm::vec3(5.0f, 0.05f, 2.8f);  // 5.0 wide, very thin 0.05 height
-	positionXYZ = glm::vec3(-1.8f, 0.13f, 4.0f);  // Left side, raised to Y=0.13
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Middle section - Navigation/function area
-	// Home/End/Page keys and arrow cluster
-	scaleXYZ = glm::vec3(1.5f, 0.05f, 2.8f);  // Narrower than main area
-	positionXYZ = glm::vec3(1.75f, 0.13f, 4.0f);  // Gap creates visual separation
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Right section - Numpad area
-	// Number pad with calculator-style layout
-	scaleXYZ = glm::vec3(1.5f, 0.05f, 2.8f);  // Same size as middle section
-	positionXYZ = glm::vec3(3.55f, 0.13f, 4.0f);  // Equal gap from middle
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Restore texture state for subsequent textured draws
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
-}
-
-/***********************************************************
- *  RenderTouchpad()
- *
- *  Renders touchpad with two-layer flush design:
- *  - Layer 1: Black plastic frame/border
- *  - Layer 2: Grey touch surface (minimally raised)
- *
- *  ARTISTIC CHOICE: Square touchpad positioned right of
- *  keyboard creates balanced workspace composition. Flush
- *  surface design (vs raised keyboard keys) reflects realistic
- *  touchpad appearance. Uses only 2 box primitives for
- *  extremely low polygon count.
- ***********************************************************/
-void SceneManager::RenderTouchpad()
-{
-	// Layer 1: Black plastic touchpad frame/border
-	// Using solid color rendering (no texture) matching keyboard style
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("plastic");
-	SetShaderColor(COLOR_BLACK_PLASTIC_R, COLOR_BLACK_PLASTIC_G, COLOR_BLACK_PLASTIC_B, COLOR_ALPHA_OPAQUE);
-
-	// Transformation parameters for touchpad base frame
-	// Scale: 2.0x2.0 square (much smaller than keyboard)
-	// Position: Right of keyboard at X=6.0, same Z=4.0 and Y=0.05
-	glm::vec3 scaleXYZ = glm::vec3(2.0f, 0.10f, 2.0f);
-	float XrotationDegrees = ROTATION_NONE;
-	float YrotationDegrees = ROTATION_NONE;
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(6.0f, 0.05f, 4.0f);
-
-	// Apply transformations and draw frame
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Layer 2: Grey touch surface (minimally raised above frame)
-	// Slightly smaller than frame to expose border, creating realistic look
-	SetShaderMaterial("plastic");
-	SetShaderColor(COLOR_GREY_KEYS_R, COLOR_GREY_KEYS_G, COLOR_GREY_KEYS_B, COLOR_ALPHA_OPAQUE);
-
-	// Transformation parameters for touch surface
-	// Scale: 1.8x1.8 (0.2 smaller than 2.0 frame exposes 0.1 border on each side)
-	//        0.05 height (half the 0.10 frame height, creates subtle raised appearance)
-	// Position: Same X,Z as frame, raised to Y=0.08 (0.03 above frame top at Y=0.05+0.05=0.10 → 0.08 creates flush look)
-	scaleXYZ = glm::vec3(1.8f, 0.05f, 1.8f);
-	positionXYZ = glm::vec3(6.0f, 0.08f, 4.0f);
-
-	// Apply transformations and draw surface
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Restore texture state for subsequent textured draws
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
-}
-
-/***********************************************************
- *  RenderMonitor()
- *
- *  Renders complete flat screen monitor with stand by calling
- *  component render methods in proper sequence.
- *
- *  ARTISTIC CHOICE: Modern minimalist monitor design with
- *  central stand creates professional workspace aesthetic.
- *  Positioned behind keyboard as visual focal point.
- ***********************************************************/
-void SceneManager::RenderMonitor()
-{
-	RenderMonitorBase();
-	RenderMonitorPole();
-	RenderMonitorConnector();
-	RenderMonitorFrame();
-	RenderMonitorScreen();
-}
-
-/***********************************************************
- *  RenderMonitorBase()
- *
- *  Renders monitor stand base as flattened sphere.
- *
- *  ARTISTIC CHOICE: Flattened sphere creates modern, stable
- *  base design similar to contemporary monitor stands.
- ***********************************************************/
-void SceneManager::RenderMonitorBase()
-{
-	// Disable textures - using solid colors
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("plastic");
-	SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
-
-	// Set transformations for flattened sphere base
-	glm::vec3 scaleXYZ = glm::vec3(2.5f, 0.15f, 2.5f);  // Larger flattened sphere for stability with wider monitor
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ = glm::vec3(0.0f, 0.15f, -2.5f);  // Moved forward, behind mug
-
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawSphereMesh();
-
-	// Restore texture state
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetTextureUVScale(1.0f, 1.0f);
-}
-
-/***********************************************************
- *  RenderMonitorPole()
- *
- *  Renders monitor stand pole as tall thin rectangle.
- *
- *  ARTISTIC CHOICE: Thin rectangular pole provides minimal
- *  visual obstruction while supporting monitor display.
- ***********************************************************/
-void SceneManager::RenderMonitorPole()
-{
-	// Disable textures - using solid colors
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("plastic");
-	SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
-
-	// Set transformations for vertical rectangular pole
-	// Monitor bottom at Y=2.0, height=6.1875, so top at Y=8.1875
-	// Pole extends to 3/4 monitor height = 4.640625, so top at Y=6.640625
-	// Pole goes from Y=0.3 (base top) to Y=6.640625, height=6.340625, center at Y=3.4703125
-	glm::vec3 scaleXYZ = glm::vec3(0.5f, 6.340625f, 0.2f);  // Wide thin rectangle, extended for taller monitor
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ = glm::vec3(0.0f, 3.4703125f, -2.5f);  // Moved forward with base
-
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Restore texture state
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetTextureUVScale(1.0f, 1.0f);
-}
-
-/***********************************************************
- *  RenderMonitorConnector()
- *
- *  Renders connector as small horizontal cylinder bridging
- *  post to monitor back.
- *
- *  ARTISTIC CHOICE: Horizontal cylinder arm connects post
- *  to monitor center, parallel to desk surface.
- ***********************************************************/
-void SceneManager::RenderMonitorConnector()
-{
-	// Disable textures - using solid colors
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("plastic");
-	SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
-
-	// Set transformations for horizontal cylinder connector
-	// Connects post front to monitor back
-	// Cylinder rotated 90° on X-axis to make it horizontal (pointing in Z direction)
-	glm::vec3 scaleXYZ = glm::vec3(0.15f, 0.35f, 0.15f);  // Horizontal cylinder, length 0.35
-	float XrotationDegrees = 90.0f;  // Rotate to horizontal (point in Z direction)
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ = glm::vec3(0.0f, 5.09375f, -2.388f);  // Moved forward, aligned with monitor center height
-
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawCylinderMesh();
-
-	// Restore texture state
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetTextureUVScale(1.0f, 1.0f);
-}
-
-/***********************************************************
- *  RenderMonitorFrame()
- *
- *  Renders monitor outer frame/bezel as thin rectangle.
- *
- *  ARTISTIC CHOICE: Semi-gloss black frame with 16:9 aspect
- *  ratio creates realistic modern monitor appearance.
- ***********************************************************/
-void SceneManager::RenderMonitorFrame()
-{
-	// Disable textures - using solid colors
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("semi_gloss_plastic");
-	SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
-
-	// Set transformations for monitor frame
-	glm::vec3 scaleXYZ = glm::vec3(11.0f, 6.1875f, 0.3f);  // 16:9 aspect ratio, increased width
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ = glm::vec3(0.0f, 5.09375f, -2.05f);  // Moved forward: bottom at Y=2.0, top at Y=8.1875
-
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Restore texture state
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetTextureUVScale(1.0f, 1.0f);
-}
-
-/***********************************************************
- *  RenderMonitorScreen()
- *
- *  Renders monitor display screen as glossy black rectangle.
- *
- *  ARTISTIC CHOICE: Glossy black screen with high specular
- *  creates realistic powered-off LCD display appearance.
- ***********************************************************/
-void SceneManager::RenderMonitorScreen()
-{
-	// Disable textures - using solid colors
-	m_pShaderManager->setIntValue("bUseTexture", false);
-	SetShaderMaterial("screen");
-	SetShaderColor(0.02f, 0.02f, 0.02f, 1.0f);
-
-	// Set transformations for screen (slightly smaller than frame, inset)
-	glm::vec3 scaleXYZ = glm::vec3(10.6f, 5.8875f, 0.25f);  // Smaller than frame to create bezel
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ = glm::vec3(0.0f, 5.09375f, -2.0f);  // Moved forward, aligned with frame center, slightly forward
-
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-	m_basicMeshes->DrawBoxMesh();
-
-	// Restore texture state
-	m_pShaderManager->setIntValue("bUseTexture", true);
-	SetTextureUVScale(1.0f, 1.0f);
-}
-
-/***********************************************************
- *  RenderWall()
- *
- *  Renders background wall behind desk and monitor as a
- *  large vertical plane. Provides visual backdrop that
- *  enhances monitor visibility.
- *
- *  ARTISTIC CHOICE: Light-colored wall provides contrast
- *  for dark monitor, adds realism to workspace setting,
- *  and frames the scene with defined background boundary.
- ***********************************************************/
-void SceneManager::RenderWall()
-{
-	// Apply pale wall texture with 2x2 tiling for subtle texture detail
-	SetShaderTexture("pale_wall");
-	SetTextureUVScale(UV_SCALE_WALL_TEXTURE, UV_SCALE_WALL_TEXTURE);  // 2.0x2.0
-	SetShaderMaterial("wall");
-
-	// Transformation parameters for background wall
-	// Scale: 25.0 wide (wider than 20.0 table), 13.0 tall, 1.0 depth
-	// Position: Centered at X=0, far back at Z=-10, centered at Y=6.0
-	//   - With 13.0 height and center at Y=6.0, wall extends from Y=-0.5 to Y=12.5
-	//   - Positioned at back edge of table, behind all scene objects
-	glm::vec3 scaleXYZ = glm::vec3(25.0f, 13.0f, 1.0f);
-	float XrotationDegrees = ROTATION_NONE;
-	float YrotationDegrees = ROTATION_NONE;
-	float ZrotationDegrees = ROTATION_NONE;
-	glm::vec3 positionXYZ = glm::vec3(0.0f, 6.0f, -10.0f);
-
-	// Apply transformations (Scale → Rotate → Translate)
-	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
-		ZrotationDegrees, positionXYZ);
-
-	// Draw the box mesh (forms wall plane)
-	m_basicMeshes->DrawBoxMesh();
-}
+﻿///////////////////////////////////////////////////////////////////////////////
+// shadermanager.cpp
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+#include "TextureAtlas.h"
+#include "TextureLoader.h"
+#include "Trace.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <thread>
+
+// declaration of global variables and constants
+namespace
+{
+	// UV Scale Constants - Complex Texturing Technique Requirements
+	const float UV_SCALE_TILED_TEXTURE = 6.0f;      // Table oak wood (tiled - CS330 requirement)
+	const float UV_SCALE_PARTIAL_TEXTURE = 0.75f;   // Sphere rubber (partial - CS330 requirement)
+	const float UV_SCALE_WALL_TEXTURE = 2.0f;       // Background wall
+	const float UV_SCALE_MUG_BODY_U = 2.0f;         // Mug body horizontal wrap
+	const float UV_SCALE_MUG_BODY_V = 1.0f;         // Mug body vertical
+	const float UV_SCALE_DEFAULT = 1.0f;            // Standard 1:1 mapping
+
+	// Color Constants
+	const float COLOR_BLACK_PLASTIC_R = 0.08f;
+	const float COLOR_BLACK_PLASTIC_G = 0.08f;
+	const float COLOR_BLACK_PLASTIC_B = 0.08f;
+	const float COLOR_GREY_KEYS_R = 0.25f;
+	const float COLOR_GREY_KEYS_G = 0.25f;
+	const float COLOR_GREY_KEYS_B = 0.25f;
+	const float COLOR_COFFEE_R = 0.32f;
+	const float COLOR_COFFEE_G = 0.20f;
+	const float COLOR_COFFEE_B = 0.10f;
+	const float COLOR_SCREEN_R = 0.02f;
+	const float COLOR_SCREEN_G = 0.02f;
+	const float COLOR_SCREEN_B = 0.02f;
+	const float COLOR_ALPHA_OPAQUE = 1.0f;
+
+	// directory of the compressed texture cache, relative to the working directory
+	const char* const TEXTURE_CACHE_DIRECTORY = "texture_cache";
+	// width and height of the atlas that small textures are packed into
+	const int TEXTURE_ATLAS_SIZE = 1024;
+	// texture unit of the first texture array; unit 0 stays with the
+	// objectTexture sampler2D, so samplers of different types that a
+	// shader declares side by side never share a unit
+	const int TEXTURE_ARRAY_FIRST_UNIT = 1;
+	// staging memory for streamed textures, enough for two 2048x2048 RGBA images
+	const size_t TEXTURE_STREAMING_SIZE = 32 * 1024 * 1024;
+
+	// projected bounding sphere diameter, as a fraction of the screen
+	// height, below which a draw switches to the next coarser level
+	const float LOD_SCREEN_SIZES[InstancedMeshes::LOD_COUNT - 1] = { 0.12f, 0.04f };
+	// fraction a size must pass a threshold by before the level
+	// changes, so objects near a threshold do not pop back and forth
+	const float LOD_HYSTERESIS = 0.15f;
+
+	// GPU timing scopes: one per render group, then the passes
+	// that do not belong to a group
+	const int GPU_SCOPE_DEPTH_PREPASS = SceneManager::GROUP_COUNT;
+	const int GPU_SCOPE_OCCLUSION = SceneManager::GROUP_COUNT + 1;
+	const int GPU_SCOPE_COUNT = SceneManager::GROUP_COUNT + 2;
+	const char* const GPU_SCOPE_NAMES[GPU_SCOPE_COUNT] =
+	{
+		"wall", "table", "mug", "sphere", "keyboard", "touchpad", "monitor",
+		"depth_prepass", "occlusion_queries"
+	};
+
+	// Transformation rotation constants
+	const float ROTATION_NONE = 0.0f;
+	const float ROTATION_QUARTER_TURN = 90.0f;
+	const float ROTATION_MUG_SEAM = 25.0f;  // Rotates marble seam away from camera
+
+	// std140 layout of one LightSource entry in the LightBlock uniform block
+	struct LIGHT_STD140
+	{
+		glm::vec3 position;
+		float padding0;
+		glm::vec3 ambientColor;
+		float padding1;
+		glm::vec3 diffuseColor;
+		float padding2;
+		glm::vec3 specularColor;
+		float focalStrength;       // packs into the last vec3's padding
+		float specularIntensity;
+		float padding3[3];         // array stride rounds up to 16 bytes
+	};
+	static_assert(sizeof(LIGHT_STD140) == 80, "LIGHT_STD140 must match the std140 array stride");
+
+	// std140 layout of one Material entry in the MaterialBlock uniform block
+	struct MATERIAL_STD140
+	{
+		glm::vec3 ambientColor;
+		float ambientStrength;
+		glm::vec3 diffuseColor;
+		float padding0;
+		glm::vec3 specularColor;
+		float shininess;
+	};
+	static_assert(sizeof(MATERIAL_STD140) == 48, "MATERIAL_STD140 must match the std140 array stride");
+
+	// scene files store meshes, groups and cylinder parts by value
+	static_assert(SceneFile::MESH_COUNT == SceneManager::MESH_TORUS + 1, "scene file meshes must match SHAPE_MESH");
+	static_assert(SceneFile::GROUP_COUNT == SceneManager::GROUP_COUNT, "scene file groups must match RENDER_GROUP");
+	static_assert(SceneFile::PARTS_ALL == SceneManager::CYLINDER_ALL, "scene file parts must match CYLINDER_PARTS");
+
+	/**
+	 * @brief Builds the 64-bit sort key of a draw so that sorting groups
+	 *        draws by program, then texture, then material, then mesh
+	 * @param draw The draw record to build the key for
+	 * @param bMeshBeforeMaterial Group by mesh before material, for when
+	 *        the material is a per-instance value rather than shader state
+	 * @return The sort key (lower keys draw first)
+	 */
+	uint64_t MakeSortKey(const SceneManager::DRAW_RECORD& draw, bool bMeshBeforeMaterial)
+	{
+		const uint64_t program = 0;  // single scene shader program
+		const uint64_t texture = draw.bUseTexture ? static_cast<uint64_t>(draw.texture + 1) : 0;
+		const uint64_t material = static_cast<uint64_t>(draw.material + 1);
+		const uint64_t mesh = (static_cast<uint64_t>(draw.mesh) << 8) | draw.meshParts;
+
+		if (bMeshBeforeMaterial)
+		{
+			return (program << 56) | ((texture & 0xFFFF) << 40) | ((mesh & 0xFFFF) << 24) | (material & 0xFFFFFF);
+		}
+		return (program << 56) | ((texture & 0xFFFF) << 40) | ((material & 0xFFFF) << 24) | (mesh & 0xFFFFFF);
+	}
+
+	/**
+	 * @brief Tests whether two instanced draws use the same shader state,
+	 *        so that they can be issued by one multi-draw call
+	 * @param a The first draw
+	 * @param b The second draw
+	 * @param bMaterialPerInstance True if materials come from the material
+	 *        table, so the draws may use different materials
+	 * @return True if only per-instance values and geometry differ
+	 */
+	bool SharesBatchState(const SceneManager::DRAW_RECORD& a, const SceneManager::DRAW_RECORD& b, bool bMaterialPerInstance)
+	{
+		if (a.bUseTexture != b.bUseTexture)
+		{
+			return false;
+		}
+		if (a.bUseTexture && ((a.texture != b.texture) || (a.uvScale != b.uvScale) || (a.uvOffset != b.uvOffset)))
+		{
+			return false;
+		}
+		return bMaterialPerInstance || (a.material == b.material);
+	}
+
+	/**
+	 * @brief Tests whether two draws can be drawn as instances of one
+	 *        instanced draw call
+	 * @param a The first draw of the batch
+	 * @param b The draw to add to the batch
+	 * @param bMaterialPerInstance True if materials come from the material
+	 *        table, so the batch may mix materials
+	 * @return True if only per-instance values differ
+	 */
+	bool CanShareBatch(const SceneManager::DRAW_RECORD& a, const SceneManager::DRAW_RECORD& b, bool bMaterialPerInstance)
+	{
+		return (a.mesh == b.mesh) && (a.meshParts == b.meshParts) && SharesBatchState(a, b, bMaterialPerInstance);
+	}
+
+	/**
+	 * @brief Gets the object-space bounding box of a scene mesh, matching
+	 *        the dimensions the meshes are generated with
+	 * @param mesh The scene mesh
+	 * @param minimum Receives the lowest corner of the box
+	 * @param maximum Receives the highest corner of the box
+	 */
+	void GetMeshBounds(SceneManager::SHAPE_MESH mesh, glm::vec3& minimum, glm::vec3& maximum)
+	{
+		switch (mesh)
+		{
+		case SceneManager::MESH_BOX:
+			minimum = glm::vec3(-0.5f);
+			maximum = glm::vec3(0.5f);
+			break;
+		case SceneManager::MESH_PLANE:
+			minimum = glm::vec3(-1.0f, 0.0f, -1.0f);
+			maximum = glm::vec3(1.0f, 0.0f, 1.0f);
+			break;
+		case SceneManager::MESH_CONE:
+		case SceneManager::MESH_CYLINDER:
+			minimum = glm::vec3(-1.0f, 0.0f, -1.0f);
+			maximum = glm::vec3(1.0f, 1.0f, 1.0f);
+			break;
+		case SceneManager::MESH_SPHERE:
+			minimum = glm::vec3(-1.0f);
+			maximum = glm::vec3(1.0f);
+			break;
+		case SceneManager::MESH_TORUS:
+			// ring of radius 1 in the XY plane with a 0.1 tube
+			minimum = glm::vec3(-1.1f, -1.1f, -0.1f);
+			maximum = glm::vec3(1.1f, 1.1f, 0.1f);
+			break;
+		}
+	}
+
+	/**
+	 * @brief Selects the level of detail for a projected object size,
+	 *        leaving the current level only once the size is clearly
+	 *        past a threshold
+	 * @param screenSize Projected diameter as a fraction of the screen height
+	 * @param currentLod The level drawn last frame
+	 * @return The level to draw
+	 */
+	int SelectLod(float screenSize, int currentLod)
+	{
+		int lod = currentLod;
+		while ((lod > 0) && (screenSize > LOD_SCREEN_SIZES[lod - 1] * (1.0f + LOD_HYSTERESIS)))
+		{
+			lod--;
+		}
+		while ((lod < InstancedMeshes::LOD_COUNT - 1) && (screenSize < LOD_SCREEN_SIZES[lod] * (1.0f - LOD_HYSTERESIS)))
+		{
+			lod++;
+		}
+		return lod;
+	}
+
+	/**
+	 * @brief Maps a scene mesh to its shape in the instanced meshes
+	 * @param mesh The scene mesh
+	 * @return The matching shape of the shared geometry buffers
+	 */
+	InstancedMeshes::SHAPE ToInstancedShape(SceneManager::SHAPE_MESH mesh)
+	{
+		switch (mesh)
+		{
+		case SceneManager::MESH_BOX:
+			return InstancedMeshes::SHAPE_BOX;
+		case SceneManager::MESH_CONE:
+			return InstancedMeshes::SHAPE_CONE;
+		case SceneManager::MESH_CYLINDER:
+			return InstancedMeshes::SHAPE_CYLINDER;
+		case SceneManager::MESH_PLANE:
+			return InstancedMeshes::SHAPE_PLANE;
+		case SceneManager::MESH_SPHERE:
+			return InstancedMeshes::SHAPE_SPHERE;
+		case SceneManager::MESH_TORUS:
+		default:
+			return InstancedMeshes::SHAPE_TORUS;
+		}
+	}
+
+	/**
+	 * @brief Builds the instance buffer entry of a draw
+	 * @param draw The draw record to build the entry for
+	 * @return The per-instance values of the draw
+	 */
+	InstancedMeshes::INSTANCE_DATA MakeInstance(const SceneManager::DRAW_RECORD& draw)
+	{
+		InstancedMeshes::INSTANCE_DATA instance;
+		instance.model = draw.model;
+		instance.color = draw.color;
+		instance.materialIndex = std::max(draw.material, 0);
+		return instance;
+	}
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager *pShaderManager)
+	: m_textureCache(TEXTURE_CACHE_DIRECTORY)
+{
+	m_pShaderManager = pShaderManager;
+	m_pUniforms = nullptr;
+	m_basicMeshes = new ShapeMeshes();
+	m_instancedMeshes = nullptr;
+	m_bInstancing = false;
+	m_textureBinding = TEXTURE_BIND_ON_CHANGE;
+	m_pendingTextureRegion = -1;
+	m_textureStreamer = nullptr;
+	m_lightsUBO = 0;
+	m_bLightsDirty = true;
+	m_materialsUBO = 0;
+	m_bMaterialTable = false;
+	m_activeMaterial = -1;
+	m_frameStats = FRAME_STATS();
+	m_pendingDraw = DRAW_RECORD();
+	// no texture is selected until the first draw
+	m_appliedDraw = DRAW_RECORD();
+	m_appliedDraw.texture = -1;
+	m_projectionScale = 0.0f;
+	m_bFrustumValid = false;
+	m_targetFramebuffer = 0;
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+	m_occlusionQueries = nullptr;
+	m_bDepthPrepass = false;
+	m_fragmentQuery = 0;
+	m_bFragmentQueryPending = false;
+	m_shadedFragments = 0;
+	m_debugView = DebugViews::VIEW_SHADED;
+	m_debugViews = nullptr;
+	m_bDebugViewsReady = false;
+	m_gpuTimers = nullptr;
+	m_sceneFile = nullptr;
+	m_sceneExport = nullptr;
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	m_pShaderManager = NULL;
+	m_pUniforms = nullptr;
+	if (0 != m_lightsUBO)
+	{
+		glDeleteBuffers(1, &m_lightsUBO);
+		m_lightsUBO = 0;
+	}
+	if (0 != m_materialsUBO)
+	{
+		glDeleteBuffers(1, &m_materialsUBO);
+		m_materialsUBO = 0;
+	}
+	delete m_basicMeshes;
+	m_basicMeshes = NULL;
+	delete m_instancedMeshes;
+	m_instancedMeshes = nullptr;
+	delete m_textureStreamer;
+	m_textureStreamer = nullptr;
+	delete m_occlusionQueries;
+	m_occlusionQueries = nullptr;
+	if (0 != m_fragmentQuery)
+	{
+		glDeleteQueries(1, &m_fragmentQuery);
+		m_fragmentQuery = 0;
+	}
+	delete m_debugViews;
+	m_debugViews = nullptr;
+	delete m_gpuTimers;
+	m_gpuTimers = nullptr;
+	delete m_sceneFile;
+	m_sceneFile = nullptr;
+	DestroyGLTextures();
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for loading textures from image files,
+ *  configuring the texture mapping parameters in OpenGL,
+ *  generating the mipmaps, and loading the read texture into
+ *  the next available texture slot in memory.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, const std::string& tag)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// a cached compressed copy needs no decoding or mipmap generation
+	GLuint cachedID = m_textureCache.Load(filename);
+	if (0 != cachedID)
+	{
+		RegisterGLTexture(cachedID, tag);
+		return true;
+	}
+
+	// indicate to always flip images vertically when loaded
+	stbi_set_flip_vertically_on_load(true);
+
+	// try to parse the image data from the specified image file
+	unsigned char* image = stbi_load(
+		filename,
+		&width,
+		&height,
+		&colorChannels,
+		0);
+
+	// if the image was successfully read from the image file
+	if (image)
+	{
+		bool bCreated = CreateGLTextureFromImage(filename, tag, image, width, height, colorChannels);
+
+		// free the image data from local memory
+		stbi_image_free(image);
+		return bCreated;
+	}
+
+	std::cout << "Could not load image:" << filename << std::endl;
+
+	// Error loading the image
+	return false;
+}
+
+/***********************************************************
+ *  CreateGLTextureFromImage()
+ *
+ *  This method is used for creating an OpenGL texture, with
+ *  its mapping parameters and mipmaps, from already decoded
+ *  image pixels and loading it into the next available
+ *  texture slot in memory.
+ ***********************************************************/
+bool SceneManager::CreateGLTextureFromImage(
+	const char* filename,
+	const std::string& tag,
+	const unsigned char* image,
+	int width,
+	int height,
+	int colorChannels)
+{
+	GLuint textureID = 0;
+
+	std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
+
+	// check the format before creating anything
+	if ((colorChannels != 3) && (colorChannels != 4))
+	{
+		std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
+		return false;
+	}
+
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// if the loaded image is in RGB format
+	if (colorChannels == 3)
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
+	// if the loaded image is in RGBA format - it supports transparency
+	else
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
+
+	// generate the texture mipmaps for mapping textures to lower resolutions
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+
+	// swap in a compressed copy, which is also cached for the next run
+	GLuint compressedID = m_textureCache.Transcode(filename, textureID, colorChannels);
+	if (0 != compressedID)
+	{
+		glDeleteTextures(1, &textureID);
+		textureID = compressedID;
+	}
+
+	RegisterGLTexture(textureID, tag);
+
+	return true;
+}
+
+/***********************************************************
+ *  RegisterGLTexture()
+ *
+ *  This method registers a created texture in the next
+ *  available texture slot, associates it with the passed in
+ *  tag string, and adds a texture region covering all of it.
+ *  Returns the texture slot.
+ ***********************************************************/
+int SceneManager::RegisterGLTexture(GLuint textureID, const std::string& tag)
+{
+	TEXTURE_INFO texture;
+	texture.tag = tag;
+	texture.ID = textureID;
+	texture.arrayIndex = -1;
+	texture.layer = 0;
+	texture.handle = 0;
+	m_textureIDs.push_back(texture);
+
+	TEXTURE_REGION region;
+	region.tag = tag;
+	region.slot = static_cast<int>(m_textureIDs.size()) - 1;
+	region.uvOffset = glm::vec2(0.0f);
+	region.uvScale = glm::vec2(1.0f);
+	m_textureRegions.push_back(region);
+
+	return region.slot;
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for preparing the loaded textures to
+ *  be selected by slot. Depending on what the shader declares
+ *  and the context supports, the textures are packed into
+ *  texture arrays, made resident as bindless handles, or
+ *  bound to texture unit 0 whenever the selection changes.
+ *  None of these limits the number of textures.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	if ((nullptr != m_pUniforms) && CreateTextureArrays())
+	{
+		m_textureBinding = TEXTURE_ARRAYS;
+	}
+	else if ((nullptr != m_pUniforms) && CreateBindlessHandles())
+	{
+		m_textureBinding = TEXTURE_BINDLESS;
+	}
+	else
+	{
+		// every texture is sampled through texture unit 0
+		m_textureBinding = TEXTURE_BIND_ON_CHANGE;
+		glActiveTexture(GL_TEXTURE0);
+		if (nullptr != m_pUniforms)
+		{
+			m_stateCache.SetInt(m_pUniforms->objectTexture, 0);
+		}
+	}
+}
+
+/***********************************************************
+ *  CreateTextureArrays()
+ *
+ *  This method copies the loaded textures into texture
+ *  arrays, one per distinct size and format, with
+ *  glCopyImageSubData(), then deletes the separate textures.
+ *  Each array stays bound to its own texture unit, from
+ *  TEXTURE_ARRAY_FIRST_UNIT on, so a draw selects its texture
+ *  with the array and layer uniforms.
+ *  Returns false if the shader has no array sampler or the
+ *  context cannot copy images.
+ ***********************************************************/
+bool SceneManager::CreateTextureArrays()
+{
+	if ((m_pUniforms->objectTextureArray < 0) || (m_pUniforms->textureLayer < 0) ||
+		!(GLEW_VERSION_4_3 || GLEW_ARB_copy_image) || m_textureIDs.empty())
+	{
+		return false;
+	}
+
+	// size and format shared by all layers of one array
+	struct ARRAY_FORMAT
+	{
+		GLint internalFormat;
+		GLint width;
+		GLint height;
+		GLint levels;
+		std::vector<int> slots;
+	};
+	std::vector<ARRAY_FORMAT> formats;
+
+	for (int slot = 0; slot < static_cast<int>(m_textureIDs.size()); slot++)
+	{
+		ARRAY_FORMAT format;
+		glBindTexture(GL_TEXTURE_2D, m_textureIDs[slot].ID);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &format.internalFormat);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &format.width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &format.height);
+		// scene textures have a complete mip chain; the atlas stops early
+		GLint maxLevel = 0;
+		glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+		format.levels = 1;
+		while (((std::max(format.width, format.height) >> format.levels) > 0) && (format.levels <= maxLevel))
+		{
+			format.levels++;
+		}
+
+		auto match = std::find_if(formats.begin(), formats.end(), [&format](const ARRAY_FORMAT& other)
+		{
+			return (other.internalFormat == format.internalFormat) && (other.levels == format.levels) &&
+				(other.width == format.width) && (other.height == format.height);
+		});
+		if (match == formats.end())
+		{
+			format.slots.push_back(slot);
+			formats.push_back(format);
+		}
+		else
+		{
+			match->slots.push_back(slot);
+		}
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	GLint maxUnits = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+	if (TEXTURE_ARRAY_FIRST_UNIT + static_cast<GLint>(formats.size()) > maxUnits)
+	{
+		return false;
+	}
+
+	for (int arrayIndex = 0; arrayIndex < static_cast<int>(formats.size()); arrayIndex++)
+	{
+		const ARRAY_FORMAT& format = formats[arrayIndex];
+		const GLsizei layers = static_cast<GLsizei>(format.slots.size());
+
+		GLuint arrayID = 0;
+		glGenTextures(1, &arrayID);
+		glActiveTexture(GL_TEXTURE0 + TEXTURE_ARRAY_FIRST_UNIT + arrayIndex);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, arrayID);
+		glTexStorage3D(GL_TEXTURE_2D_ARRAY, format.levels, format.internalFormat, format.width, format.height, layers);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+		for (GLsizei layer = 0; layer < layers; layer++)
+		{
+			TEXTURE_INFO& texture = m_textureIDs[format.slots[layer]];
+			for (GLint level = 0; level < format.levels; level++)
+			{
+				glCopyImageSubData(
+					texture.ID, GL_TEXTURE_2D, level, 0, 0, 0,
+					arrayID, GL_TEXTURE_2D_ARRAY, level, 0, 0, layer,
+					std::max(1, format.width >> level), std::max(1, format.height >> level), 1);
+			}
+
+			// the array layer replaces the separate texture
+			glDeleteTextures(1, &texture.ID);
+			texture.ID = 0;
+			texture.arrayIndex = arrayIndex;
+			texture.layer = layer;
+		}
+
+		m_textureArrays.push_back(arrayID);
+	}
+	glActiveTexture(GL_TEXTURE0);
+
+	std::cout << "Packed " << m_textureIDs.size() << " textures into "
+		<< m_textureArrays.size() << " texture arrays" << std::endl;
+	return true;
+}
+
+/***********************************************************
+ *  CreateBindlessHandles()
+ *
+ *  This method makes every loaded texture resident behind a
+ *  bindless handle, which a draw passes to the shader by
+ *  uniform. Returns false if the shader has no bindless
+ *  sampler or the context lacks ARB_bindless_texture.
+ ***********************************************************/
+bool SceneManager::CreateBindlessHandles()
+{
+	if ((m_pUniforms->objectTextureHandle < 0) || !GLEW_ARB_bindless_texture)
+	{
+		return false;
+	}
+
+	for (TEXTURE_INFO& texture : m_textureIDs)
+	{
+		texture.handle = glGetTextureHandleARB(texture.ID);
+		glMakeTextureHandleResidentARB(texture.handle);
+	}
+	return true;
+}
+
+/***********************************************************
+ *  SelectTexture()
+ *
+ *  This method makes the texture in the passed in slot the
+ *  one sampled by the next draw, and returns the number of
+ *  handle writes this took. Other uniform writes and texture
+ *  binds are counted by the state cache.
+ ***********************************************************/
+int SceneManager::SelectTexture(int textureSlot)
+{
+	if ((textureSlot < 0) || (textureSlot >= static_cast<int>(m_textureIDs.size())))
+	{
+		return 0;
+	}
+
+	const TEXTURE_INFO& texture = m_textureIDs[textureSlot];
+	int uploads = 0;
+
+	switch (m_textureBinding)
+	{
+	case TEXTURE_ARRAYS:
+		// each array stays bound to its own unit
+		m_stateCache.SetInt(m_pUniforms->objectTextureArray, TEXTURE_ARRAY_FIRST_UNIT + texture.arrayIndex);
+		m_stateCache.SetInt(m_pUniforms->textureLayer, texture.layer);
+		break;
+	case TEXTURE_BINDLESS:
+		glUniformHandleui64ARB(m_pUniforms->objectTextureHandle, texture.handle);
+		uploads++;
+		break;
+	case TEXTURE_BIND_ON_CHANGE:
+		m_stateCache.BindTexture(GL_TEXTURE_2D, texture.ID);
+		break;
+	}
+	return uploads;
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory in all the
+ *  used texture memory slots.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	for (TEXTURE_INFO& texture : m_textureIDs)
+	{
+		if (0 != texture.handle)
+		{
+			glMakeTextureHandleNonResidentARB(texture.handle);
+		}
+		if (0 != texture.ID)
+		{
+			glDeleteTextures(1, &texture.ID);
+		}
+	}
+	m_textureIDs.clear();
+	m_textureRegions.clear();
+
+	if (!m_textureArrays.empty())
+	{
+		glDeleteTextures(static_cast<GLsizei>(m_textureArrays.size()), m_textureArrays.data());
+		m_textureArrays.clear();
+	}
+}
+
+/***********************************************************
+ *  StreamTexture()
+ *
+ *  This method queues the passed in image file to replace
+ *  the texture with the passed in tag. The file is decoded
+ *  and uploaded through the texture streamer while the scene
+ *  keeps rendering, and the texture is swapped in by the
+ *  first frame after its upload has completed. Returns false
+ *  if streaming is not supported or no texture is tagged.
+ ***********************************************************/
+bool SceneManager::StreamTexture(const std::string& tag, const std::string& filename)
+{
+	if (FindTextureRegion(tag) < 0)
+	{
+		std::cout << "Could not stream texture, no texture is tagged:" << tag << std::endl;
+		return false;
+	}
+	if (!TextureStreamer::IsSupported())
+	{
+		std::cout << "Could not stream texture, buffer storage is not supported:" << filename << std::endl;
+		return false;
+	}
+
+	if (nullptr == m_textureStreamer)
+	{
+		m_textureStreamer = new TextureStreamer(TEXTURE_STREAMING_SIZE, 1);
+	}
+	m_textureStreamer->Request(filename, tag);
+	return true;
+}
+
+/***********************************************************
+ *  UpdateTextureStreaming()
+ *
+ *  This method lets the texture streamer start and retire
+ *  uploads, then swaps in every replacement texture that is
+ *  ready. It never waits for the GPU. An image packed into
+ *  the atlas shares its texture with the other atlas images,
+ *  so its replacement gets a slot of its own instead.
+ ***********************************************************/
+void SceneManager::UpdateTextureStreaming()
+{
+	TRACE_SCOPE("UpdateTextureStreaming");
+
+	if ((nullptr == m_textureStreamer) || (0 == m_textureStreamer->GetPendingCount()))
+	{
+		return;
+	}
+
+	m_textureStreamer->Update();
+	// uploads change the GL_TEXTURE_2D binding, so select the texture again
+	m_appliedDraw.texture = -1;
+
+	TextureStreamer::STREAMED_TEXTURE streamed;
+	while (m_textureStreamer->PollReady(streamed))
+	{
+		const int region = FindTextureRegion(streamed.tag);
+		bool bSwapped = false;
+		if ((0 != streamed.textureID) && (region >= 0))
+		{
+			const TEXTURE_REGION& textureRegion = m_textureRegions[region];
+			if ((textureRegion.uvScale == glm::vec2(1.0f)) && (textureRegion.uvOffset == glm::vec2(0.0f)))
+			{
+				bSwapped = ReplaceGLTexture(textureRegion.slot, streamed.textureID);
+			}
+			else
+			{
+				const int textureSlot = RegisterStreamedTexture(streamed.textureID, streamed.tag);
+				if (textureSlot >= 0)
+				{
+					RepointTextureRegion(region, textureSlot);
+					bSwapped = true;
+				}
+			}
+		}
+
+		if (!bSwapped)
+		{
+			std::cout << "Could not swap in streamed texture:" << streamed.tag << std::endl;
+			if (0 != streamed.textureID)
+			{
+				glDeleteTextures(1, &streamed.textureID);
+			}
+		}
+		else
+		{
+			std::cout << "Swapped in streamed texture:" << streamed.tag << std::endl;
+		}
+	}
+}
+
+/***********************************************************
+ *  ReplaceGLTexture()
+ *
+ *  This method makes the passed in texture the one selected
+ *  by a texture slot and frees the texture it replaces. With
+ *  texture arrays the new texture is copied into the slot's
+ *  layer if it has the same size, format and mip count, and
+ *  otherwise gets an array of its own (streamed textures are
+ *  RGBA8, while the arrays hold RGB8 or compressed layers).
+ *  Returns false, leaving the slot unchanged, if the texture
+ *  cannot be used there.
+ ***********************************************************/
+bool SceneManager::ReplaceGLTexture(int textureSlot, GLuint textureID)
+{
+	TEXTURE_INFO& texture = m_textureIDs[textureSlot];
+
+	switch (m_textureBinding)
+	{
+	case TEXTURE_ARRAYS:
+	{
+		GLint internalFormat = 0;
+		GLint width = 0;
+		GLint height = 0;
+		GLint levels = 0;
+		// each array stays bound to its own unit
+		glActiveTexture(GL_TEXTURE0 + TEXTURE_ARRAY_FIRST_UNIT + texture.arrayIndex);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, m_textureArrays[texture.arrayIndex]);
+		glGetTexParameteriv(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_WIDTH, &width);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D_ARRAY, 0, GL_TEXTURE_HEIGHT, &height);
+		glActiveTexture(GL_TEXTURE0);
+
+		GLint newFormat = 0;
+		GLint newWidth = 0;
+		GLint newHeight = 0;
+		GLint newLevels = 0;
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_LEVELS, &newLevels);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &newFormat);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &newWidth);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &newHeight);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		if ((newFormat != internalFormat) || (newWidth != width) || (newHeight != height) || (newLevels < levels))
+		{
+			// the old layer is left unused
+			return AddTextureArray(textureSlot, textureID);
+		}
+		for (GLint level = 0; level < levels; level++)
+		{
+			glCopyImageSubData(
+				textureID, GL_TEXTURE_2D, level, 0, 0, 0,
+				m_textureArrays[texture.arrayIndex], GL_TEXTURE_2D_ARRAY, level, 0, 0, texture.layer,
+				std::max(1, width >> level), std::max(1, height >> level), 1);
+		}
+		glDeleteTextures(1, &textureID);
+		return true;
+	}
+	case TEXTURE_BINDLESS:
+		glMakeTextureHandleNonResidentARB(texture.handle);
+		glDeleteTextures(1, &texture.ID);
+		texture.ID = textureID;
+		texture.handle = glGetTextureHandleARB(texture.ID);
+		glMakeTextureHandleResidentARB(texture.handle);
+		break;
+	case TEXTURE_BIND_ON_CHANGE:
+		glDeleteTextures(1, &texture.ID);
+		texture.ID = textureID;
+		break;
+	}
+
+	// make the next draw using the slot select it again
+	if (m_appliedDraw.texture == textureSlot)
+	{
+		m_appliedDraw.texture = -1;
+	}
+	return true;
+}
+
+/***********************************************************
+ *  AddTextureArray()
+ *
+ *  This method copies the passed in texture into a new
+ *  texture array of one layer, bound to the next free unit,
+ *  and makes the passed in slot select that layer. The
+ *  texture is freed. Returns false, leaving the slot and the
+ *  texture unchanged, if no texture unit is left.
+ ***********************************************************/
+bool SceneManager::AddTextureArray(int textureSlot, GLuint textureID)
+{
+	const int arrayIndex = static_cast<int>(m_textureArrays.size());
+	GLint maxUnits = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+	if (TEXTURE_ARRAY_FIRST_UNIT + arrayIndex >= maxUnits)
+	{
+		return false;
+	}
+
+	GLint internalFormat = 0;
+	GLint width = 0;
+	GLint height = 0;
+	GLint levels = 0;
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_IMMUTABLE_LEVELS, &levels);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &internalFormat);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	levels = std::max(levels, 1);
+
+	GLuint arrayID = 0;
+	glGenTextures(1, &arrayID);
+	glActiveTexture(GL_TEXTURE0 + TEXTURE_ARRAY_FIRST_UNIT + arrayIndex);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, arrayID);
+	glTexStorage3D(GL_TEXTURE_2D_ARRAY, levels, internalFormat, width, height, 1);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glActiveTexture(GL_TEXTURE0);
+
+	for (GLint level = 0; level < levels; level++)
+	{
+		glCopyImageSubData(
+			textureID, GL_TEXTURE_2D, level, 0, 0, 0,
+			arrayID, GL_TEXTURE_2D_ARRAY, level, 0, 0, 0,
+			std::max(1, width >> level), std::max(1, height >> level), 1);
+	}
+	glDeleteTextures(1, &textureID);
+	m_textureArrays.push_back(arrayID);
+
+	TEXTURE_INFO& texture = m_textureIDs[textureSlot];
+	texture.ID = 0;
+	texture.arrayIndex = arrayIndex;
+	texture.layer = 0;
+	return true;
+}
+
+/***********************************************************
+ *  RegisterStreamedTexture()
+ *
+ *  This method adds a streamed texture in the next texture
+ *  slot, made selectable the way the other slots are. No
+ *  texture region is added; see RepointTextureRegion().
+ *  Returns the texture slot, or -1 if the texture could not
+ *  be added and is still owned by the caller.
+ ***********************************************************/
+int SceneManager::RegisterStreamedTexture(GLuint textureID, const std::string& tag)
+{
+	TEXTURE_INFO texture;
+	texture.tag = tag;
+	texture.ID = textureID;
+	texture.arrayIndex = -1;
+	texture.layer = 0;
+	texture.handle = 0;
+	m_textureIDs.push_back(texture);
+	const int textureSlot = static_cast<int>(m_textureIDs.size()) - 1;
+
+	switch (m_textureBinding)
+	{
+	case TEXTURE_ARRAYS:
+		if (!AddTextureArray(textureSlot, textureID))
+		{
+			m_textureIDs.pop_back();
+			return -1;
+		}
+		break;
+	case TEXTURE_BINDLESS:
+		m_textureIDs[textureSlot].handle = glGetTextureHandleARB(textureID);
+		glMakeTextureHandleResidentARB(m_textureIDs[textureSlot].handle);
+		break;
+	case TEXTURE_BIND_ON_CHANGE:
+		break;
+	}
+	return textureSlot;
+}
+
+/***********************************************************
+ *  RepointTextureRegion()
+ *
+ *  This method makes the passed in texture region cover the
+ *  whole texture in the passed in slot, and moves the draws
+ *  sampling the region there, undoing their atlas UV offset
+ *  and scale. Instanced batches are rebuilt because draws
+ *  that shared the atlas may no longer share a texture.
+ ***********************************************************/
+void SceneManager::RepointTextureRegion(int textureRegion, int textureSlot)
+{
+	TEXTURE_REGION& region = m_textureRegions[textureRegion];
+	for (DRAW_RECORD& draw : m_drawList)
+	{
+		if (draw.textureRegion == textureRegion)
+		{
+			draw.uvScale /= region.uvScale;
+			draw.uvOffset = glm::vec2(0.0f);
+			draw.texture = textureSlot;
+		}
+	}
+
+	region.slot = textureSlot;
+	region.uvOffset = glm::vec2(0.0f);
+	region.uvScale = glm::vec2(1.0f);
+
+	if (m_bInstancing)
+	{
+		BuildDrawBatches();
+		BuildDrawCommands();
+	}
+}
+
+/***********************************************************
+ *  FindTextureRegion()
+ *
+ *  This method is used for getting the texture region handle
+ *  of the image associated with the passed in tag, which may
+ *  be a whole texture or an image in the texture atlas, or -1
+ *  if there is no such image.
+ ***********************************************************/
+int SceneManager::FindTextureRegion(const std::string& tag) const
+{
+	for (int index = 0; index < static_cast<int>(m_textureRegions.size()); index++)
+	{
+		if (m_textureRegions[index].tag.compare(tag) == 0)
+		{
+			return index;
+		}
+	}
+
+	return -1;
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index in the defined
+ *  materials list of the material associated with the passed
+ *  in tag, or -1 if there is no such material.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(const std::string& tag) const
+{
+	for (int index = 0; index < static_cast<int>(m_objectMaterials.size()); index++)
+	{
+		if (m_objectMaterials[index].tag.compare(tag) == 0)
+		{
+			return index;
+		}
+	}
+
+	return -1;
+}
+
+/***********************************************************
+ *  UploadMaterials()
+ *
+ *  This method packs every defined material into the
+ *  material table uniform buffer, if the shader declares the
+ *  MaterialBlock, so that each draw selects its material with
+ *  a single integer uniform.
+ ***********************************************************/
+void SceneManager::UploadMaterials()
+{
+	m_bMaterialTable = false;
+	m_activeMaterial = -1;
+
+	if ((nullptr == m_pUniforms) || (m_pUniforms->materialBlock == GL_INVALID_INDEX))
+	{
+		return;
+	}
+	if (m_objectMaterials.size() > ShaderUniforms::MAX_MATERIALS)
+	{
+		std::cout << "Material table holds " << ShaderUniforms::MAX_MATERIALS
+			<< " materials, using material uniforms instead" << std::endl;
+		return;
+	}
+
+	std::vector<MATERIAL_STD140> materials(m_objectMaterials.size());
+	for (size_t i = 0; i < m_objectMaterials.size(); i++)
+	{
+		materials[i].ambientColor = m_objectMaterials[i].ambientColor;
+		materials[i].ambientStrength = m_objectMaterials[i].ambientStrength;
+		materials[i].diffuseColor = m_objectMaterials[i].diffuseColor;
+		materials[i].padding0 = 0.0f;
+		materials[i].specularColor = m_objectMaterials[i].specularColor;
+		materials[i].shininess = m_objectMaterials[i].shininess;
+	}
+
+	if (0 == m_materialsUBO)
+	{
+		glGenBuffers(1, &m_materialsUBO);
+	}
+	glBindBuffer(GL_UNIFORM_BUFFER, m_materialsUBO);
+	glBufferData(GL_UNIFORM_BUFFER, ShaderUniforms::MAX_MATERIALS * sizeof(MATERIAL_STD140), nullptr, GL_STATIC_DRAW);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, materials.size() * sizeof(MATERIAL_STD140), materials.data());
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, ShaderUniforms::MATERIAL_BLOCK_BINDING, m_materialsUBO);
+
+	m_bMaterialTable = true;
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform and cached
+ *  model matrix of the next submitted draw using the passed
+ *  in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	m_pendingDraw.transform.scale = scaleXYZ;
+	m_pendingDraw.transform.rotationDegrees = glm::vec3(XrotationDegrees, YrotationDegrees, ZrotationDegrees);
+	m_pendingDraw.transform.position = positionXYZ;
+
+	UpdateModelMatrix(m_pendingDraw);
+}
+
+/***********************************************************
+ *  UpdateModelMatrix()
+ *
+ *  This method is used for rebuilding the cached model matrix,
+ *  and the normal matrix derived from it, from the transform
+ *  values stored in the passed in draw.
+ ***********************************************************/
+void SceneManager::UpdateModelMatrix(DRAW_RECORD& draw)
+{
+	// variables for this method
+	glm::mat4 modelView;
+	glm::mat4 scale;
+	glm::mat4 rotationX;
+	glm::mat4 rotationY;
+	glm::mat4 rotationZ;
+	glm::mat4 translation;
+	const OBJECT_TRANSFORM& transform = draw.transform;
+
+	// set the scale value in the transform buffer
+	scale = glm::scale(transform.scale);
+	// set the rotation values in the transform buffer
+	rotationX = glm::rotate(glm::radians(transform.rotationDegrees.x), glm::vec3(1.0f, 0.0f, 0.0f));
+	rotationY = glm::rotate(glm::radians(transform.rotationDegrees.y), glm::vec3(0.0f, 1.0f, 0.0f));
+	rotationZ = glm::rotate(glm::radians(transform.rotationDegrees.z), glm::vec3(0.0f, 0.0f, 1.0f));
+	// set the translation value in the transform buffer
+	translation = glm::translate(transform.position);
+
+	modelView = translation * rotationX * rotationY * rotationZ * scale;
+
+	draw.model = modelView;
+	draw.normalMatrix = glm::mat3(glm::transpose(glm::inverse(modelView)));
+	draw.bTransformDirty = false;
+
+	UpdateWorldBounds(draw);
+}
+
+/***********************************************************
+ *  UpdateWorldBounds()
+ *
+ *  This method rebuilds the world-space bounding box and
+ *  sphere of the passed in draw from its mesh and cached
+ *  model matrix. The box center moves with the model matrix,
+ *  and each world axis extent is the sum of the absolute
+ *  matrix terms times the mesh's half size.
+ ***********************************************************/
+void SceneManager::UpdateWorldBounds(DRAW_RECORD& draw)
+{
+	const glm::mat4& model = draw.model;
+	glm::vec3 localMin;
+	glm::vec3 localMax;
+	GetMeshBounds(draw.mesh, localMin, localMax);
+	const glm::vec3 localCenter = (localMin + localMax) * 0.5f;
+	const glm::vec3 localHalf = (localMax - localMin) * 0.5f;
+	const glm::vec3 worldCenter = glm::vec3(model * glm::vec4(localCenter, 1.0f));
+	glm::vec3 worldHalf;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		worldHalf[axis] =
+			fabs(model[0][axis]) * localHalf.x +
+			fabs(model[1][axis]) * localHalf.y +
+			fabs(model[2][axis]) * localHalf.z;
+	}
+	draw.boundsMin = worldCenter - worldHalf;
+	draw.boundsMax = worldCenter + worldHalf;
+	draw.boundsCenter = worldCenter;
+	draw.boundsRadius = glm::length(worldHalf);
+}
+
+/***********************************************************
+ *  SetViewProjection()
+ *
+ *  This method extracts the six view frustum planes from the
+ *  passed in projection * view matrix. Each plane's normal
+ *  points into the frustum.
+ ***********************************************************/
+void SceneManager::SetViewProjection(const glm::mat4& viewProjection)
+{
+	// glm matrices are column-major, so row i is m[0][i]..m[3][i]
+	glm::vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+	{
+		rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+	}
+
+	m_frustumPlanes[0] = rows[3] + rows[0];  // left
+	m_frustumPlanes[1] = rows[3] - rows[0];  // right
+	m_frustumPlanes[2] = rows[3] + rows[1];  // bottom
+	m_frustumPlanes[3] = rows[3] - rows[1];  // top
+	m_frustumPlanes[4] = rows[3] + rows[2];  // near
+	m_frustumPlanes[5] = rows[3] - rows[2];  // far
+
+	for (glm::vec4& plane : m_frustumPlanes)
+	{
+		plane /= glm::length(glm::vec3(plane));
+	}
+	m_viewProjection = viewProjection;
+
+	// clip z grows with view depth under both projections, while
+	// clip w is constant under the orthographic one; scaled to unit
+	// length, its row measures world units along the view direction,
+	// so bounding radii can be taken off it. Row 1 of a perspective
+	// or orthographic view projection has the projection's y scale
+	// as its length because the view rotation is orthonormal
+	m_viewDepthRow = rows[2] / glm::length(glm::vec3(rows[2]));
+	m_clipWRow = rows[3];
+	m_projectionScale = glm::length(glm::vec3(rows[1]));
+	m_bFrustumValid = true;
+}
+
+/***********************************************************
+ *  IsInFrustum()
+ *
+ *  This method tests the bounds of the passed in draw against
+ *  the view frustum. The bounding sphere settles most planes;
+ *  only planes that cut the sphere test the bounding box.
+ ***********************************************************/
+bool SceneManager::IsInFrustum(const DRAW_RECORD& draw) const
+{
+	for (const glm::vec4& plane : m_frustumPlanes)
+	{
+		const glm::vec3 normal(plane);
+		const float distance = glm::dot(normal, draw.boundsCenter) + plane.w;
+		if (distance >= draw.boundsRadius)
+		{
+			continue;
+		}
+		if (distance < -draw.boundsRadius)
+		{
+			return false;
+		}
+
+		// the box corner furthest along the plane normal
+		const glm::vec3 corner(
+			(normal.x >= 0.0f) ? draw.boundsMax.x : draw.boundsMin.x,
+			(normal.y >= 0.0f) ? draw.boundsMax.y : draw.boundsMin.y,
+			(normal.z >= 0.0f) ? draw.boundsMax.z : draw.boundsMin.z);
+		if (glm::dot(normal, corner) + plane.w < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+/***********************************************************
+ *  CrossesNearPlane()
+ *
+ *  This method returns true if the bounds of the passed in
+ *  draw reach behind the near plane. The clipped box of such
+ *  a draw can miss every sample, so it is never queried.
+ ***********************************************************/
+bool SceneManager::CrossesNearPlane(const DRAW_RECORD& draw) const
+{
+	const glm::vec4& plane = m_frustumPlanes[4];
+	const glm::vec3 normal(plane);
+
+	// the box corner furthest behind the plane
+	const glm::vec3 corner(
+		(normal.x >= 0.0f) ? draw.boundsMin.x : draw.boundsMax.x,
+		(normal.y >= 0.0f) ? draw.boundsMin.y : draw.boundsMax.y,
+		(normal.z >= 0.0f) ? draw.boundsMin.z : draw.boundsMax.z);
+	return glm::dot(normal, corner) + plane.w < 0.0f;
+}
+
+/***********************************************************
+ *  SetRenderTarget()
+ *
+ *  This method sets the framebuffer the scene is drawn into,
+ *  0 for the window, and its size in pixels, so that frame
+ *  statistics and debug views need not query OpenGL for the
+ *  framebuffer binding and viewport every frame.
+ ***********************************************************/
+void SceneManager::SetRenderTarget(GLuint framebuffer, int width, int height)
+{
+	m_targetFramebuffer = framebuffer;
+	m_targetWidth = width;
+	m_targetHeight = height;
+}
+
+/***********************************************************
+ *  CullDrawList()
+ *
+ *  This method tests every draw against the view frustum set
+ *  by SetViewProjection(), collects the occlusion query
+ *  results that have arrived, and counts the visible, culled
+ *  and occluded objects. A draw leaving the frustum forgets
+ *  its occlusion result, so it is drawn when it comes back.
+ *  Returns true if any draw changed visibility since the
+ *  previous frame.
+ ***********************************************************/
+bool SceneManager::CullDrawList()
+{
+	TRACE_SCOPE("CullDrawList");
+
+	bool bChanged = false;
+
+	if (nullptr != m_occlusionQueries)
+	{
+		m_occlusionQueries->CollectResults();
+	}
+
+	for (size_t i = 0; i < m_drawList.size(); i++)
+	{
+		const unsigned char bInFrustum = (!m_bFrustumValid || IsInFrustum(m_drawList[i])) ? 1 : 0;
+		m_drawInFrustum[i] = bInFrustum;
+
+		bool bOccluded = false;
+		if (nullptr != m_occlusionQueries)
+		{
+			if (!bInFrustum)
+			{
+				m_occlusionQueries->Reset(static_cast<int>(i));
+			}
+			bOccluded = m_occlusionQueries->IsOccluded(static_cast<int>(i));
+		}
+
+		const unsigned char bVisible = (bInFrustum && !bOccluded) ? 1 : 0;
+		if (bVisible != m_drawVisible[i])
+		{
+			m_drawVisible[i] = bVisible;
+			bChanged = true;
+		}
+
+		if (!bInFrustum)
+		{
+			m_frameStats.culledObjects++;
+		}
+		else if (bOccluded)
+		{
+			m_frameStats.occludedObjects++;
+		}
+		else
+		{
+			m_frameStats.visibleObjects++;
+		}
+	}
+	return bChanged;
+}
+
+/***********************************************************
+ *  UpdateDrawLods()
+ *
+ *  This method selects the level of detail of every visible
+ *  draw of a curved mesh from the size of its bounding sphere
+ *  on screen. Returns true if any draw changed level.
+ ***********************************************************/
+bool SceneManager::UpdateDrawLods()
+{
+	TRACE_SCOPE("UpdateDrawLods");
+
+	if (!m_bFrustumValid)
+	{
+		return false;
+	}
+
+	bool bChanged = false;
+	for (size_t i = 0; i < m_drawList.size(); i++)
+	{
+		DRAW_RECORD& draw = m_drawList[i];
+		if (!m_drawVisible[i] || !m_instancedMeshes->HasLevelsOfDetail(ToInstancedShape(draw.mesh)))
+		{
+			continue;
+		}
+
+		// objects around or behind the eye keep full detail
+		const float depth = glm::dot(glm::vec3(m_clipWRow), draw.boundsCenter) + m_clipWRow.w;
+		const float screenSize = (depth > 0.0f) ? (draw.boundsRadius * m_projectionScale / depth) : 1.0f;
+
+		const int lod = SelectLod(screenSize, draw.lod);
+		if (lod != draw.lod)
+		{
+			draw.lod = lod;
+			bChanged = true;
+		}
+		if (lod > 0)
+		{
+			m_frameStats.reducedLodObjects++;
+		}
+	}
+	return bChanged;
+}
+
+/***********************************************************
+ *  GetViewDepth()
+ *
+ *  This method returns the view depth of the nearest point of
+ *  the passed in draw's bounding sphere, or 0 for every draw
+ *  until a view has been set. Only the order of the depths is
+ *  meaningful: they are offset from the eye distance by a
+ *  constant, and are valid for orthographic views too.
+ ***********************************************************/
+float SceneManager::GetViewDepth(const DRAW_RECORD& draw) const
+{
+	if (!m_bFrustumValid)
+	{
+		return 0.0f;
+	}
+	return glm::dot(glm::vec3(m_viewDepthRow), draw.boundsCenter) + m_viewDepthRow.w - draw.boundsRadius;
+}
+
+/***********************************************************
+ *  SortDrawOrder()
+ *
+ *  This method orders the visible draws front to back so the
+ *  depth test rejects the fragments of hidden surfaces before
+ *  they are lit. Each frame's order follows the camera; draws
+ *  at equal depth keep their state sorted order. Instanced
+ *  runs are ordered by their nearest visible draw, as the
+ *  draws within a run are submitted together.
+ ***********************************************************/
+void SceneManager::SortDrawOrder()
+{
+	TRACE_SCOPE("SortDrawOrder");
+
+	m_drawOrder.clear();
+
+	if (m_bInstancing)
+	{
+		for (COMMAND_RUN& run : m_commandRuns)
+		{
+			run.depth = std::numeric_limits<float>::max();
+			for (int i = run.firstDraw; i < run.endDraw; i++)
+			{
+				if (m_drawVisible[i])
+				{
+					run.depth = std::min(run.depth, GetViewDepth(m_drawList[i]));
+				}
+			}
+		}
+
+		m_drawOrder.resize(m_commandRuns.size());
+		std::iota(m_drawOrder.begin(), m_drawOrder.end(), 0);
+		std::stable_sort(m_drawOrder.begin(), m_drawOrder.end(),
+			[this](int a, int b) { return m_commandRuns[a].depth < m_commandRuns[b].depth; });
+		return;
+	}
+
+	m_drawDepth.resize(m_drawList.size());
+	for (int i = 0; i < static_cast<int>(m_drawList.size()); i++)
+	{
+		if (m_drawVisible[i])
+		{
+			m_drawDepth[i] = GetViewDepth(m_drawList[i]);
+			m_drawOrder.push_back(i);
+		}
+	}
+	std::stable_sort(m_drawOrder.begin(), m_drawOrder.end(),
+		[this](int a, int b) { return m_drawDepth[a] < m_drawDepth[b]; });
+}
+
+/***********************************************************
+ *  DrawOpaque()
+ *
+ *  This method draws the visible draws in the order set by
+ *  SortDrawOrder(). A depth-only pass writes nothing but the
+ *  model matrices, as the color and texture state do not
+ *  affect depth.
+ ***********************************************************/
+void SceneManager::DrawOpaque(bool bDepthOnly)
+{
+	TRACE_SCOPE("DrawOpaque");
+	// one span per run of draws in the same render group
+	TRACE_SPAN(groupSpan);
+
+	if (m_bInstancing)
+	{
+		for (int runIndex : m_drawOrder)
+		{
+			const COMMAND_RUN& run = m_commandRuns[runIndex];
+			if (!bDepthOnly)
+			{
+				TRACE_SPAN_NAME(groupSpan, GPU_SCOPE_NAMES[m_drawList[run.firstDraw].group]);
+				if (nullptr != m_gpuTimers)
+				{
+					m_gpuTimers->Mark(m_drawList[run.firstDraw].group);
+				}
+				ApplyBatchState(m_drawList[run.firstDraw]);
+			}
+			m_instancedMeshes->DrawCommands(run.firstCommand, run.commandCount);
+			m_frameStats.drawCalls++;
+		}
+		return;
+	}
+
+	for (int drawIndex : m_drawOrder)
+	{
+		const DRAW_RECORD& draw = m_drawList[drawIndex];
+		if (!bDepthOnly)
+		{
+			TRACE_SPAN_NAME(groupSpan, GPU_SCOPE_NAMES[draw.group]);
+			if (nullptr != m_gpuTimers)
+			{
+				m_gpuTimers->Mark(draw.group);
+			}
+			ApplyDrawState(draw);
+		}
+		else if (nullptr != m_pUniforms)
+		{
+			m_stateCache.SetMat4(m_pUniforms->model, draw.model);
+		}
+		DrawShapeMesh(draw.mesh, draw.meshParts);
+	}
+}
+
+/***********************************************************
+ *  RenderDepthPrepass()
+ *
+ *  This method writes the depth of every visible draw with
+ *  color writes off, then sets up the color pass to test
+ *  GL_EQUAL without writing depth, so that only the nearest
+ *  fragment of each pixel runs the lighting. The pre-pass
+ *  uses the scene program itself, because only the same
+ *  program is guaranteed to produce the same depth values,
+ *  with lighting and texturing switched off to keep its
+ *  fragments cheap.
+ ***********************************************************/
+void SceneManager::RenderDepthPrepass()
+{
+	TRACE_SCOPE("RenderDepthPrepass");
+	m_stateCache.ColorMask(false);
+	if (nullptr != m_pUniforms)
+	{
+		m_stateCache.SetInt(m_pUniforms->bUseLighting, false);
+		m_stateCache.SetInt(m_pUniforms->bUseTexture, false);
+	}
+
+	DrawOpaque(true);
+
+	m_stateCache.ColorMask(true);
+	if (nullptr != m_pUniforms)
+	{
+		m_stateCache.SetInt(m_pUniforms->bUseLighting, true);
+	}
+
+	m_stateCache.DepthMask(false);
+	m_stateCache.DepthFunc(GL_EQUAL);
+}
+
+/***********************************************************
+ *  ReadFragmentCount()
+ *
+ *  This method reads the number of samples that passed the
+ *  depth test in an earlier color pass, if the GPU has
+ *  finished it, without waiting for the result.
+ ***********************************************************/
+void SceneManager::ReadFragmentCount()
+{
+	if (!m_bFragmentQueryPending)
+	{
+		return;
+	}
+
+	GLuint bAvailable = GL_FALSE;
+	glGetQueryObjectuiv(m_fragmentQuery, GL_QUERY_RESULT_AVAILABLE, &bAvailable);
+	if (GL_FALSE == bAvailable)
+	{
+		return;
+	}
+
+	GLuint samples = 0;
+	glGetQueryObjectuiv(m_fragmentQuery, GL_QUERY_RESULT, &samples);
+	m_shadedFragments = static_cast<int>(samples);
+	m_bFragmentQueryPending = false;
+}
+
+/***********************************************************
+ *  BeginFragmentCount()
+ *
+ *  This method starts counting the samples that pass the
+ *  depth test, unless the previous count is still on the GPU.
+ *  Returns true if counting started.
+ ***********************************************************/
+bool SceneManager::BeginFragmentCount()
+{
+	ReadFragmentCount();
+	m_frameStats.shadedFragments = m_shadedFragments;
+	if (m_bFragmentQueryPending)
+	{
+		return false;
+	}
+
+	if (0 == m_fragmentQuery)
+	{
+		glGenQueries(1, &m_fragmentQuery);
+	}
+	glBeginQuery(GL_SAMPLES_PASSED, m_fragmentQuery);
+	return true;
+}
+
+/***********************************************************
+ *  EndFragmentCount()
+ *
+ *  This method ends the count started by BeginFragmentCount()
+ *  if it returned true.
+ ***********************************************************/
+void SceneManager::EndFragmentCount(bool bCounting)
+{
+	if (bCounting)
+	{
+		glEndQuery(GL_SAMPLES_PASSED);
+		m_bFragmentQueryPending = true;
+	}
+}
+
+/***********************************************************
+ *  DrawDebugObjects()
+ *
+ *  This method draws the visible draws, in the order set by
+ *  SortDrawOrder(), with the debug program current. Each
+ *  submission is one step of the draw order, so instanced
+ *  runs count as one.
+ ***********************************************************/
+void SceneManager::DrawDebugObjects()
+{
+	const int drawCount = static_cast<int>(m_drawOrder.size());
+	for (int order = 0; order < drawCount; order++)
+	{
+		if (m_bInstancing)
+		{
+			const COMMAND_RUN& run = m_commandRuns[m_drawOrder[order]];
+			m_debugViews->SetObject(glm::mat4(1.0f), order, drawCount);
+			m_instancedMeshes->DrawCommands(run.firstCommand, run.commandCount);
+			m_frameStats.drawCalls++;
+		}
+		else
+		{
+			const DRAW_RECORD& draw = m_drawList[m_drawOrder[order]];
+			m_debugViews->SetObject(draw.model, order, drawCount);
+			DrawShapeMesh(draw.mesh, draw.meshParts);
+		}
+	}
+}
+
+/***********************************************************
+ *  RenderDebugView()
+ *
+ *  This method draws the active debug view in place of the
+ *  shaded scene, with the same draw order and depth mode, and
+ *  counts its fragments as the color pass would. The depth
+ *  pre-pass is repeated with the debug program, as GL_EQUAL
+ *  needs depth written by the program that tests it. The
+ *  overdraw heat map leaves no depth in the framebuffer, so
+ *  depth is drawn again for the occlusion queries.
+ ***********************************************************/
+void SceneManager::RenderDebugView()
+{
+	TRACE_SCOPE("RenderDebugView");
+	m_debugViews->Begin(m_debugView, m_viewProjection, m_bInstancing,
+		m_targetFramebuffer, m_targetWidth, m_targetHeight);
+
+	if (m_bDepthPrepass)
+	{
+		m_stateCache.ColorMask(false);
+		DrawDebugObjects();
+		m_stateCache.ColorMask(true);
+		m_stateCache.DepthMask(false);
+		m_stateCache.DepthFunc(GL_EQUAL);
+	}
+
+	const bool bCounting = BeginFragmentCount();
+	DrawDebugObjects();
+	EndFragmentCount(bCounting);
+
+	if (m_bDepthPrepass)
+	{
+		m_stateCache.DepthFunc(GL_LESS);
+		m_stateCache.DepthMask(true);
+	}
+
+	if (m_debugViews->ResolveOverdraw())
+	{
+		m_stateCache.ColorMask(false);
+		DrawDebugObjects();
+		m_stateCache.ColorMask(true);
+	}
+
+	m_debugViews->End();
+	// the overdraw counts replace the bound texture
+	m_appliedDraw.texture = -1;
+}
+
+/***********************************************************
+ *  RunOcclusionQueries()
+ *
+ *  This method queries the bounding box of every draw in the
+ *  view frustum against the depth buffer of the frame just
+ *  drawn; the results decide which draws later frames skip.
+ *  Draws skipped this frame are then drawn under conditional
+ *  rendering on their new query, so an object that has come
+ *  into view appears now rather than a frame later, without
+ *  the CPU waiting for the result.
+ ***********************************************************/
+void SceneManager::RunOcclusionQueries()
+{
+	TRACE_SCOPE("RunOcclusionQueries");
+
+	if ((nullptr == m_occlusionQueries) || !m_bFrustumValid)
+	{
+		return;
+	}
+
+	m_conditionalDraws.clear();
+	// each box is tested against a depth buffer holding its own
+	// object, so faces that still touch the surface must pass
+	m_stateCache.DepthFunc(GL_LEQUAL);
+	m_occlusionQueries->BeginQueries(m_viewProjection);
+	for (int i = 0; i < static_cast<int>(m_drawList.size()); i++)
+	{
+		const DRAW_RECORD& draw = m_drawList[i];
+		if (!m_drawInFrustum[i])
+		{
+			continue;
+		}
+		if (CrossesNearPlane(draw))
+		{
+			// treat as visible from the next frame on
+			m_occlusionQueries->Reset(i);
+			continue;
+		}
+
+		if (m_occlusionQueries->QueryBox(i, draw.boundsMin, draw.boundsMax) && !m_drawVisible[i])
+		{
+			m_conditionalDraws.push_back(i);
+		}
+	}
+	m_occlusionQueries->EndQueries();
+	m_stateCache.DepthFunc(GL_LESS);
+	m_frameStats.occlusionQueries = m_occlusionQueries->GetQueryCount();
+
+	// debug views show newly revealed draws from the next frame on
+	if (DebugViews::VIEW_SHADED != m_debugView)
+	{
+		return;
+	}
+	for (int drawIndex : m_conditionalDraws)
+	{
+		m_occlusionQueries->BeginConditionalRender(drawIndex);
+		DrawObject(drawIndex);
+		m_occlusionQueries->EndConditionalRender();
+	}
+}
+
+/***********************************************************
+ *  UpdateDirtyTransforms()
+ *
+ *  This method rebuilds the cached matrices of the objects
+ *  moved by SetObjectTransform() since the last frame. Static
+ *  objects keep the matrices built in PrepareScene().
+ ***********************************************************/
+void SceneManager::UpdateDirtyTransforms()
+{
+	for (int objectID : m_dirtyTransforms)
+	{
+		const int drawIndex = m_objectDrawIndex[objectID];
+		UpdateModelMatrix(m_drawList[drawIndex]);
+		if (m_bInstancing)
+		{
+			m_instancedMeshes->UpdateInstance(drawIndex, MakeInstance(m_drawList[drawIndex]));
+		}
+		m_frameStats.transformUpdates++;
+	}
+	m_dirtyTransforms.clear();
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  for the next submitted draw
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+
+	m_pendingDraw.bUseTexture = false;
+	m_pendingDraw.color = currentColor;
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data in the
+ *  passed in texture region (see InternSceneHandles()) for
+ *  the next submitted draw.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	int textureRegion)
+{
+	// Texture tag not found: use solid color path to avoid sampling garbage.
+	// (No SetShaderColor here; caller decides the fallback color.)
+	m_pendingDraw.bUseTexture = (textureRegion >= 0);
+	m_pendingDraw.texture = (textureRegion >= 0) ? m_textureRegions[textureRegion].slot : -1;
+	m_pendingTextureRegion = textureRegion;
+}
+
+/***********************************************************
+ *  SetTextureEnabled()
+ *
+ *  This method is used for switching the next submitted draw
+ *  between sampling its texture and using the object color.
+ ***********************************************************/
+void SceneManager::SetTextureEnabled(
+	bool bEnabled)
+{
+	m_pendingDraw.bUseTexture = bEnabled;
+}
+
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values for the next submitted draw.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	m_pendingDraw.uvScale = glm::vec2(u, v);
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for setting the material at the passed
+ *  in material table index for the next submitted draw.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	int materialIndex)
+{
+	if (materialIndex >= 0)
+	{
+		m_pendingDraw.material = materialIndex;
+	}
+}
+
+/***********************************************************
+ *  SubmitMesh()
+ *
+ *  This method adds a draw of the passed in mesh, using the
+ *  transform, texture, color and material set so far, to
+ *  the draw list.
+ ***********************************************************/
+void SceneManager::SubmitMesh(SHAPE_MESH mesh, unsigned int meshParts)
+{
+	if (nullptr != m_sceneExport)
+	{
+		ExportSceneObject(mesh, meshParts);
+	}
+
+	DRAW_RECORD draw = m_pendingDraw;
+	draw.objectID = static_cast<int>(m_drawList.size());
+	draw.textureRegion = draw.bUseTexture ? m_pendingTextureRegion : -1;
+	// map the UV scale into the image's region of its texture
+	if (m_pendingTextureRegion >= 0)
+	{
+		const TEXTURE_REGION& region = m_textureRegions[m_pendingTextureRegion];
+		draw.uvScale *= region.uvScale;
+		draw.uvOffset = region.uvOffset;
+	}
+	draw.mesh = mesh;
+	draw.meshParts = (mesh == MESH_CYLINDER) ? meshParts : 0;
+	// the transform was set before the mesh was known
+	UpdateWorldBounds(draw);
+	draw.sortKey = MakeSortKey(draw, m_bInstancing && m_bMaterialTable);
+	m_drawList.push_back(draw);
+}
+
+/***********************************************************
+ *  SubmitSceneFileObjects()
+ *
+ *  This method adds a draw for every object of the scene
+ *  file. Texture tags are resolved to regions once, up front,
+ *  and the draw list is sized for all of the objects, so the
+ *  loop does no lookups or allocations.
+ ***********************************************************/
+void SceneManager::SubmitSceneFileObjects()
+{
+	TRACE_SCOPE("SubmitSceneFileObjects");
+	const uint32_t objectCount = m_sceneFile->GetObjectCount();
+	m_drawList.reserve(objectCount);
+
+	// texture region of each scene file texture (-1 = not loaded)
+	std::vector<int> textureRegions(m_sceneFile->GetTextureCount());
+	for (uint32_t i = 0; i < m_sceneFile->GetTextureCount(); i++)
+	{
+		textureRegions[i] = FindTextureRegion(m_sceneFile->GetString(m_sceneFile->GetTextureEntry(i).tag));
+	}
+
+	for (uint32_t i = 0; i < objectCount; i++)
+	{
+		const SceneFile::OBJECT_ENTRY& object = m_sceneFile->GetObjectEntry(i);
+		m_pendingDraw.group = static_cast<RENDER_GROUP>(object.group);
+
+		SetTransformations(
+			glm::make_vec3(object.scale),
+			object.rotationDegrees[0],
+			object.rotationDegrees[1],
+			object.rotationDegrees[2],
+			glm::make_vec3(object.position));
+
+		// objects whose texture did not load fall back to their color
+		const int textureRegion = (object.texture >= 0) ? textureRegions[object.texture] : -1;
+		SetShaderTexture(textureRegion);
+		if (textureRegion < 0)
+		{
+			SetShaderColor(object.color[0], object.color[1], object.color[2], object.color[3]);
+		}
+		SetTextureUVScale(object.uvScale[0], object.uvScale[1]);
+		// materials were added to the table in file order
+		SetShaderMaterial(object.material);
+
+		SubmitMesh(static_cast<SHAPE_MESH>(object.mesh), object.meshParts);
+	}
+}
+
+/***********************************************************
+ *  BeginSceneExport()
+ *
+ *  This method starts collecting the scene for export with
+ *  its textures, materials and lights. The objects are added
+ *  by SubmitMesh() while the draw list is built.
+ ***********************************************************/
+void SceneManager::BeginSceneExport()
+{
+	delete m_sceneExport;
+	m_sceneExport = new SceneFile();
+
+	std::vector<SCENE_TEXTURE> sceneTextures;
+	GetSceneTextures(sceneTextures);
+	for (const SCENE_TEXTURE& texture : sceneTextures)
+	{
+		m_sceneExport->AddTexture(texture.tag, texture.filename, texture.bAtlas);
+	}
+
+	for (const OBJECT_MATERIAL& material : m_objectMaterials)
+	{
+		SceneFile::MATERIAL_ENTRY entry;
+		memcpy(entry.ambientColor, glm::value_ptr(material.ambientColor), sizeof(entry.ambientColor));
+		entry.ambientStrength = material.ambientStrength;
+		memcpy(entry.diffuseColor, glm::value_ptr(material.diffuseColor), sizeof(entry.diffuseColor));
+		memcpy(entry.specularColor, glm::value_ptr(material.specularColor), sizeof(entry.specularColor));
+		entry.shininess = material.shininess;
+		m_sceneExport->AddMaterial(material.tag, entry);
+	}
+
+	for (const DIRECTIONAL_LIGHT& light : m_dirLights)
+	{
+		SceneFile::LIGHT_ENTRY entry;
+		memcpy(entry.direction, glm::value_ptr(light.direction), sizeof(entry.direction));
+		memcpy(entry.ambient, glm::value_ptr(light.ambient), sizeof(entry.ambient));
+		memcpy(entry.diffuse, glm::value_ptr(light.diffuse), sizeof(entry.diffuse));
+		memcpy(entry.specular, glm::value_ptr(light.specular), sizeof(entry.specular));
+		entry.focalStrength = light.focalStrength;
+		entry.specularIntensity = light.specularIntensity;
+		m_sceneExport->AddLight(entry);
+	}
+}
+
+/***********************************************************
+ *  ExportSceneObject()
+ *
+ *  This method adds the draw about to be submitted to the
+ *  exported scene, with the values it was authored with:
+ *  the UV scale before it is mapped into an atlas region.
+ ***********************************************************/
+void SceneManager::ExportSceneObject(SHAPE_MESH mesh, unsigned int meshParts)
+{
+	SceneFile::OBJECT_ENTRY object;
+	const OBJECT_TRANSFORM& transform = m_pendingDraw.transform;
+	memcpy(object.scale, glm::value_ptr(transform.scale), sizeof(object.scale));
+	memcpy(object.rotationDegrees, glm::value_ptr(transform.rotationDegrees), sizeof(object.rotationDegrees));
+	memcpy(object.position, glm::value_ptr(transform.position), sizeof(object.position));
+	memcpy(object.color, glm::value_ptr(m_pendingDraw.color), sizeof(object.color));
+	memcpy(object.uvScale, glm::value_ptr(m_pendingDraw.uvScale), sizeof(object.uvScale));
+
+	object.texture = -1;
+	if (m_pendingDraw.bUseTexture && (m_pendingTextureRegion >= 0))
+	{
+		object.texture = m_sceneExport->FindTexture(m_textureRegions[m_pendingTextureRegion].tag);
+	}
+	// the exported materials are in material table order
+	object.material = m_pendingDraw.material;
+	object.mesh = mesh;
+	object.meshParts = (mesh == MESH_CYLINDER) ? meshParts : SceneFile::PARTS_ALL;
+	object.group = m_pendingDraw.group;
+	m_sceneExport->AddObject(object);
+}
+
+/***********************************************************
+ *  ApplyDrawState()
+ *
+ *  This method writes the shader state of the passed in draw.
+ *  The state cache drops every value that is unchanged from
+ *  the previous draw.
+ ***********************************************************/
+void SceneManager::ApplyDrawState(const DRAW_RECORD& draw)
+{
+	if (nullptr == m_pUniforms)
+	{
+		return;
+	}
+
+	m_stateCache.SetMat4(m_pUniforms->model, draw.model);
+	// the normal matrix saves a per-vertex inverse in shaders that accept it
+	m_stateCache.SetMat3(m_pUniforms->normalMatrix, draw.normalMatrix);
+
+	ApplySurfaceState(draw);
+
+	if (!draw.bUseTexture)
+	{
+		m_stateCache.SetVec4(m_pUniforms->objectColor, draw.color);
+	}
+
+	ApplyMaterial(draw.material);
+}
+
+/***********************************************************
+ *  ApplyBatchState()
+ *
+ *  This method writes the shader state shared by every draw
+ *  of an instanced batch. The model matrix and color, and the
+ *  material when the material table is in use, are read from
+ *  the instance buffer instead.
+ ***********************************************************/
+void SceneManager::ApplyBatchState(const DRAW_RECORD& draw)
+{
+	if (nullptr == m_pUniforms)
+	{
+		return;
+	}
+
+	ApplySurfaceState(draw);
+
+	if (!m_bMaterialTable)
+	{
+		ApplyMaterial(draw.material);
+	}
+}
+
+/***********************************************************
+ *  ApplySurfaceState()
+ *
+ *  This method writes the texture switch, texture slot, UV
+ *  scale and UV offset of the passed in draw. Only the texture
+ *  selection is compared here; the state cache filters the
+ *  uniform values.
+ ***********************************************************/
+void SceneManager::ApplySurfaceState(const DRAW_RECORD& draw)
+{
+	m_stateCache.SetInt(m_pUniforms->bUseTexture, draw.bUseTexture);
+
+	if (draw.bUseTexture)
+	{
+		if (draw.texture != m_appliedDraw.texture)
+		{
+			m_frameStats.uniformUploads += SelectTexture(draw.texture);
+			m_appliedDraw.texture = draw.texture;
+		}
+		m_stateCache.SetVec2(m_pUniforms->UVscale, draw.uvScale);
+		m_stateCache.SetVec2(m_pUniforms->UVoffset, draw.uvOffset);
+	}
+}
+
+/***********************************************************
+ *  ApplyMaterial()
+ *
+ *  This method selects the material at the passed in index if
+ *  it is not already selected. With the material table this
+ *  is one integer uniform; otherwise the material values are
+ *  written to the material uniforms.
+ ***********************************************************/
+void SceneManager::ApplyMaterial(int materialIndex)
+{
+	if ((materialIndex < 0) || (materialIndex == m_activeMaterial))
+	{
+		return;
+	}
+
+	if (m_bMaterialTable)
+	{
+		m_stateCache.SetInt(m_pUniforms->materialIndex, materialIndex);
+	}
+	else
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[materialIndex];
+		const ShaderUniforms::MATERIAL_LOCATIONS& locations = m_pUniforms->material;
+		// materials often share some values, which the cache drops
+		m_stateCache.SetVec3(locations.ambientColor, material.ambientColor);
+		m_stateCache.SetFloat(locations.ambientStrength, material.ambientStrength);
+		m_stateCache.SetVec3(locations.diffuseColor, material.diffuseColor);
+		m_stateCache.SetVec3(locations.specularColor, material.specularColor);
+		m_stateCache.SetFloat(locations.shininess, material.shininess);
+	}
+	m_activeMaterial = materialIndex;
+}
+
+/***********************************************************
+ *  DrawShapeMesh()
+ *
+ *  This method issues the draw command for the passed in
+ *  basic shape mesh.
+ ***********************************************************/
+void SceneManager::DrawShapeMesh(SHAPE_MESH mesh, unsigned int meshParts)
+{
+	switch (mesh)
+	{
+	case MESH_BOX:
+		m_basicMeshes->DrawBoxMesh();
+		break;
+	case MESH_CONE:
+		m_basicMeshes->DrawConeMesh();
+		break;
+	case MESH_CYLINDER:
+		m_basicMeshes->DrawCylinderMesh(
+			(meshParts & CYLINDER_TOP) != 0,
+			(meshParts & CYLINDER_BOTTOM) != 0,
+			(meshParts & CYLINDER_SIDES) != 0);
+		break;
+	case MESH_PLANE:
+		m_basicMeshes->DrawPlaneMesh();
+		break;
+	case MESH_SPHERE:
+		m_basicMeshes->DrawSphereMesh();
+		break;
+	case MESH_TORUS:
+		m_basicMeshes->DrawTorusMesh();
+		break;
+	}
+	m_frameStats.drawCalls++;
+}
+
+/**************************************************************/
+/*** STUDENTS CAN MODIFY the code in the methods BELOW for  ***/
+/*** preparing and rendering their own 3D replicated scenes.***/
+/*** Please refer to the code in the OpenGL sample project  ***/
+/*** for assistance.                                        ***/
+/**************************************************************/
+
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	TRACE_SCOPE("PrepareScene");
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene
+
+	// draw instanced when the shader reads per-instance attributes
+	m_bInstancing = (nullptr != m_pUniforms) &&
+		(m_pUniforms->instanceModel >= 0) &&
+		InstancedMeshes::IsSupported();
+
+	if (m_bInstancing)
+	{
+		m_instancedMeshes = new InstancedMeshes();
+		m_instancedMeshes->LoadPlaneMesh();
+		m_instancedMeshes->LoadBoxMesh();
+		m_instancedMeshes->LoadCylinderMesh();
+		m_instancedMeshes->LoadTorusMesh();
+		m_instancedMeshes->LoadSphereMesh();
+		m_instancedMeshes->LoadConeMesh();
+	}
+	else
+	{
+		m_basicMeshes->LoadPlaneMesh();
+		m_basicMeshes->LoadBoxMesh();  // For table with thickness
+
+		// Load our coffee mug components
+		m_basicMeshes->LoadCylinderMesh();  // Main mug body
+		m_basicMeshes->LoadTorusMesh();     // Handle and base rim
+
+		// Load sphere for stress ball
+		m_basicMeshes->LoadSphereMesh();
+
+		// Load cone for monitor stand connector
+		m_basicMeshes->LoadConeMesh();
+	}
+
+	// Set vertical adjustment for mug components
+	m_mugVerticalOffset = -0.9375f;  // Adjusted so mug sits properly on base (scaled down 25%)
+
+	// Load all scene textures
+	LoadSceneTextures();
+
+	if (nullptr != m_sceneFile)
+	{
+		// materials and lights come from the scene file
+		DefineSceneFileMaterials();
+		DefineSceneFileLights();
+	}
+	else
+	{
+		// Define material properties for all objects
+		DefineObjectMaterials();
+
+		// Define lighting for the scene
+		DefineLights();
+	}
+
+	// Resolve texture and material tags once so rendering uses handles
+	InternSceneHandles();
+
+	// collect the scene as it is built if it is to be exported
+	if (!m_sceneExportPath.empty())
+	{
+		BeginSceneExport();
+	}
+
+	// Compile the scene objects into the sorted draw list
+	BuildDrawList();
+
+	if (nullptr != m_sceneExport)
+	{
+		if (m_sceneExport->WriteText(m_sceneExportPath))
+		{
+			std::cout << "Exported scene of " << m_sceneExport->GetObjectCount() << " objects:"
+				<< m_sceneExportPath << std::endl;
+		}
+		delete m_sceneExport;
+		m_sceneExport = nullptr;
+	}
+}
+
+/***********************************************************
+ *  BuildDrawList()
+ *
+ *  This method runs every Render* method once, or submits
+ *  every object of the scene file, to record the scene's
+ *  draws, each with its precomputed model matrix and shader
+ *  state, then sorts them by state key so that draws
+ *  sharing a texture and material are adjacent and their
+ *  state is written only once per frame.
+ ***********************************************************/
+void SceneManager::BuildDrawList()
+{
+	m_drawList.clear();
+	m_dirtyTransforms.clear();
+	m_pendingDraw = DRAW_RECORD();
+	m_pendingDraw.material = -1;
+	m_pendingDraw.uvScale = glm::vec2(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
+	m_pendingDraw.uvOffset = glm::vec2(0.0f);
+	m_pendingTextureRegion = -1;
+
+	if (nullptr != m_sceneFile)
+	{
+		SubmitSceneFileObjects();
+	}
+	else
+	{
+		// Render the background wall (furthest back)
+		m_pendingDraw.group = GROUP_WALL;
+		RenderWall();
+
+		// Render the table surface
+		m_pendingDraw.group = GROUP_TABLE;
+		RenderTablePlane();
+
+		// Render the coffee mug
+		m_pendingDraw.group = GROUP_MUG;
+		RenderMug();
+
+		// Render desk objects
+		m_pendingDraw.group = GROUP_SPHERE;
+		RenderBlueSphere();
+		m_pendingDraw.group = GROUP_KEYBOARD;
+		RenderKeyboard();
+		m_pendingDraw.group = GROUP_TOUCHPAD;
+		RenderTouchpad();
+		m_pendingDraw.group = GROUP_MONITOR;
+		RenderMonitor();
+	}
+
+	// stable so that draws with equal state keep their authored order
+	std::stable_sort(m_drawList.begin(), m_drawList.end(),
+		[](const DRAW_RECORD& a, const DRAW_RECORD& b) { return a.sortKey < b.sortKey; });
+
+	// map object IDs to their sorted positions for transform updates
+	m_objectDrawIndex.assign(m_drawList.size(), 0);
+	for (size_t i = 0; i < m_drawList.size(); i++)
+	{
+		m_objectDrawIndex[m_drawList[i].objectID] = static_cast<int>(i);
+	}
+
+	// every draw is visible until the first frame is culled
+	m_drawInFrustum.assign(m_drawList.size(), 1);
+	m_drawVisible.assign(m_drawList.size(), 1);
+
+	// one occlusion query per draw; without them only the frustum culls
+	delete m_occlusionQueries;
+	m_occlusionQueries = new OcclusionQueries(&m_stateCache);
+	if (!m_occlusionQueries->Initialize(static_cast<int>(m_drawList.size())))
+	{
+		delete m_occlusionQueries;
+		m_occlusionQueries = nullptr;
+	}
+
+	if (m_bInstancing)
+	{
+		BuildDrawBatches();
+		UploadInstances();
+		BuildDrawCommands();
+	}
+}
+
+/***********************************************************
+ *  BuildDrawBatches()
+ *
+ *  This method splits the sorted draw list into runs of
+ *  adjacent draws of the same mesh and texture, each of which
+ *  is issued as one instanced draw call. Because instances
+ *  are stored in draw list order, a batch's first draw index
+ *  is also its first instance.
+ ***********************************************************/
+void SceneManager::BuildDrawBatches()
+{
+	m_drawBatches.clear();
+
+	for (int i = 0; i < static_cast<int>(m_drawList.size()); i++)
+	{
+		if (!m_drawBatches.empty() &&
+			CanShareBatch(m_drawList[m_drawBatches.back().firstDraw], m_drawList[i], m_bMaterialTable))
+		{
+			m_drawBatches.back().drawCount++;
+		}
+		else
+		{
+			DRAW_BATCH batch;
+			batch.firstDraw = i;
+			batch.drawCount = 1;
+			m_drawBatches.push_back(batch);
+		}
+	}
+}
+
+/***********************************************************
+ *  UploadInstances()
+ *
+ *  This method writes the model matrix, color and material
+ *  of every draw, in draw list order, to the instance buffer.
+ ***********************************************************/
+void SceneManager::UploadInstances()
+{
+	std::vector<InstancedMeshes::INSTANCE_DATA> instances;
+	instances.reserve(m_drawList.size());
+	for (const DRAW_RECORD& draw : m_drawList)
+	{
+		instances.push_back(MakeInstance(draw));
+	}
+	m_instancedMeshes->SetInstances(instances);
+}
+
+/***********************************************************
+ *  BuildDrawCommands()
+ *
+ *  This method records one indirect command per batch (per
+ *  drawn part, for cylinders) and splits the commands into
+ *  runs whose batches share all shader state. Each run is one
+ *  multi-draw call, so the scene takes one call per distinct
+ *  texture rather than one per object. Culled draws are left
+ *  out by splitting their batch into the visible ranges
+ *  around them; instances keep their draw list index.
+ ***********************************************************/
+void SceneManager::BuildDrawCommands()
+{
+	TRACE_SCOPE("BuildDrawCommands");
+
+	std::vector<InstancedMeshes::DRAW_COMMAND> commands;
+	m_commandRuns.clear();
+
+	// timed runs hold the draws of one render group each
+	const bool bSplitGroups = (nullptr != m_gpuTimers);
+
+	for (const DRAW_BATCH& batch : m_drawBatches)
+	{
+		const DRAW_RECORD& draw = m_drawList[batch.firstDraw];
+		const unsigned int partMask = (draw.mesh == MESH_CYLINDER) ? draw.meshParts : InstancedMeshes::ALL_PARTS;
+
+		const int batchEnd = batch.firstDraw + batch.drawCount;
+		int first = batch.firstDraw;
+		while (first < batchEnd)
+		{
+			// find the next range of visible draws at one level of detail
+			while ((first < batchEnd) && !m_drawVisible[first])
+			{
+				first++;
+			}
+			int last = first;
+			while ((last < batchEnd) && m_drawVisible[last] && (m_drawList[last].lod == m_drawList[first].lod) &&
+				(!bSplitGroups || (m_drawList[last].group == m_drawList[first].group)))
+			{
+				last++;
+			}
+			if (last == first)
+			{
+				break;
+			}
+
+			if (m_commandRuns.empty() ||
+				!SharesBatchState(m_drawList[m_commandRuns.back().firstDraw], draw, m_bMaterialTable) ||
+				(bSplitGroups && (m_drawList[m_commandRuns.back().firstDraw].group != m_drawList[first].group)))
+			{
+				COMMAND_RUN run;
+				run.firstDraw = first;
+				run.endDraw = first;
+				run.firstCommand = static_cast<int>(commands.size());
+				run.commandCount = 0;
+				run.depth = 0.0f;
+				m_commandRuns.push_back(run);
+			}
+
+			const size_t commandCount = commands.size();
+			m_instancedMeshes->AddDrawCommands(ToInstancedShape(draw.mesh), partMask,
+				m_drawList[first].lod, first, last - first, commands);
+			m_commandRuns.back().commandCount += static_cast<int>(commands.size() - commandCount);
+			m_commandRuns.back().endDraw = last;
+			first = last;
+		}
+	}
+
+	m_instancedMeshes->SetDrawCommands(commands);
+}
+
+/***********************************************************
+ *  GetObjectCount()
+ *
+ *  This method returns the number of objects in the compiled
+ *  scene. Object IDs run from 0 in the order the Render*
+ *  methods submitted them.
+ ***********************************************************/
+int SceneManager::GetObjectCount() const
+{
+	return static_cast<int>(m_drawList.size());
+}
+
+/***********************************************************
+ *  SetObjectTransform()
+ *
+ *  This method moves the object with the passed in ID. Its
+ *  cached model and normal matrices are rebuilt once, at the
+ *  start of the next frame.
+ ***********************************************************/
+void SceneManager::SetObjectTransform(int objectID, const OBJECT_TRANSFORM& transform)
+{
+	if ((objectID < 0) || (objectID >= static_cast<int>(m_objectDrawIndex.size())))
+	{
+		return;
+	}
+
+	DRAW_RECORD& draw = m_drawList[m_objectDrawIndex[objectID]];
+	draw.transform = transform;
+	if (draw.bTransformDirty == false)
+	{
+		draw.bTransformDirty = true;
+		m_dirtyTransforms.push_back(objectID);
+	}
+}
+
+/***********************************************************
+ *  InternSceneHandles()
+ *
+ *  This method resolves every texture and material tag used
+ *  by the Render* methods to its small integer handle, so
+ *  drawing needs no string compares or allocations. Tags
+ *  that are not found resolve to -1 (solid color path /
+ *  material left unchanged).
+ ***********************************************************/
+void SceneManager::InternSceneHandles()
+{
+	m_textures.oak = FindTextureRegion("oak");
+	m_textures.marble = FindTextureRegion("marble");
+	m_textures.paleWall = FindTextureRegion("pale_wall");
+	m_textures.cement = FindTextureRegion("cement");
+	m_textures.rubber = FindTextureRegion("rubber");
+
+	m_materials.wood = FindMaterialIndex("wood");
+	m_materials.marble = FindMaterialIndex("marble");
+	m_materials.ceramic = FindMaterialIndex("ceramic");
+	m_materials.concrete = FindMaterialIndex("concrete");
+	m_materials.coffee = FindMaterialIndex("coffee");
+	m_materials.rubber = FindMaterialIndex("rubber");
+	m_materials.plastic = FindMaterialIndex("plastic");
+	m_materials.semiGlossPlastic = FindMaterialIndex("semi_gloss_plastic");
+	m_materials.screen = FindMaterialIndex("screen");
+	m_materials.wall = FindMaterialIndex("wall");
+}
+
+/***********************************************************
+ *  GetSceneTextures()
+ *
+ *  This method lists the texture images of the scene: those
+ *  of the scene file, if one is loaded, or else the images
+ *  used by the Render* methods.
+ ***********************************************************/
+void SceneManager::GetSceneTextures(std::vector<SCENE_TEXTURE>& sceneTextures) const
+{
+	sceneTextures.clear();
+	if (nullptr != m_sceneFile)
+	{
+		for (uint32_t i = 0; i < m_sceneFile->GetTextureCount(); i++)
+		{
+			const SceneFile::TEXTURE_ENTRY& entry = m_sceneFile->GetTextureEntry(i);
+			SCENE_TEXTURE texture;
+			texture.filename = m_sceneFile->GetString(entry.filename);
+			texture.tag = m_sceneFile->GetString(entry.tag);
+			texture.bAtlas = (0 != entry.bAtlas);
+			sceneTextures.push_back(texture);
+		}
+		return;
+	}
+
+	static const SCENE_TEXTURE builtInTextures[] =
+	{
+		// oak wood texture for table plane (tiled - complex technique)
+		{ "../../Utilities/textures/oak-wood.jpg", "oak", false },
+		// grey marble texture for mug body
+		{ "../../Utilities/textures/grey-marble.jpg", "marble", false },
+		// pale wall texture for mug handle (tiled on the wall)
+		{ "../../Utilities/textures/pale-wall.jpg", "pale_wall", false },
+		// cracked cement texture for mug base
+		{ "../../Utilities/textures/cracked-cement.jpg", "cement", true },
+		// rubber coating texture for stress ball
+		{ "../../Utilities/textures/rubber-coating.jpg", "rubber", true }
+	};
+	sceneTextures.assign(std::begin(builtInTextures), std::end(builtInTextures));
+}
+
+/***********************************************************
+ *  LoadSceneTextures()
+ *
+ *  Loads all texture images for the scene, listed by the
+ *  scene file or by GetSceneTextures(). Textures with a
+ *  valid compressed cache entry are uploaded directly. The
+ *  rest are decoded on worker threads; this thread creates
+ *  each OpenGL texture as soon as its image is decoded, while
+ *  the others are still decoding. Texture slots are assigned
+ *  in completion order, which is fine because the Render*
+ *  methods find their textures by tag.
+ *
+ *  Small images that are never tiled are packed into one
+ *  texture atlas instead, if the shader accepts a UV offset,
+ *  so the draws using them share a texture. Atlas images are
+ *  not cached, so they are packed again on every run.
+ ***********************************************************/
+void SceneManager::LoadSceneTextures()
+{
+	TRACE_SCOPE("LoadSceneTextures");
+	std::vector<SCENE_TEXTURE> sceneTextures;
+	GetSceneTextures(sceneTextures);
+	const int numTextures = static_cast<int>(sceneTextures.size());
+
+	std::chrono::steady_clock::time_point loadStart = std::chrono::steady_clock::now();
+
+	// the flip setting is shared by the decode threads, so set it first
+	stbi_set_flip_vertically_on_load(true);
+
+	// decode only the textures that are not in the cache
+	std::vector<int> requestTextures;
+	for (int i = 0; i < numTextures; i++)
+	{
+		GLuint cachedID = m_textureCache.Load(sceneTextures[i].filename);
+		if (0 != cachedID)
+		{
+			RegisterGLTexture(cachedID, sceneTextures[i].tag);
+		}
+		else
+		{
+			requestTextures.push_back(i);
+		}
+	}
+
+	// no more workers than there are images to decode
+	int workerCount = static_cast<int>(std::thread::hardware_concurrency());
+	workerCount = std::max(1, std::min(workerCount, static_cast<int>(requestTextures.size())));
+
+	TextureLoader loader(workerCount);
+	for (int textureIndex : requestTextures)
+	{
+		loader.Enqueue(sceneTextures[textureIndex].filename);
+	}
+
+	// images packed into the atlas, added as regions once it is created
+	struct ATLAS_IMAGE
+	{
+		const char* tag;
+		TextureAtlas::REGION region;
+	};
+	std::vector<ATLAS_IMAGE> atlasImages;
+	TextureAtlas atlas(TEXTURE_ATLAS_SIZE);
+	const bool bAtlasSupported = (nullptr != m_pUniforms) && (m_pUniforms->UVoffset >= 0);
+
+	// upload each image as soon as a worker finishes decoding it
+	TextureLoader::DECODED_IMAGE image;
+	while (loader.WaitForNext(image))
+	{
+		const SCENE_TEXTURE& texture = sceneTextures[requestTextures[image.requestIndex]];
+		bool bReturn = false;
+
+		if (nullptr != image.pixels)
+		{
+			ATLAS_IMAGE atlasImage;
+			atlasImage.tag = texture.tag;
+			if (bAtlasSupported && texture.bAtlas &&
+				atlas.Add(image.pixels, image.width, image.height, image.colorChannels, atlasImage.region))
+			{
+				atlasImages.push_back(atlasImage);
+				bReturn = true;
+			}
+			else
+			{
+				bReturn = CreateGLTextureFromImage(texture.filename, texture.tag,
+					image.pixels, image.width, image.height, image.colorChannels);
+			}
+			TextureLoader::FreeImage(image);
+		}
+		else
+		{
+			std::cout << "Could not load image:" << texture.filename << std::endl;
+		}
+
+		if (!bReturn) {
+			std::cout << "Failed to load " << texture.filename << " texture" << std::endl;
+		}
+	}
+
+	GLuint atlasID = atlas.CreateGLTexture();
+	if (0 != atlasID)
+	{
+		const int atlasSlot = RegisterGLTexture(atlasID, "atlas");
+		for (const ATLAS_IMAGE& atlasImage : atlasImages)
+		{
+			TEXTURE_REGION region;
+			region.tag = atlasImage.tag;
+			region.slot = atlasSlot;
+			region.uvOffset = atlasImage.region.offset;
+			region.uvScale = atlasImage.region.scale;
+			m_textureRegions.push_back(region);
+		}
+		std::cout << "Packed " << atlas.GetImageCount() << " small textures into one atlas" << std::endl;
+	}
+
+	std::cout << "Loaded " << m_textureIDs.size() << " textures in "
+		<< std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count()
+		<< " ms using " << loader.GetWorkerCount() << " decode threads" << std::endl;
+
+	// Bind all loaded textures to OpenGL texture slots
+	BindGLTextures();
+}
+
+/***********************************************************
+ *  DefineLights()
+ *
+ *  Defines a five-light system using directional lights to
+ *  simulate realistic indoor lighting with natural sunlight.
+ *  Enhanced fill lighting eliminates dark shadows per
+ *  instructor feedback while maintaining visual depth.
+ *
+ *  CS330 REQUIREMENTS FULFILLED:
+ *  - LIGHTING: 5 light sources (required: minimum 2)
+ *  - NO COMPLETE SHADOWS: All objects remain visible
+ *
+ *  LIGHTING STRATEGY:
+ *  - Light 0: Primary sunset sunlight (warm, directional)
+ *  - Lights 1-4: Fill lights from multiple angles
+ *  - Brightened fill values ensure no dark areas
+ ***********************************************************/
+void SceneManager::DefineLights()
+{
+	// ============================================================
+	// LIGHT 0: Primary Sunlight (warm sunset, main illumination)
+	// ============================================================
+	// Direction: Low angle (~35° elevation) from front-right
+	//   - Positive X (0.50) = coming from right side
+	//   - Positive Y (0.57) = angled downward from above
+	//   - Positive Z (0.20) = slight forward component
+	m_dirLights[0].direction = glm::normalize(glm::vec3(0.50f, 0.57f, 0.20f));
+
+	// Ambient: Warm base illumination present everywhere
+	m_dirLights[0].ambient = glm::vec3(0.14f, 0.10f, 0.08f);  // Red-biased for sunset warmth
+
+	// Diffuse: Strong warm orange/red tones simulate golden hour sunlight
+	m_dirLights[0].diffuse = glm::vec3(1.0f, 0.75f, 0.55f);  // Full red, reduced green/blue
+
+	// Specular: Warm highlights on glossy surfaces
+	m_dirLights[0].specular = glm::vec3(0.25f, 0.18f, 0.12f);
+
+	// Focal strength: Moderate focus for soft sunset lighting
+	m_dirLights[0].focalStrength = 24.0f;
+
+	// Specular intensity: Subtle highlights
+	m_dirLights[0].specularIntensity = 0.15f;
+
+	// ============================================================
+	// LIGHT 1: Sky Fill (cool blue, from above) - BRIGHTENED
+	// ============================================================
+	// Direction: Nearly vertical from above, slight diagonal
+	//   - Near-vertical Y (0.985) = overhead sky dome lighting
+	//   - Minimal X,Z (-0.123) = very slight angle variation
+	m_dirLights[1].direction = glm::normalize(glm::vec3(-0.123f, 0.985f, -0.123f));
+
+	// Ambient: Cool blue ambient (brightened per instructor feedback)
+	m_dirLights[1].ambient = glm::vec3(0.04f, 0.04f, 0.05f);  // DOUBLED from 0.02
+
+	// Diffuse: Cool blue skylight (brightened significantly)
+	m_dirLights[1].diffuse = glm::vec3(0.38f, 0.42f, 0.50f);  // INCREASED ~70% from (0.22, 0.26, 0.34)
+
+	// Specular: None (diffuse fill only)
+	m_dirLights[1].specular = glm::vec3(0.0f);
+	m_dirLights[1].focalStrength = 12.0f;
+	m_dirLights[1].specularIntensity = 0.0f;
+
+	// ============================================================
+	// LIGHT 2: Wall Bounce (warm, from left-front) - BRIGHTENED
+	// ============================================================
+	// Direction: Low angle from left-front, simulates light bouncing off wall
+	//   - Negative X (-0.612) = coming from left side
+	//   - Positive Y (0.500) = angled downward
+	//   - Negative Z (-0.612) = coming from front
+	m_dirLights[2].direction = glm::normalize(glm::vec3(-0.612f, 0.500f, -0.612f));
+
+	// Ambient: Neutral warm (brightened per instructor feedback)
+	m_dirLights[2].ambient = glm::vec3(0.02f);  // DOUBLED from 0.01
+
+	// Diffuse: Warm bounce light (doubled intensity)
+	m_dirLights[2].diffuse = glm::vec3(0.28f, 0.24f, 0.20f);  // DOUBLED from (0.14, 0.12, 0.10)
+
+	// Specular: None (simulates diffuse bounce)
+	m_dirLights[2].specular = glm::vec3(0.0f);
+	m_dirLights[2].focalStrength = 10.0f;
+	m_dirLights[2].specularIntensity = 0.0f;
+
+	// ============================================================
+	// LIGHT 3: Back Fill (neutral, from behind) - BRIGHTENED
+	// ============================================================
+	// Direction: Low angle from back-left, fills rear shadows
+	//   - Negative X (-0.683) = coming from left
+	//   - Low Y (0.259) = nearly horizontal
+	//   - Positive Z (0.683) = coming from behind
+	m_dirLights[3].direction = glm::normalize(glm::vec3(-0.683f, 0.259f, 0.683f));
+
+	// Ambient: Neutral (brightened per instructor feedback)
+	m_dirLights[3].ambient = glm::vec3(0.02f);  // DOUBLED from 0.01
+
+	// Diffuse: Neutral grey (more than doubled)
+	m_dirLights[3].diffuse = glm::vec3(0.18f);  // INCREASED 125% from 0.08
+
+	// Specular: None (ambient fill only)
+	m_dirLights[3].specular = glm::vec3(0.0f);
+	m_dirLights[3].focalStrength = 8.0f;
+	m_dirLights[3].specularIntensity = 0.0f;
+
+	// ============================================================
+	// LIGHT 4: Overhead Indoor (neutral cool, directly down)
+	// ============================================================
+	// Direction: Straight down, simulates ceiling light
+	//   - Zero X,Z = perfectly vertical
+	//   - Negative Y (-1.0) = pointing downward
+	m_dirLights[4].direction = glm::normalize(glm::vec3(0.0f, -1.0f, 0.0f));
+
+	// Ambient: Cool neutral
+	m_dirLights[4].ambient = glm::vec3(0.03f);
+
+	// Diffuse: Cool neutral white (slight blue tint for indoor fluorescent feel)
+	m_dirLights[4].diffuse = glm::vec3(0.25f, 0.25f, 0.28f);
+
+	// Specular: None (ambient indoor lighting)
+	m_dirLights[4].specular = glm::vec3(0.0f);
+	m_dirLights[4].focalStrength = 16.0f;
+	m_dirLights[4].specularIntensity = 0.0f;
+
+	// upload the new light set on the next frame
+	m_bLightsDirty = true;
+}
+
+/***********************************************************
+ *  SetDirectionalLight()
+ *
+ *  This method replaces one of the scene's directional
+ *  lights. The light set is uploaded again on the next frame.
+ ***********************************************************/
+void SceneManager::SetDirectionalLight(int index, const DIRECTIONAL_LIGHT& light)
+{
+	if ((index >= 0) && (index < NUM_DIR_LIGHTS))
+	{
+		m_dirLights[index] = light;
+		m_bLightsDirty = true;
+	}
+}
+
+/***********************************************************
+ *  UploadLights()
+ *
+ *  This method uploads the directional light data to the
+ *  active shader program. Called once per frame before
+ *  drawing the scene, but only does work when a light has
+ *  changed since the last upload: uniform and buffer values
+ *  stay in place between frames.
+ *
+ *  If the shader declares the std140 LightBlock, the lights
+ *  are written to a uniform buffer with one call; otherwise
+ *  they are written to the lightSources[] uniforms.
+ ***********************************************************/
+void SceneManager::UploadLights()
+{
+	TRACE_SCOPE("UploadLights");
+
+	if ((nullptr == m_pUniforms) || (m_bLightsDirty == false))
+	{
+		return;
+	}
+
+	m_stateCache.SetInt(m_pUniforms->bUseLighting, true);
+
+	if (m_pUniforms->lightBlock != GL_INVALID_INDEX)
+	{
+		LIGHT_STD140 lights[NUM_DIR_LIGHTS] = {};
+		for (int i = 0; i < NUM_DIR_LIGHTS; ++i)
+		{
+			const DIRECTIONAL_LIGHT& light = m_dirLights[i];
+			lights[i].position = glm::normalize(light.direction) * 1e6f; // keep the “distant point” approach
+			lights[i].ambientColor = light.ambient;
+			lights[i].diffuseColor = light.diffuse;
+			lights[i].specularColor = light.specular;
+			lights[i].focalStrength = light.focalStrength;
+			lights[i].specularIntensity = light.specularIntensity;
+		}
+
+		if (0 == m_lightsUBO)
+		{
+			glGenBuffers(1, &m_lightsUBO);
+			glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUBO);
+			glBufferData(GL_UNIFORM_BUFFER, sizeof(lights), nullptr, GL_DYNAMIC_DRAW);
+			glBindBufferBase(GL_UNIFORM_BUFFER, ShaderUniforms::LIGHT_BLOCK_BINDING, m_lightsUBO);
+		}
+		glBindBuffer(GL_UNIFORM_BUFFER, m_lightsUBO);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(lights), lights);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+	else
+	{
+		for (int i = 0; i < NUM_DIR_LIGHTS; ++i)
+		{
+			const DIRECTIONAL_LIGHT& light = m_dirLights[i];
+			const ShaderUniforms::LIGHT_LOCATIONS& locations = m_pUniforms->lightSources[i];
+			glm::vec3 position = glm::normalize(light.direction) * 1e6f; // keep the “distant point” approach
+			m_stateCache.SetVec3(locations.position, position);
+			m_stateCache.SetVec3(locations.ambientColor, light.ambient);
+			m_stateCache.SetVec3(locations.diffuseColor, light.diffuse);
+			m_stateCache.SetVec3(locations.specularColor, light.specular);
+			m_stateCache.SetFloat(locations.focalStrength, light.focalStrength);
+			m_stateCache.SetFloat(locations.specularIntensity, light.specularIntensity);
+		}
+	}
+
+	m_frameStats.lightUploads++;
+	m_bLightsDirty = false;
+}
+
+/***********************************************************
+ *  DefineObjectMaterials()
+ *
+ *  This method is used for defining material properties
+ *  for all objects in the scene. Materials control how
+ *  surfaces interact with light and texture colors.
+ ***********************************************************/
+void SceneManager::DefineObjectMaterials()
+{
+	// Wood material for table plane
+	OBJECT_MATERIAL woodMaterial;
+	woodMaterial.ambientColor = glm::vec3(0.35f, 0.28f, 0.20f);
+	woodMaterial.ambientStrength = 0.20f;
+	woodMaterial.diffuseColor = glm::vec3(0.55f, 0.40f, 0.22f);
+	woodMaterial.specularColor = glm::vec3(0.03f);
+	woodMaterial.shininess = 8.0f;
+	woodMaterial.tag = "wood";
+	m_objectMaterials.push_back(woodMaterial);
+
+	// Marble material for mug body
+	OBJECT_MATERIAL marbleMaterial;
+	marbleMaterial.ambientColor = glm::vec3(0.22f);
+	marbleMaterial.ambientStrength = 0.22f;
+	marbleMaterial.diffuseColor = glm::vec3(0.36f);
+	marbleMaterial.specularColor = glm::vec3(0.01f);
+	marbleMaterial.shininess = 4.0f;
+	marbleMaterial.tag = "marble";
+	m_objectMaterials.push_back(marbleMaterial);
+
+	// Ceramic material for mug handle
+	OBJECT_MATERIAL ceramicMaterial;
+	ceramicMaterial.ambientColor = glm::vec3(0.34f);
+	ceramicMaterial.ambientStrength = 0.16f;
+	ceramicMaterial.diffuseColor = glm::vec3(0.60f);
+	ceramicMaterial.specularColor = glm::vec3(0.02f);
+	ceramicMaterial.shininess = 4.0f;
+	ceramicMaterial.tag = "ceramic";
+	m_objectMaterials.push_back(ceramicMaterial);
+
+	// Concrete material for mug base
+	OBJECT_MATERIAL concreteMaterial;
+	concreteMaterial.ambientColor = glm::vec3(0.20f);
+	concreteMaterial.ambientStrength = 0.30f;
+	concreteMaterial.diffuseColor = glm::vec3(0.40f);
+	concreteMaterial.specularColor = glm::vec3(0.04f);
+	concreteMaterial.shininess = 6.0f;
+	concreteMaterial.tag = "concrete";
+	m_objectMaterials.push_back(concreteMaterial);
+
+	// Coffee (liquid)
+	OBJECT_MATERIAL coffeeMaterial;
+	coffeeMaterial.ambientColor = glm::vec3(0.24f, 0.15f, 0.08f);
+	coffeeMaterial.ambientStrength = 0.25f;
+	coffeeMaterial.diffuseColor = glm::vec3(0.32f, 0.20f, 0.10f);
+	coffeeMaterial.specularColor = glm::vec3(0.08f, 0.06f, 0.04f);
+	coffeeMaterial.shininess = 5.0f;
+	coffeeMaterial.tag = "coffee";
+	m_objectMaterials.push_back(coffeeMaterial);
+
+	// Blue stress ball (rubber)
+	OBJECT_MATERIAL rubberMaterial;
+	rubberMaterial.ambientColor = glm::vec3(0.15f, 0.20f, 0.35f);
+	rubberMaterial.ambientStrength = 0.35f;
+	rubberMaterial.diffuseColor = glm::vec3(0.30f, 0.40f, 0.70f);
+	rubberMaterial.specularColor = glm::vec3(0.05f, 0.05f, 0.08f);  // Low specular for matte rubber
+	rubberMaterial.shininess = 6.0f;  // Low shininess for rubber
+	rubberMaterial.tag = "rubber";
+	m_objectMaterials.push_back(rubberMaterial);
+
+	// Black plastic for keyboard frame
+	OBJECT_MATERIAL plasticMaterial;
+	plasticMaterial.ambientColor = glm::vec3(0.02f, 0.02f, 0.02f);
+	plasticMaterial.ambientStrength = 0.15f;
+	plasticMaterial.diffuseColor = glm::vec3(0.08f, 0.08f, 0.08f);
+	plasticMaterial.specularColor = glm::vec3(0.10f, 0.10f, 0.10f);
+	plasticMaterial.shininess = 12.0f;
+	plasticMaterial.tag = "plastic";
+	m_objectMaterials.push_back(plasticMaterial);
+
+	// Semi-gloss plastic for monitor frame
+	OBJECT_MATERIAL semiGlossPlasticMaterial;
+	semiGlossPlasticMaterial.ambientColor = glm::vec3(0.02f, 0.02f, 0.02f);
+	semiGlossPlasticMaterial.ambientStrength = 0.15f;
+	semiGlossPlasticMaterial.diffuseColor = glm::vec3(0.08f, 0.08f, 0.08f);
+	semiGlossPlasticMaterial.specularColor = glm::vec3(0.15f, 0.15f, 0.15f);
+	semiGlossPlasticMaterial.shininess = 28.0f;
+	semiGlossPlasticMaterial.tag = "semi_gloss_plastic";
+	m_objectMaterials.push_back(semiGlossPlasticMaterial);
+
+	// Glossy black screen for monitor display
+	OBJECT_MATERIAL screenMaterial;
+	screenMaterial.ambientColor = glm::vec3(0.01f, 0.01f, 0.01f);
+	screenMaterial.ambientStrength = 0.1f;
+	screenMaterial.diffuseColor = glm::vec3(0.02f, 0.02f, 0.02f);
+	screenMaterial.specularColor = glm::vec3(0.3f, 0.3f, 0.3f);
+	screenMaterial.shininess = 64.0f;
+	screenMaterial.tag = "screen";
+	m_objectMaterials.push_back(screenMaterial);
+
+	// Wall material (uses ceramic material values for matte appearance)
+	OBJECT_MATERIAL wallMaterial;
+	wallMaterial.ambientColor = glm::vec3(0.34f);
+	wallMaterial.ambientStrength = 0.16f;
+	wallMaterial.diffuseColor = glm::vec3(0.60f);
+	wallMaterial.specularColor = glm::vec3(0.02f);
+	wallMaterial.shininess = 4.0f;
+	wallMaterial.tag = "wall";
+	m_objectMaterials.push_back(wallMaterial);
+
+	// pack the materials into the material table for indexed selection
+	UploadMaterials();
+}
+
+/***********************************************************
+ *  DefineSceneFileMaterials()
+ *
+ *  This method adds the materials of the scene file to the
+ *  material table, in file order, so the objects' material
+ *  indices select them directly.
+ ***********************************************************/
+void SceneManager::DefineSceneFileMaterials()
+{
+	for (uint32_t i = 0; i < m_sceneFile->GetMaterialCount(); i++)
+	{
+		const SceneFile::MATERIAL_ENTRY& entry = m_sceneFile->GetMaterialEntry(i);
+		OBJECT_MATERIAL material;
+		material.ambientColor = glm::make_vec3(entry.ambientColor);
+		material.ambientStrength = entry.ambientStrength;
+		material.diffuseColor = glm::make_vec3(entry.diffuseColor);
+		material.specularColor = glm::make_vec3(entry.specularColor);
+		material.shininess = entry.shininess;
+		material.tag = m_sceneFile->GetString(entry.tag);
+		m_objectMaterials.push_back(material);
+	}
+
+	// pack the materials into the material table for indexed selection
+	UploadMaterials();
+}
+
+/***********************************************************
+ *  DefineSceneFileLights()
+ *
+ *  This method sets the directional lights from the scene
+ *  file. Lights the file does not define are switched off,
+ *  and lights beyond the shader's limit are ignored.
+ ***********************************************************/
+void SceneManager::DefineSceneFileLights()
+{
+	const uint32_t lightCount = m_sceneFile->GetLightCount();
+	if (lightCount > NUM_DIR_LIGHTS)
+	{
+		std::cout << "Scene defines " << lightCount << " lights, using the first "
+			<< NUM_DIR_LIGHTS << std::endl;
+	}
+
+	for (int i = 0; i < NUM_DIR_LIGHTS; i++)
+	{
+		DIRECTIONAL_LIGHT light;
+		if (static_cast<uint32_t>(i) < lightCount)
+		{
+			const SceneFile::LIGHT_ENTRY& entry = m_sceneFile->GetLightEntry(i);
+			light.direction = glm::make_vec3(entry.direction);
+			if (glm::length(light.direction) > 0.0f)
+			{
+				light.direction = glm::normalize(light.direction);
+			}
+			light.ambient = glm::make_vec3(entry.ambient);
+			light.diffuse = glm::make_vec3(entry.diffuse);
+			light.specular = glm::make_vec3(entry.specular);
+			light.focalStrength = entry.focalStrength;
+			light.specularIntensity = entry.specularIntensity;
+		}
+		else
+		{
+			light.direction = glm::vec3(0.0f, -1.0f, 0.0f);
+			light.ambient = glm::vec3(0.0f);
+			light.diffuse = glm::vec3(0.0f);
+			light.specular = glm::vec3(0.0f);
+			light.focalStrength = 1.0f;
+			light.specularIntensity = 0.0f;
+		}
+		m_dirLights[i] = light;
+	}
+
+	// upload the new light set on the next frame
+	m_bLightsDirty = true;
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene by walking
+ *  the draw list compiled in PrepareScene() and drawing the
+ *  basic 3D shapes with their recorded state
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	TRACE_SCOPE("RenderScene");
+	// start counting the work submitted for this frame
+	m_frameStats = FRAME_STATS();
+	const int issuedUniformsBefore = m_stateCache.GetStats().issuedUniforms;
+
+	// swap in textures streamed since the last frame
+	UpdateTextureStreaming();
+
+	// Upload lighting data to shader
+	UploadLights();
+
+	// Rebuild matrices only for objects that moved
+	UpdateDirtyTransforms();
+
+	// skip objects outside the view; the instanced path also picks
+	// levels of detail and rebuilds its indirect commands only when
+	// the set of visible objects or their levels change
+	const bool bVisibilityChanged = CullDrawList();
+	if (m_bInstancing && (UpdateDrawLods() || bVisibilityChanged))
+	{
+		BuildDrawCommands();
+	}
+
+	// draw near objects first so they hide what is behind them
+	SortDrawOrder();
+
+	m_frameStats.viewportPixels = m_targetWidth * m_targetHeight;
+
+	if (DebugViews::VIEW_SHADED != m_debugView)
+	{
+		RenderDebugView();
+	}
+	else
+	{
+		if (nullptr != m_gpuTimers)
+		{
+			m_gpuTimers->BeginFrame();
+		}
+
+		if (m_bDepthPrepass)
+		{
+			if (nullptr != m_gpuTimers)
+			{
+				m_gpuTimers->Mark(GPU_SCOPE_DEPTH_PREPASS);
+			}
+			RenderDepthPrepass();
+		}
+
+		// count the fragments the lighting shader runs for
+		const bool bCounting = BeginFragmentCount();
+		DrawOpaque(false);
+		EndFragmentCount(bCounting);
+
+		if (m_bDepthPrepass)
+		{
+			m_stateCache.DepthFunc(GL_LESS);
+			m_stateCache.DepthMask(true);
+		}
+	}
+
+	// find the draws hidden behind others for the next frame
+	if (nullptr != m_gpuTimers)
+	{
+		m_gpuTimers->Mark(GPU_SCOPE_OCCLUSION);
+	}
+	RunOcclusionQueries();
+
+	if (nullptr != m_gpuTimers)
+	{
+		m_gpuTimers->EndFrame();
+	}
+
+	m_frameStats.uniformUploads += m_stateCache.GetStats().issuedUniforms - issuedUniformsBefore;
+}
+
+/***********************************************************
+ *  DrawObject()
+ *
+ *  This method draws one entry of the draw list by itself,
+ *  as one instance of its mesh when instancing.
+ ***********************************************************/
+void SceneManager::DrawObject(int drawIndex)
+{
+	const DRAW_RECORD& draw = m_drawList[drawIndex];
+
+	if (!m_bInstancing)
+	{
+		ApplyDrawState(draw);
+		DrawShapeMesh(draw.mesh, draw.meshParts);
+		return;
+	}
+
+	ApplyBatchState(draw);
+	switch (draw.mesh)
+	{
+	case MESH_BOX:
+		m_instancedMeshes->DrawBoxMeshInstanced(drawIndex, 1);
+		break;
+	case MESH_CONE:
+		m_instancedMeshes->DrawConeMeshInstanced(drawIndex, 1);
+		break;
+	case MESH_CYLINDER:
+		m_instancedMeshes->DrawCylinderMeshInstanced(drawIndex, 1,
+			(draw.meshParts & CYLINDER_TOP) != 0,
+			(draw.meshParts & CYLINDER_BOTTOM) != 0,
+			(draw.meshParts & CYLINDER_SIDES) != 0,
+			draw.lod);
+		break;
+	case MESH_PLANE:
+		m_instancedMeshes->DrawPlaneMeshInstanced(drawIndex, 1);
+		break;
+	case MESH_SPHERE:
+		m_instancedMeshes->DrawSphereMeshInstanced(drawIndex, 1, draw.lod);
+		break;
+	case MESH_TORUS:
+		m_instancedMeshes->DrawTorusMeshInstanced(drawIndex, 1, draw.lod);
+		break;
+	}
+	m_frameStats.drawCalls++;
+}
+
+/***********************************************************
+ *  RenderMug()
+ *
+ *  Renders complete coffee mug with components by calling
+ *  component render methods in proper sequence.
+ *
+ *  ARTISTIC CHOICE: Coffee mug as centerpiece of workspace
+ *  scene. Complex object demonstrating multi-primitive
+ *  composition with varied materials and textures.
+ ***********************************************************/
+void SceneManager::RenderMug()
+{
+	TRACE_SCOPE("RenderMug");
+	RenderMugBody();
+	RenderMugInterior();
+	RenderCoffee();
+	RenderMugHandle();
+	RenderMugBase();
+}
+
+/***********************************************************
+ *  RenderTablePlane()
+ *
+ *  Renders desk table surface as a low-profile box with
+ *  tiled oak wood texture. This forms the base plane of the
+ *  entire scene upon which all other objects rest.
+ *
+ *  ARTISTIC CHOICE: Natural oak wood provides warm, organic
+ *  foundation for the scene. Tiling at 6x demonstrates the
+ *  complex texturing technique requirement while creating
+ *  realistic wood grain detail across the large 20x20 plane.
+ *
+ *  CS330 REQUIREMENTS FULFILLED:
+ *  - TILED TEXTURE: UV scale 6.0x6.0 (required: >1.0)
+ ***********************************************************/
+void SceneManager::RenderTablePlane()
+{
+	TRACE_SCOPE("RenderTablePlane");
+	// Apply TILED oak wood texture (Complex Texturing Technique Requirement)
+	SetShaderTexture(m_textures.oak);
+	SetTextureUVScale(UV_SCALE_TILED_TEXTURE, UV_SCALE_TILED_TEXTURE);  // 6x6 tiling
+	SetShaderMaterial(m_materials.wood);
+
+	// Transformation parameters for table surface
+	// Scale: 20x20 plane with 0.5 height for thickness
+	// Position: Centered at origin (0,0,0), lowered by -0.25 so top surface is at Y=0
+	glm::vec3 scaleXYZ = glm::vec3(20.0f, 0.5f, 20.0f);
+	float XrotationDegrees = ROTATION_NONE;
+	float YrotationDegrees = ROTATION_NONE;
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(0.0f, -0.25f, 0.0f);
+
+	// Apply transformations (Scale → Rotate → Translate)
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+
+	// Draw the box mesh (creates table with visible thickness)
+	SubmitMesh(MESH_BOX);
+}
+
+/***********************************************************
+ *  RenderMugBody()
+ *
+ *  Renders the outer shell of the coffee mug as an open-top
+ *  cylinder with grey marble texture. This is part of the
+ *  complex multi-primitive mug object.
+ *
+ *  ARTISTIC CHOICE: Grey marble creates an elegant, premium
+ *  appearance. The natural veining adds visual interest while
+ *  maintaining the neutral color palette. Cylindrical mapping
+ *  on complex shape demonstrates advanced texture techniques.
+ ***********************************************************/
+void SceneManager::RenderMugBody()
+{
+	TRACE_SCOPE("RenderMugBody");
+	// Apply grey marble texture to mug body
+	// UV scale 2.0 horizontal wraps texture twice around circumference
+	SetShaderTexture(m_textures.marble);
+	SetTextureUVScale(UV_SCALE_MUG_BODY_U, UV_SCALE_MUG_BODY_V);  // 2.0x1.0
+	SetShaderMaterial(m_materials.marble);
+
+	// Transformation parameters for mug outer cylinder
+	// Scale: 0.9 diameter, 2.25 height (scaled down 25% from original design)
+	// Rotation Y: 25° rotates marble seam away from camera view
+	// Position: Left side of table at (-5, 1.125, 1), adjusted by vertical offset
+	glm::vec3 scaleXYZ = glm::vec3(0.9f, 2.25f, 0.9f);
+	float XrotationDegrees = ROTATION_NONE;          // Upright cylinder
+	float YrotationDegrees = ROTATION_MUG_SEAM;      // Rotate texture seam away from view
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(-5.0f, 1.125f + m_mugVerticalOffset, 1.0f);
+
+	// Apply transformations (Scale → Rotate → Translate)
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+
+	// Draw cylinder without top cap to create open mug
+	SubmitMesh(MESH_CYLINDER, CYLINDER_BOTTOM | CYLINDER_SIDES);  // top=false, bottom=true, sides=true
+}
+
+/***********************************************************
+ *  RenderMugInterior()
+ *
+ *  Renders interior cylinder of mug with pale wall texture.
+ *  Slightly smaller diameter than outer body creates visible
+ *  wall thickness and hollow cavity.
+ *
+ *  ARTISTIC CHOICE: Creates hollow mug interior visible from
+ *  above. Uses pale wall texture to contrast with marble
+ *  exterior and suggest a ceramic glazed interior surface.
+ ***********************************************************/
+void SceneManager::RenderMugInterior()
+{
+	TRACE_SCOPE("RenderMugInterior");
+	// Apply pale wall texture to interior (creates light interior surface)
+	SetShaderTexture(m_textures.paleWall);
+	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);  // 1:1 mapping
+	SetShaderMaterial(m_materials.ceramic);
+
+	// Transformation parameters for interior cylinder
+	// Scale: 0.81 diameter (0.09 smaller than 0.9 outer = visible wall thickness)
+	//        2.025 height (slightly shorter than 2.25 outer)
+	// Rotation Y: 25° matches outer body seam alignment
+	// Position: Same X,Z as body, slightly lower Y for positioning
+	glm::vec3 scaleXYZ = glm::vec3(0.81f, 2.025f, 0.81f);
+	float XrotationDegrees = ROTATION_NONE;
+	float YrotationDegrees = ROTATION_MUG_SEAM;  // Align with outer body
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(-5.0f, 1.0125f + m_mugVerticalOffset, 1.0f);
+
+	// Apply transformations (Scale → Rotate → Translate)
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+
+	// Draw cylinder sides only (no caps) to create hollow interior cavity
+	SubmitMesh(MESH_CYLINDER, CYLINDER_SIDES);  // top=false, bottom=false, sides=true
+}
+
+/***********************************************************
+ *  RenderCoffee()
+ *
+ *  Renders coffee liquid inside the mug as a solid-color
+ *  cylinder. Uses color-based rendering (no texture) to
+ *  demonstrate both texture and color rendering techniques.
+ *
+ *  ARTISTIC CHOICE: Brown cylinder fills mug to ~85% height
+ *  to simulate coffee. Top cap creates visible liquid surface.
+ ***********************************************************/
+void SceneManager::RenderCoffee()
+{
+	TRACE_SCOPE("RenderCoffee");
+	// Transformation parameters for coffee cylinder
+	// Scale: 0.795 diameter (slightly smaller than 0.81 interior)
+	//        1.95 height (fills mug to ~85%, high enough to hide handle attachment)
+	// Position: Same X,Z as mug, positioned to sit inside interior
+	glm::vec3 scaleXYZ = glm::vec3(0.795f, 1.95f, 0.795f);
+	float XrotationDegrees = ROTATION_NONE;
+	float YrotationDegrees = ROTATION_NONE;
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(-5.0f, 1.095f + m_mugVerticalOffset, 1.0f);
+
+	// Apply transformations (Scale → Rotate → Translate)
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+
+	// Render as solid color (no texture) to demonstrate color rendering technique
+	// Explicitly disable texture to avoid inheriting previous object's texture state
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.coffee);
+	SetShaderColor(COLOR_COFFEE_R, COLOR_COFFEE_G, COLOR_COFFEE_B, COLOR_ALPHA_OPAQUE);
+
+	// Draw cylinder with top cap (creates visible liquid surface)
+	SubmitMesh(MESH_CYLINDER, CYLINDER_TOP | CYLINDER_SIDES);  // top=true, bottom=false, sides=true
+
+	// Restore texture state for subsequent draws
+	SetTextureEnabled(true);
+	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
+}
+
+/***********************************************************
+ *  RenderMugHandle()
+ *
+ *  Renders mug handle as a vertical torus (donut shape)
+ *  rotated 90° on Z-axis. Attached to right side of mug body.
+ *
+ *  ARTISTIC CHOICE: Pale plaster/wall texture provides light
+ *  contrast against the darker marble body. This creates visual
+ *  separation and hierarchy, drawing attention to the handle
+ *  while maintaining cohesion through neutral tones.
+ ***********************************************************/
+void SceneManager::RenderMugHandle()
+{
+	TRACE_SCOPE("RenderMugHandle");
+	// Apply pale wall texture to handle
+	SetShaderTexture(m_textures.paleWall);
+	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
+	SetShaderMaterial(m_materials.ceramic);
+
+	// Transformation parameters for handle torus
+	// Scale: 0.6 outer radius, 0.3 inner radius, 0.225 thickness
+	// Rotation Z: 90° rotates torus vertical (default torus is horizontal)
+	// Position: Right side of mug at X=-4.04 (mug center -5.0 + radius 0.9 + offset 0.06)
+	//           Mid-height at Y=2.16 for ergonomic placement
+	glm::vec3 scaleXYZ = glm::vec3(0.6f, 0.3f, 0.225f);
+	float XrotationDegrees = ROTATION_NONE;
+	float YrotationDegrees = ROTATION_NONE;
+	float ZrotationDegrees = ROTATION_QUARTER_TURN;  // Make torus vertical
+	glm::vec3 positionXYZ = glm::vec3(-4.04f, 2.16f + m_mugVerticalOffset, 1.0f);
+
+	// Apply transformations (Scale → Rotate → Translate)
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+
+	// Draw the torus mesh
+	SubmitMesh(MESH_TORUS);
+}
+
+/***********************************************************
+ *  RenderMugBase()
+ *
+ *  Renders mug base rim as a horizontal torus (donut shape)
+ *  rotated 90° on X-axis. Forms decorative rim at bottom of mug.
+ *
+ *  ARTISTIC CHOICE: Industrial cracked cement provides visual
+ *  weight and grounds the composition. The weathered, textured
+ *  appearance adds character and contrasts with the smooth
+ *  marble body, creating an eclectic artistic aesthetic.
+ ***********************************************************/
+void SceneManager::RenderMugBase()
+{
+	TRACE_SCOPE("RenderMugBase");
+	// Apply cracked cement texture to base rim
+	SetShaderTexture(m_textures.cement);
+	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
+	SetShaderMaterial(m_materials.concrete);
+
+	// Transformation parameters for base rim torus
+	// Scale: 0.7125 outer radius (slightly smaller than mug body 0.9)
+	//        0.75 inner radius, creates thick rim appearance
+	// Rotation X: 90° makes torus horizontal (default is in XY plane)
+	// Position: Bottom of mug at Y=0.1875, same X,Z as mug body
+	glm::vec3 scaleXYZ = glm::vec3(0.7125f, 0.75f, 0.7125f);
+	float XrotationDegrees = ROTATION_QUARTER_TURN;  // Make torus horizontal
+	float YrotationDegrees = ROTATION_NONE;
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(-5.0f, 0.1875f, 1.0f);
+
+	// Apply transformations (Scale → Rotate → Translate)
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+
+	// Draw the torus mesh
+	SubmitMesh(MESH_TORUS);
+}
+
+/***********************************************************
+ *  RenderBlueSphere()
+ *
+ *  Renders blue rubber stress ball with partial texture
+ *  mapping. This demonstrates the CS330 partial texture
+ *  requirement by using UV coordinates < 1.0 to display
+ *  only a portion of the texture image.
+ *
+ *  ARTISTIC CHOICE: Vibrant blue stress ball adds pop of
+ *  color to the neutral workspace palette and reinforces
+ *  the desk workspace theme. Positioned front-left to create
+ *  visual balance and draw the eye.
+ *
+ *  CS330 REQUIREMENTS FULFILLED:
+ *  - PARTIAL TEXTURE: UV scale 0.75x0.75 (displays upper-left 75%)
+ ***********************************************************/
+void SceneManager::RenderBlueSphere()
+{
+	TRACE_SCOPE("RenderBlueSphere");
+	// Apply rubber coating texture with PARTIAL UV mapping (Complex Texturing Technique Requirement)
+	// UV scale < 1.0 displays only a portion of the texture
+	SetShaderTexture(m_textures.rubber);
+	SetTextureUVScale(UV_SCALE_PARTIAL_TEXTURE, UV_SCALE_PARTIAL_TEXTURE);  // 0.75x0.75
+	SetShaderMaterial(m_materials.rubber);
+
+	// Transformation parameters for stress ball
+	// Scale: 0.8 uniform (creates sphere with radius 0.8)
+	// Position: Front-left at (-5.5, 0.8, 3.5)
+	//   - Y=0.8 places sphere tangent to table surface (table top at Y=0.0, radius=0.8)
+	//   - X=-5.5 positions near mug for visual grouping
+	//   - Z=3.5 places forward for depth layering
+	glm::vec3 scaleXYZ = glm::vec3(0.8f, 0.8f, 0.8f);
+	float XrotationDegrees = ROTATION_NONE;
+	float YrotationDegrees = ROTATION_NONE;
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(-5.5f, 0.8f, 3.5f);
+
+	// Apply transformations (Scale → Rotate → Translate)
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+
+	// Draw the sphere mesh
+	SubmitMesh(MESH_SPHERE);
+}
+
+/***********************************************************
+ *  RenderKeyboard()
+ *
+ *  Renders keyboard with realistic three-section layout:
+ *  - Layer 1: Black plastic housing/frame
+ *  - Layer 2: Three separate key sections (left main, middle nav, right numpad)
+ *
+ *  ARTISTIC CHOICE: Three-section layout mimics real keyboard design
+ *  with visible gaps showing black frame underneath. Uses only 4 box
+ *  primitives total while creating convincing keyboard appearance.
+ ***********************************************************/
+void SceneManager::RenderKeyboard()
+{
+	TRACE_SCOPE("RenderKeyboard");
+	// Layer 1: Black plastic keyboard frame/housing
+	// Using solid color rendering (no texture) for matte plastic appearance
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.plastic);
+	SetShaderColor(COLOR_BLACK_PLASTIC_R, COLOR_BLACK_PLASTIC_G, COLOR_BLACK_PLASTIC_B, COLOR_ALPHA_OPAQUE);
+
+	// Transformation parameters for keyboard base frame
+	// Scale: 9.0 wide x 0.10 thin x 3.0 deep (3:1 width:depth ratio)
+	// Position: Centered at X=0, forward at Z=4.0 (front-center of desk)
+	//   - Y=0.05 sits just above table surface (table top at Y=0.0)
+	glm::vec3 scaleXYZ = glm::vec3(9.0f, 0.10f, 3.0f);
+	float XrotationDegrees = ROTATION_NONE;
+	float YrotationDegrees = ROTATION_NONE;
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(0.0f, 0.05f, 4.0f);
+
+	// Apply transformations and draw frame
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Layer 2: Three separate key sections (raised above frame)
+	// Lighter grey color distinguishes keys from black frame
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.plastic);
+	SetShaderColor(COLOR_GREY_KEYS_R, COLOR_GREY_KEYS_G, COLOR_GREY_KEYS_B, COLOR_ALPHA_OPAQUE);
+
+	// Left section - Main keyboard area
+	// Largest section containing letter keys, numbers, and main function keys
+	scaleXYZ = glm::vec3(5.0f, 0.05f, 2.8f);  // 5.0 wide, very thin 0.05 height
+	positionXYZ = glm::vec3(-1.8f, 0.13f, 4.0f);  // Left side, raised to Y=0.13
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Middle section - Navigation/function area
+	// Home/End/Page keys and arrow cluster
+	scaleXYZ = glm::vec3(1.5f, 0.05f, 2.8f);  // Narrower than main area
+	positionXYZ = glm::vec3(1.75f, 0.13f, 4.0f);  // Gap creates visual separation
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Right section - Numpad area
+	// Number pad with calculator-style layout
+	scaleXYZ = glm::vec3(1.5f, 0.05f, 2.8f);  // Same size as middle section
+	positionXYZ = glm::vec3(3.55f, 0.13f, 4.0f);  // Equal gap from middle
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Restore texture state for subsequent textured draws
+	SetTextureEnabled(true);
+	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
+}
+
+/***********************************************************
+ *  RenderTouchpad()
+ *
+ *  Renders touchpad with two-layer flush design:
+ *  - Layer 1: Black plastic frame/border
+ *  - Layer 2: Grey touch surface (minimally raised)
+ *
+ *  ARTISTIC CHOICE: Square touchpad positioned right of
+ *  keyboard creates balanced workspace composition. Flush
+ *  surface design (vs raised keyboard keys) reflects realistic
+ *  touchpad appearance. Uses only 2 box primitives for
+ *  extremely low polygon count.
+ ***********************************************************/
+void SceneManager::RenderTouchpad()
+{
+	TRACE_SCOPE("RenderTouchpad");
+	// Layer 1: Black plastic touchpad frame/border
+	// Using solid color rendering (no texture) matching keyboard style
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.plastic);
+	SetShaderColor(COLOR_BLACK_PLASTIC_R, COLOR_BLACK_PLASTIC_G, COLOR_BLACK_PLASTIC_B, COLOR_ALPHA_OPAQUE);
+
+	// Transformation parameters for touchpad base frame
+	// Scale: 2.0x2.0 square (much smaller than keyboard)
+	// Position: Right of keyboard at X=6.0, same Z=4.0 and Y=0.05
+	glm::vec3 scaleXYZ = glm::vec3(2.0f, 0.10f, 2.0f);
+	float XrotationDegrees = ROTATION_NONE;
+	float YrotationDegrees = ROTATION_NONE;
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(6.0f, 0.05f, 4.0f);
+
+	// Apply transformations and draw frame
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Layer 2: Grey touch surface (minimally raised above frame)
+	// Slightly smaller than frame to expose border, creating realistic look
+	SetShaderMaterial(m_materials.plastic);
+	SetShaderColor(COLOR_GREY_KEYS_R, COLOR_GREY_KEYS_G, COLOR_GREY_KEYS_B, COLOR_ALPHA_OPAQUE);
+
+	// Transformation parameters for touch surface
+	// Scale: 1.8x1.8 (0.2 smaller than 2.0 frame exposes 0.1 border on each side)
+	//        0.05 height (half the 0.10 frame height, creates subtle raised appearance)
+	// Position: Same X,Z as frame, raised to Y=0.08 (0.03 above frame top at Y=0.05+0.05=0.10 → 0.08 creates flush look)
+	scaleXYZ = glm::vec3(1.8f, 0.05f, 1.8f);
+	positionXYZ = glm::vec3(6.0f, 0.08f, 4.0f);
+
+	// Apply transformations and draw surface
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Restore texture state for subsequent textured draws
+	SetTextureEnabled(true);
+	SetTextureUVScale(UV_SCALE_DEFAULT, UV_SCALE_DEFAULT);
+}
+
+/***********************************************************
+ *  RenderMonitor()
+ *
+ *  Renders complete flat screen monitor with stand by calling
+ *  component render methods in proper sequence.
+ *
+ *  ARTISTIC CHOICE: Modern minimalist monitor design with
+ *  central stand creates professional workspace aesthetic.
+ *  Positioned behind keyboard as visual focal point.
+ ***********************************************************/
+void SceneManager::RenderMonitor()
+{
+	TRACE_SCOPE("RenderMonitor");
+	RenderMonitorBase();
+	RenderMonitorPole();
+	RenderMonitorConnector();
+	RenderMonitorFrame();
+	RenderMonitorScreen();
+}
+
+/***********************************************************
+ *  RenderMonitorBase()
+ *
+ *  Renders monitor stand base as flattened sphere.
+ *
+ *  ARTISTIC CHOICE: Flattened sphere creates modern, stable
+ *  base design similar to contemporary monitor stands.
+ ***********************************************************/
+void SceneManager::RenderMonitorBase()
+{
+	TRACE_SCOPE("RenderMonitorBase");
+	// Disable textures - using solid colors
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.plastic);
+	SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
+
+	// Set transformations for flattened sphere base
+	glm::vec3 scaleXYZ = glm::vec3(2.5f, 0.15f, 2.5f);  // Larger flattened sphere for stability with wider monitor
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ = glm::vec3(0.0f, 0.15f, -2.5f);  // Moved forward, behind mug
+
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_SPHERE);
+
+	// Restore texture state
+	SetTextureEnabled(true);
+	SetTextureUVScale(1.0f, 1.0f);
+}
+
+/***********************************************************
+ *  RenderMonitorPole()
+ *
+ *  Renders monitor stand pole as tall thin rectangle.
+ *
+ *  ARTISTIC CHOICE: Thin rectangular pole provides minimal
+ *  visual obstruction while supporting monitor display.
+ ***********************************************************/
+void SceneManager::RenderMonitorPole()
+{
+	TRACE_SCOPE("RenderMonitorPole");
+	// Disable textures - using solid colors
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.plastic);
+	SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
+
+	// Set transformations for vertical rectangular pole
+	// Monitor bottom at Y=2.0, height=6.1875, so top at Y=8.1875
+	// Pole extends to 3/4 monitor height = 4.640625, so top at Y=6.640625
+	// Pole goes from Y=0.3 (base top) to Y=6.640625, height=6.340625, center at Y=3.4703125
+	glm::vec3 scaleXYZ = glm::vec3(0.5f, 6.340625f, 0.2f);  // Wide thin rectangle, extended for taller monitor
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ = glm::vec3(0.0f, 3.4703125f, -2.5f);  // Moved forward with base
+
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Restore texture state
+	SetTextureEnabled(true);
+	SetTextureUVScale(1.0f, 1.0f);
+}
+
+/***********************************************************
+ *  RenderMonitorConnector()
+ *
+ *  Renders connector as small horizontal cylinder bridging
+ *  post to monitor back.
+ *
+ *  ARTISTIC CHOICE: Horizontal cylinder arm connects post
+ *  to monitor center, parallel to desk surface.
+ ***********************************************************/
+void SceneManager::RenderMonitorConnector()
+{
+	TRACE_SCOPE("RenderMonitorConnector");
+	// Disable textures - using solid colors
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.plastic);
+	SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
+
+	// Set transformations for horizontal cylinder connector
+	// Connects post front to monitor back
+	// Cylinder rotated 90° on X-axis to make it horizontal (pointing in Z direction)
+	glm::vec3 scaleXYZ = glm::vec3(0.15f, 0.35f, 0.15f);  // Horizontal cylinder, length 0.35
+	float XrotationDegrees = 90.0f;  // Rotate to horizontal (point in Z direction)
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ = glm::vec3(0.0f, 5.09375f, -2.388f);  // Moved forward, aligned with monitor center height
+
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_CYLINDER);
+
+	// Restore texture state
+	SetTextureEnabled(true);
+	SetTextureUVScale(1.0f, 1.0f);
+}
+
+/***********************************************************
+ *  RenderMonitorFrame()
+ *
+ *  Renders monitor outer frame/bezel as thin rectangle.
+ *
+ *  ARTISTIC CHOICE: Semi-gloss black frame with 16:9 aspect
+ *  ratio creates realistic modern monitor appearance.
+ ***********************************************************/
+void SceneManager::RenderMonitorFrame()
+{
+	TRACE_SCOPE("RenderMonitorFrame");
+	// Disable textures - using solid colors
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.semiGlossPlastic);
+	SetShaderColor(0.08f, 0.08f, 0.08f, 1.0f);
+
+	// Set transformations for monitor frame
+	glm::vec3 scaleXYZ = glm::vec3(11.0f, 6.1875f, 0.3f);  // 16:9 aspect ratio, increased width
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ = glm::vec3(0.0f, 5.09375f, -2.05f);  // Moved forward: bottom at Y=2.0, top at Y=8.1875
+
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Restore texture state
+	SetTextureEnabled(true);
+	SetTextureUVScale(1.0f, 1.0f);
+}
+
+/***********************************************************
+ *  RenderMonitorScreen()
+ *
+ *  Renders monitor display screen as glossy black rectangle.
+ *
+ *  ARTISTIC CHOICE: Glossy black screen with high specular
+ *  creates realistic powered-off LCD display appearance.
+ ***********************************************************/
+void SceneManager::RenderMonitorScreen()
+{
+	TRACE_SCOPE("RenderMonitorScreen");
+	// Disable textures - using solid colors
+	SetTextureEnabled(false);
+	SetShaderMaterial(m_materials.screen);
+	SetShaderColor(0.02f, 0.02f, 0.02f, 1.0f);
+
+	// Set transformations for screen (slightly smaller than frame, inset)
+	glm::vec3 scaleXYZ = glm::vec3(10.6f, 5.8875f, 0.25f);  // Smaller than frame to create bezel
+	float XrotationDegrees = 0.0f;
+	float YrotationDegrees = 0.0f;
+	float ZrotationDegrees = 0.0f;
+	glm::vec3 positionXYZ = glm::vec3(0.0f, 5.09375f, -2.0f);  // Moved forward, aligned with frame center, slightly forward
+
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+	SubmitMesh(MESH_BOX);
+
+	// Restore texture state
+	SetTextureEnabled(true);
+	SetTextureUVScale(1.0f, 1.0f);
+}
+
+/***********************************************************
+ *  RenderWall()
+ *
+ *  Renders background wall behind desk and monitor as a
+ *  large vertical plane. Provides visual backdrop that
+ *  enhances monitor visibility.
+ *
+ *  ARTISTIC CHOICE: Light-colored wall provides contrast
+ *  for dark monitor, adds realism to workspace setting,
+ *  and frames the scene with defined background boundary.
+ ***********************************************************/
+void SceneManager::RenderWall()
+{
+	TRACE_SCOPE("RenderWall");
+	// Apply pale wall texture with 2x2 tiling for subtle texture detail
+	SetShaderTexture(m_textures.paleWall);
+	SetTextureUVScale(UV_SCALE_WALL_TEXTURE, UV_SCALE_WALL_TEXTURE);  // 2.0x2.0
+	SetShaderMaterial(m_materials.wall);
+
+	// Transformation parameters for background wall
+	// Scale: 25.0 wide (wider than 20.0 table), 13.0 tall, 1.0 depth
+	// Position: Centered at X=0, far back at Z=-10, centered at Y=6.0
+	//   - With 13.0 height and center at Y=6.0, wall extends from Y=-0.5 to Y=12.5
+	//   - Positioned at back edge of table, behind all scene objects
+	glm::vec3 scaleXYZ = glm::vec3(25.0f, 13.0f, 1.0f);
+	float XrotationDegrees = ROTATION_NONE;
+	float YrotationDegrees = ROTATION_NONE;
+	float ZrotationDegrees = ROTATION_NONE;
+	glm::vec3 positionXYZ = glm::vec3(0.0f, 6.0f, -10.0f);
+
+	// Apply transformations (Scale → Rotate → Translate)
+	SetTransformations(scaleXYZ, XrotationDegrees, YrotationDegrees,
+		ZrotationDegrees, positionXYZ);
+
+	// Draw the box mesh (forms wall plane)
+	SubmitMesh(MESH_BOX);
+}
+
+/***********************************************************
+ *  SetShaderUniforms()
+ *
+ *  This method is used for passing in the uniform locations
+ *  resolved after the shaders were loaded. All shader values
+ *  are uploaded through these locations. Their program is
+ *  made current through the state cache, so that the cache
+ *  files later uniform writes under it.
+ ***********************************************************/
+void SceneManager::SetShaderUniforms(const ShaderUniforms* pUniforms)
+{
+	m_pUniforms = pUniforms;
+	if (nullptr != m_pUniforms)
+	{
+		m_stateCache.UseProgram(m_pUniforms->programID);
+	}
+}
+
+/***********************************************************
+ *  GetStateCache()
+ *
+ *  This method returns the state cache that the scene writes
+ *  GL state and uniforms through. Other code writing the same
+ *  state should use it too, so the cache stays accurate.
+ ***********************************************************/
+GLStateCache* SceneManager::GetStateCache()
+{
+	return &m_stateCache;
+}
+
+/***********************************************************
+ *  SetDepthPrepass()
+ *
+ *  This method turns the depth-only pre-pass on or off for
+ *  the following frames. The pre-pass costs a second
+ *  submission of the geometry but lights each visible pixel
+ *  only once; which is cheaper depends on the GPU.
+ ***********************************************************/
+void SceneManager::SetDepthPrepass(bool bEnable)
+{
+	m_bDepthPrepass = bEnable;
+}
+
+/***********************************************************
+ *  SetDebugView()
+ *
+ *  This method selects the view drawn by the following frames.
+ *  The debug programs are built the first time a debug view
+ *  is selected; if they cannot be built, the shaded scene is
+ *  drawn instead.
+ ***********************************************************/
+void SceneManager::SetDebugView(DebugViews::VIEW view)
+{
+	if ((DebugViews::VIEW_SHADED != view) && (nullptr == m_debugViews))
+	{
+		m_debugViews = new DebugViews(&m_stateCache);
+		m_bDebugViewsReady = m_debugViews->Initialize();
+		if (!m_bDebugViewsReady)
+		{
+			std::cout << "Debug views are not available" << std::endl;
+		}
+	}
+	m_debugView = m_bDebugViewsReady ? view : DebugViews::VIEW_SHADED;
+}
+
+/***********************************************************
+ *  EnableGpuTiming()
+ *
+ *  This method starts timing the render groups, the depth
+ *  pre-pass and the occlusion queries on the GPU. Instanced
+ *  runs are split so that each holds one render group. Every
+ *  frame read is appended to the passed in CSV file, if any.
+ *  Returns false if the context has no timestamp queries.
+ ***********************************************************/
+bool SceneManager::EnableGpuTiming(const char* logFilename)
+{
+	if (!GpuTimers::IsSupported())
+	{
+		std::cout << "GPU timing is not supported by this context" << std::endl;
+		return false;
+	}
+
+	if (nullptr == m_gpuTimers)
+	{
+		m_gpuTimers = new GpuTimers(GPU_SCOPE_COUNT);
+		if (m_bInstancing)
+		{
+			BuildDrawCommands();
+		}
+	}
+
+	if (nullptr != logFilename)
+	{
+		m_gpuTimers->OpenLog(logFilename, std::vector<std::string>(GPU_SCOPE_NAMES, GPU_SCOPE_NAMES + GPU_SCOPE_COUNT));
+	}
+	return true;
+}
+
+/***********************************************************
+ *  GetGpuTimes()
+ *
+ *  This method returns the name and rolling average GPU time
+ *  in milliseconds of every timed scope, or nothing unless
+ *  GPU timing is enabled. Debug view frames are not timed.
+ ***********************************************************/
+void SceneManager::GetGpuTimes(std::vector<std::string>& names, std::vector<double>& averageMs) const
+{
+	names.clear();
+	averageMs.clear();
+	if (nullptr == m_gpuTimers)
+	{
+		return;
+	}
+
+	for (int scope = 0; scope < GPU_SCOPE_COUNT; scope++)
+	{
+		names.push_back(GPU_SCOPE_NAMES[scope]);
+		averageMs.push_back(m_gpuTimers->GetAverageMs(scope));
+	}
+}
+
+/***********************************************************
+ *  GetFrameStats()
+ *
+ *  This method returns the draw and uniform counters that
+ *  were collected by the most recent RenderScene() call.
+ ***********************************************************/
+const SceneManager::FRAME_STATS& SceneManager::GetFrameStats() const
+{
+	return m_frameStats;
+}
+
+/***********************************************************
+ *  LoadSceneFile()
+ *
+ *  This method loads a text or cooked binary scene file to be
+ *  drawn instead of the built-in scene. Call it before
+ *  PrepareScene(). Returns false, keeping the scene in use,
+ *  if the file could not be loaded.
+ ***********************************************************/
+bool SceneManager::LoadSceneFile(const std::string& filename)
+{
+	TRACE_SCOPE("LoadSceneFile");
+	SceneFile* sceneFile = new SceneFile();
+	if (!sceneFile->Load(filename))
+	{
+		delete sceneFile;
+		return false;
+	}
+
+	delete m_sceneFile;
+	m_sceneFile = sceneFile;
+	return true;
+}
+
+/***********************************************************
+ *  GetSceneFormat()
+ *
+ *  This method returns where the scene comes from: "built-in",
+ *  "text" or "binary".
+ ***********************************************************/
+const char* SceneManager::GetSceneFormat() const
+{
+	if (nullptr == m_sceneFile)
+	{
+		return "built-in";
+	}
+	return m_sceneFile->IsBinary() ? "binary" : "text";
+}
+
+/***********************************************************
+ *  SetSceneExport()
+ *
+ *  This method sets a file that PrepareScene() writes the
+ *  prepared scene to as text, as a starting point for scene
+ *  files. An empty name turns the export off.
+ ***********************************************************/
+void SceneManager::SetSceneExport(const std::string& filename)
+{
+	m_sceneExportPath = filename;
+}
@@ -1,157 +1,566 @@
-///////////////////////////////////////////////////////////////////////////////
-// shadermanager.h
-// ============
-// manage the loading and rendering of 3D scenes
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		float ambientStrength;
-		glm::vec3 ambientColor;
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-	struct DIRECTIONAL_LIGHT
-	{
-		glm::vec3 direction;
-		glm::vec3 ambient;
-		glm::vec3 diffuse;
-		glm::vec3 specular;
-		float focalStrength;
-		float specularIntensity;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// directional lights for scene illumination
-	static constexpr int NUM_DIR_LIGHTS = 5;
-	DIRECTIONAL_LIGHT m_dirLights[NUM_DIR_LIGHTS];
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-	// Coffee mug rendering methods
-	void RenderMug();
-	void RenderMugBody();
-	void RenderMugInterior();
-	void RenderCoffee();
-	void RenderMugHandle();
-	void RenderMugBase();
-	void RenderTablePlane();
-
-	// Desk object rendering methods
-	void RenderBlueSphere();
-	void RenderKeyboard();
-	void RenderTouchpad();
-
-	// Monitor rendering methods
-	void RenderMonitor();
-	void RenderMonitorBase();
-	void RenderMonitorPole();
-	void RenderMonitorConnector();
-	void RenderMonitorFrame();
-	void RenderMonitorScreen();
-
-	// Background rendering methods
-	void RenderWall();
-
-	// Texture and material setup methods
-	void LoadSceneTextures();
-	void DefineObjectMaterials();
-
-	// Lighting setup methods
-	void DefineLights();
-	void UploadLights();
-
-	// Mug positioning offset for proper alignment
-	float m_mugVerticalOffset;
-
-public:
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void PrepareScene();
-	void RenderScene();
-
+///////////////////////////////////////////////////////////////////////////////
+// shadermanager.h
+// ============
+// manage the loading and rendering of 3D scenes
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "DebugViews.h"
+#include "GLStateCache.h"
+#include "GpuTimers.h"
+#include "InstancedMeshes.h"
+#include "OcclusionQueries.h"
+#include "SceneFile.h"
+#include "ShaderManager.h"
+#include "ShaderUniforms.h"
+#include "ShapeMeshes.h"
+#include "TextureCache.h"
+#include "TextureStreamer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager);
+	// destructor
+	~SceneManager();
+
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		uint32_t ID;          // 0 once copied into a texture array
+		int arrayIndex;       // texture array holding the texture (-1 = none)
+		int layer;            // layer within the texture array
+		uint64_t handle;      // bindless handle (0 = none)
+	};
+
+	// image selected by a texture handle: a whole texture, or one
+	// image packed into the texture atlas
+	struct TEXTURE_REGION
+	{
+		std::string tag;
+		int slot;             // texture slot holding the image
+		glm::vec2 uvOffset;   // image origin within the texture
+		glm::vec2 uvScale;    // image size within the texture
+	};
+
+	// how draws select their texture
+	enum TEXTURE_BINDING
+	{
+		TEXTURE_BIND_ON_CHANGE,  // bind to texture unit 0 when the texture changes
+		TEXTURE_ARRAYS,          // select an array layer by uniform
+		TEXTURE_BINDLESS         // pass a resident handle by uniform
+	};
+
+	struct OBJECT_MATERIAL
+	{
+		float ambientStrength;
+		glm::vec3 ambientColor;
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	struct DIRECTIONAL_LIGHT
+	{
+		glm::vec3 direction;
+		glm::vec3 ambient;
+		glm::vec3 diffuse;
+		glm::vec3 specular;
+		float focalStrength;
+		float specularIntensity;
+	};
+
+	// basic shape meshes a draw can reference
+	enum SHAPE_MESH
+	{
+		MESH_BOX,
+		MESH_CONE,
+		MESH_CYLINDER,
+		MESH_PLANE,
+		MESH_SPHERE,
+		MESH_TORUS
+	};
+
+	// parts of a cylinder mesh to draw
+	enum CYLINDER_PARTS
+	{
+		CYLINDER_TOP = 1,
+		CYLINDER_BOTTOM = 2,
+		CYLINDER_SIDES = 4,
+		CYLINDER_ALL = CYLINDER_TOP | CYLINDER_BOTTOM | CYLINDER_SIDES
+	};
+
+	// scene objects, as drawn by the Render* orchestrator methods
+	enum RENDER_GROUP
+	{
+		GROUP_WALL,
+		GROUP_TABLE,
+		GROUP_MUG,
+		GROUP_SPHERE,
+		GROUP_KEYBOARD,
+		GROUP_TOUCHPAD,
+		GROUP_MONITOR,
+		GROUP_COUNT
+	};
+
+	// placement of an object, as passed to SetTransformations()
+	struct OBJECT_TRANSFORM
+	{
+		glm::vec3 scale;
+		glm::vec3 rotationDegrees;  // X, Y and Z rotation
+		glm::vec3 position;
+	};
+
+	// one mesh draw with all of the shader state it needs
+	struct DRAW_RECORD
+	{
+		glm::mat4 model;           // cached model matrix
+		glm::mat3 normalMatrix;    // cached inverse transpose of the model matrix
+		glm::vec3 boundsMin;       // world-space bounding box, rebuilt with the model matrix
+		glm::vec3 boundsMax;
+		glm::vec3 boundsCenter;    // world-space bounding sphere enclosing the box
+		float boundsRadius;
+		OBJECT_TRANSFORM transform;
+		glm::vec4 color;           // object color for the solid color path
+		glm::vec2 uvScale;         // texture coordinate scale
+		glm::vec2 uvOffset;        // texture coordinate offset (atlas images)
+		uint64_t sortKey;          // program -> texture -> material -> mesh
+		int texture;               // texture slot
+		int textureRegion;         // texture region the draw samples (-1 = none)
+		int material;              // material table index (-1 = unchanged)
+		bool bUseTexture;          // sample the texture instead of the color
+		SHAPE_MESH mesh;
+		unsigned int meshParts;    // CYLINDER_PARTS for cylinder meshes
+		RENDER_GROUP group;
+		int objectID;              // submission order, stable across sorting
+		bool bTransformDirty;      // matrices need rebuilding from transform
+		int lod;                   // level of detail drawn (0 = finest, instancing only)
+	};
+
+	// counters collected while rendering one frame
+	struct FRAME_STATS
+	{
+		int drawCalls;        // draw calls submitted (a multi-draw counts once)
+		int uniformUploads;   // uniform values written to the shader
+		int lightUploads;     // light set uploads (0 unless a light changed)
+		int transformUpdates; // model matrices rebuilt (0 unless an object moved)
+		int visibleObjects;   // objects inside the view frustum
+		int culledObjects;    // objects skipped by frustum culling
+		int occludedObjects;  // objects in view skipped as hidden by occlusion queries
+		int occlusionQueries; // bounding box queries issued
+		int reducedLodObjects;// visible objects drawn below full detail
+		int shadedFragments;  // samples passing the depth test in the color pass (previous frame)
+		int viewportPixels;   // pixels the color pass covers
+	};
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to the resolved shader uniform locations
+	const ShaderUniforms* m_pUniforms;
+	// shadow GL state that drops redundant state and uniform writes
+	GLStateCache m_stateCache;
+	// pointer to basic shapes object
+	ShapeMeshes* m_basicMeshes;
+	// pointer to instanced shapes object (only created when instancing)
+	InstancedMeshes* m_instancedMeshes;
+	// true when draws go through the instanced meshes
+	bool m_bInstancing;
+	// loaded textures info, indexed by texture slot
+	std::vector<TEXTURE_INFO> m_textureIDs;
+	// images selectable by the Render* methods, indexed by texture handle
+	std::vector<TEXTURE_REGION> m_textureRegions;
+	// texture region set by SetShaderTexture() for the next submitted draw
+	int m_pendingTextureRegion;
+	// texture selection method chosen by BindGLTextures()
+	TEXTURE_BINDING m_textureBinding;
+	// textures of equal size and format packed into layers
+	std::vector<GLuint> m_textureArrays;
+	// compressed copies of the textures kept between runs
+	TextureCache m_textureCache;
+	// loads replacement textures while rendering (created on first use)
+	TextureStreamer* m_textureStreamer;
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// uniform buffer holding all materials in std140 layout
+	GLuint m_materialsUBO;
+	// true when draws select materials from the uniform buffer
+	bool m_bMaterialTable;
+	// material index currently set in the shader (-1 = none)
+	int m_activeMaterial;
+
+	// directional lights for scene illumination
+	static constexpr int NUM_DIR_LIGHTS = 5;
+	static_assert(NUM_DIR_LIGHTS <= ShaderUniforms::MAX_LIGHTS, "shader declares fewer lights");
+	DIRECTIONAL_LIGHT m_dirLights[NUM_DIR_LIGHTS];
+	// uniform buffer mirroring m_dirLights in std140 layout
+	GLuint m_lightsUBO;
+	// true when m_dirLights changed since the last upload
+	bool m_bLightsDirty;
+
+	// statistics for the frame being rendered
+	FRAME_STATS m_frameStats;
+
+	// draws compiled by PrepareScene(), sorted by state key
+	std::vector<DRAW_RECORD> m_drawList;
+	// state collected by the Set* methods for the next submitted draw
+	DRAW_RECORD m_pendingDraw;
+	// run of adjacent draws issued as one instanced draw call
+	struct DRAW_BATCH
+	{
+		int firstDraw;   // draw list index, also the first instance
+		int drawCount;
+	};
+	// instanced batches over the draw list (empty unless instancing)
+	std::vector<DRAW_BATCH> m_drawBatches;
+	// run of indirect commands that share all shader state
+	struct COMMAND_RUN
+	{
+		int firstDraw;   // draw whose state the run applies
+		int endDraw;     // one past the last draw list index the run covers
+		int firstCommand;
+		int commandCount;
+		float depth;     // view depth of the run's nearest visible draw
+	};
+	// multi-draw runs over the indirect command buffer
+	std::vector<COMMAND_RUN> m_commandRuns;
+	// draw list index of each object ID
+	std::vector<int> m_objectDrawIndex;
+	// object IDs whose transform changed since the last frame
+	std::vector<int> m_dirtyTransforms;
+	// texture selected by the most recent draw (uniform values are
+	// filtered by the state cache instead)
+	DRAW_RECORD m_appliedDraw;
+
+	// view frustum planes (xyz = inward normal, w = distance)
+	glm::vec4 m_frustumPlanes[6];
+	// projection * view matrix the planes were extracted from
+	glm::mat4 m_viewProjection;
+	// clip z row of the view projection scaled to world units, giving
+	// a point's distance along the view direction in either projection
+	glm::vec4 m_viewDepthRow;
+	// clip w row and the projection's vertical scale, for projected
+	// object sizes
+	glm::vec4 m_clipWRow;
+	float m_projectionScale;
+	// false until SetViewProjection() has been called
+	bool m_bFrustumValid;
+	// framebuffer the scene is drawn into (0 = the window) and
+	// its size, which is also the viewport
+	GLuint m_targetFramebuffer;
+	int m_targetWidth;
+	int m_targetHeight;
+	// frustum test result of each draw list entry (1 = inside)
+	std::vector<unsigned char> m_drawInFrustum;
+	// draws issued by the main pass: in the frustum and not occluded
+	std::vector<unsigned char> m_drawVisible;
+	// occlusion query per draw list entry (null if unavailable)
+	OcclusionQueries* m_occlusionQueries;
+	// draws hidden last frame, drawn only if this frame's query passes
+	std::vector<int> m_conditionalDraws;
+	// visible draws (or command runs when instancing) ordered front
+	// to back for the current view
+	std::vector<int> m_drawOrder;
+	// view depth of each draw, filled while ordering
+	std::vector<float> m_drawDepth;
+	// true to lay down depth before the color pass shades anything
+	bool m_bDepthPrepass;
+	// counts the samples the color pass shades, read a frame late
+	GLuint m_fragmentQuery;
+	bool m_bFragmentQueryPending;
+	int m_shadedFragments;
+	// view drawn instead of the shaded scene, and its programs
+	DebugViews::VIEW m_debugView;
+	DebugViews* m_debugViews;
+	bool m_bDebugViewsReady;
+	// GPU time per render group (null unless enabled)
+	GpuTimers* m_gpuTimers;
+	// scene description drawn instead of the built-in scene (null = built-in)
+	SceneFile* m_sceneFile;
+	// file the prepared scene is written to as text (empty = none), and
+	// the scene collected for it while PrepareScene() runs
+	std::string m_sceneExportPath;
+	SceneFile* m_sceneExport;
+
+	// texture image of the scene and the tag the draws find it by
+	struct SCENE_TEXTURE
+	{
+		const char* filename;
+		const char* tag;
+		bool bAtlas;          // never drawn with a UV scale above 1
+	};
+
+	// texture region handles resolved from their tags in PrepareScene()
+	struct TEXTURE_HANDLES
+	{
+		int oak;
+		int marble;
+		int paleWall;
+		int cement;
+		int rubber;
+	};
+	TEXTURE_HANDLES m_textures;
+
+	// material table handles resolved from their tags in PrepareScene()
+	struct MATERIAL_HANDLES
+	{
+		int wood;
+		int marble;
+		int ceramic;
+		int concrete;
+		int coffee;
+		int rubber;
+		int plastic;
+		int semiGlossPlastic;
+		int screen;
+		int wall;
+	};
+	MATERIAL_HANDLES m_materials;
+
+	// load texture images and convert to OpenGL texture data
+	bool CreateGLTexture(const char* filename, const std::string& tag);
+	// add a created texture to the next available texture slot
+	int RegisterGLTexture(GLuint textureID, const std::string& tag);
+	// convert decoded image pixels to OpenGL texture data
+	bool CreateGLTextureFromImage(
+		const char* filename,
+		const std::string& tag,
+		const unsigned char* image,
+		int width,
+		int height,
+		int colorChannels);
+	// prepare the loaded OpenGL textures for selection by slot
+	void BindGLTextures();
+	// pack textures of equal size and format into texture arrays
+	bool CreateTextureArrays();
+	// make every texture resident behind a bindless handle
+	bool CreateBindlessHandles();
+	// make the texture in a slot the one sampled by the next draw
+	int SelectTexture(int textureSlot);
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// swap in the replacement textures whose uploads have completed
+	void UpdateTextureStreaming();
+	// replace the texture in a slot, keeping its selection method
+	bool ReplaceGLTexture(int textureSlot, GLuint textureID);
+	// give a texture slot its own one-layer texture array
+	bool AddTextureArray(int textureSlot, GLuint textureID);
+	// add a streamed texture in a new slot with no texture region
+	int RegisterStreamedTexture(GLuint textureID, const std::string& tag);
+	// make a texture region, and the draws sampling it, use a whole texture slot
+	void RepointTextureRegion(int textureRegion, int textureSlot);
+	// find a loaded texture image by tag
+	int FindTextureRegion(const std::string& tag) const;
+	// find a defined material by tag
+	int FindMaterialIndex(const std::string& tag) const;
+	// resolve the texture and material tags used by the scene to handles
+	void InternSceneHandles();
+	// texture images of the scene file, or of the built-in scene
+	void GetSceneTextures(std::vector<SCENE_TEXTURE>& textures) const;
+	// take the materials, lights and objects from the scene file
+	void DefineSceneFileMaterials();
+	void DefineSceneFileLights();
+	void SubmitSceneFileObjects();
+	// collect the textures, materials and lights of the scene to export
+	void BeginSceneExport();
+	// add the object about to be submitted to the scene to export
+	void ExportSceneObject(SHAPE_MESH mesh, unsigned int meshParts);
+	// pack all defined materials into the material table
+	void UploadMaterials();
+
+	// compile the scene into the sorted draw list
+	void BuildDrawList();
+	// add a draw of the given mesh with the current state to the draw list
+	void SubmitMesh(SHAPE_MESH mesh, unsigned int meshParts = CYLINDER_ALL);
+	// group adjacent draws that differ only in per-instance values
+	void BuildDrawBatches();
+	// copy the transform, color and material of every draw to the instance buffer
+	void UploadInstances();
+	// fill the indirect command buffer from the visible draws of the batches
+	void BuildDrawCommands();
+	// test every draw against the view frustum, true if any result changed
+	bool CullDrawList();
+	// pick the level of detail of every visible draw, true if any changed
+	bool UpdateDrawLods();
+	// view depth of the nearest point of a draw's bounding sphere
+	float GetViewDepth(const DRAW_RECORD& draw) const;
+	// order the visible draws front to back
+	void SortDrawOrder();
+	// draw the visible draws in front to back order, optionally
+	// writing depth only
+	void DrawOpaque(bool bDepthOnly);
+	// fill the depth buffer and switch the color pass to GL_EQUAL
+	void RenderDepthPrepass();
+	// read the color pass sample count once the GPU has it
+	void ReadFragmentCount();
+	// start and end counting the samples of the color pass
+	bool BeginFragmentCount();
+	void EndFragmentCount(bool bCounting);
+	// draw the active debug view instead of the shaded scene
+	void RenderDebugView();
+	// draw the visible draws in order with the debug program
+	void DrawDebugObjects();
+	// true if a draw's bounds intersect the view frustum
+	bool IsInFrustum(const DRAW_RECORD& draw) const;
+	// true if a draw's bounds cross the near plane, where box queries are unreliable
+	bool CrossesNearPlane(const DRAW_RECORD& draw) const;
+	// query the boxes of the draws in view against the finished frame
+	void RunOcclusionQueries();
+	// draw one entry of the draw list on its own
+	void DrawObject(int drawIndex);
+	// rebuild the cached model and normal matrices of a draw
+	void UpdateModelMatrix(DRAW_RECORD& draw);
+	// rebuild the world-space bounds of a draw from its model matrix
+	void UpdateWorldBounds(DRAW_RECORD& draw);
+	// rebuild the matrices of every object marked dirty
+	void UpdateDirtyTransforms();
+	// write the state of a draw that differs from the previous draw
+	void ApplyDrawState(const DRAW_RECORD& draw);
+	// write the state shared by every instance of a batch
+	void ApplyBatchState(const DRAW_RECORD& draw);
+	// write the texture selection of a draw
+	void ApplySurfaceState(const DRAW_RECORD& draw);
+	// select a material, by index or by material uniforms
+	void ApplyMaterial(int materialIndex);
+	// issue the draw command for a mesh
+	void DrawShapeMesh(SHAPE_MESH mesh, unsigned int meshParts);
+
+	// set the transformation values 
+	// into the transform buffer
+	void SetTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the color values into the shader
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// set the texture data into the shader
+	void SetShaderTexture(
+		int textureRegion);
+
+	// enable or disable texture sampling in the shader
+	void SetTextureEnabled(
+		bool bEnabled);
+
+	// set the UV scale for the texture mapping
+	void SetTextureUVScale(
+		float u, float v);
+
+	// set the object material into the shader
+	void SetShaderMaterial(
+		int materialIndex);
+
+	// Coffee mug rendering methods
+	void RenderMug();
+	void RenderMugBody();
+	void RenderMugInterior();
+	void RenderCoffee();
+	void RenderMugHandle();
+	void RenderMugBase();
+	void RenderTablePlane();
+
+	// Desk object rendering methods
+	void RenderBlueSphere();
+	void RenderKeyboard();
+	void RenderTouchpad();
+
+	// Monitor rendering methods
+	void RenderMonitor();
+	void RenderMonitorBase();
+	void RenderMonitorPole();
+	void RenderMonitorConnector();
+	void RenderMonitorFrame();
+	void RenderMonitorScreen();
+
+	// Background rendering methods
+	void RenderWall();
+
+	// Texture and material setup methods
+	void LoadSceneTextures();
+	void DefineObjectMaterials();
+
+	// Lighting setup methods
+	void DefineLights();
+	void UploadLights();
+
+	// Mug positioning offset for proper alignment
+	float m_mugVerticalOffset;
+
+public:
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	void PrepareScene();
+	void RenderScene();
+
+	// number of objects (draws) in the compiled scene
+	int GetObjectCount() const;
+	// move an object (matrices are rebuilt on the next frame)
+	void SetObjectTransform(int objectID, const OBJECT_TRANSFORM& transform);
+
+	// replace one of the directional lights (uploaded on the next frame)
+	void SetDirectionalLight(int index, const DIRECTIONAL_LIGHT& light);
+
+	// load an image file in the background and swap it in for the
+	// texture with the passed in tag once it is on the GPU
+	bool StreamTexture(const std::string& tag, const std::string& filename);
+
+	// draw the scene described by a text or cooked binary scene file
+	// instead of the built-in scene; call before PrepareScene()
+	bool LoadSceneFile(const std::string& filename);
+	// "built_in", "text" or "binary", by where the scene comes from
+	const char* GetSceneFormat() const;
+	// write the scene prepared by PrepareScene() to a text scene file
+	void SetSceneExport(const std::string& filename);
+
+	// set the uniform locations used for all shader uploads
+	void SetShaderUniforms(const ShaderUniforms* pUniforms);
+	// state cache every GL state and uniform write goes through,
+	// shared with the view manager and the main loop
+	GLStateCache* GetStateCache();
+
+	// set the camera whose view frustum culls the next frame's draws
+	void SetViewProjection(const glm::mat4& viewProjection);
+	// set the framebuffer the scene is drawn into and its size
+	void SetRenderTarget(GLuint framebuffer, int width, int height);
+
+	// render a depth-only pass before the color pass, so that the
+	// lighting shader runs once per visible pixel
+	void SetDepthPrepass(bool bEnable);
+
+	// draw an overdraw or draw order view instead of the shaded scene
+	void SetDebugView(DebugViews::VIEW view);
+
+	// time every render group on the GPU, optionally logging each
+	// frame to a CSV file; returns false if the context cannot
+	bool EnableGpuTiming(const char* logFilename);
+	// rolling average GPU time of every timed scope, by name
+	void GetGpuTimes(std::vector<std::string>& names, std::vector<double>& averageMs) const;
+
+	// statistics of the most recently rendered frame
+	const FRAME_STATS& GetFrameStats() const;
+
 };
\ No newline at end of file
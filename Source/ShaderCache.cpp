@@ -0,0 +1,301 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercache.cpp
+// ============
+// cache linked shader program binaries between runs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// declaration of global variables and constants
+namespace
+{
+	// identifies a cache entry and its layout version
+	const char CACHE_MAGIC[4] = { 'G', 'L', 'P', 'C' };
+	const uint32_t CACHE_VERSION = 1;
+	const char* const CACHE_EXTENSION = ".glprog";
+
+	// entry header, followed by the program binary
+	struct CACHE_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t keyHash;
+		uint32_t binaryFormat;
+		uint32_t binaryLength;
+	};
+
+	// continue a 64-bit FNV-1a hash over the passed in bytes
+	uint64_t HashBytes(uint64_t hash, const std::string& bytes)
+	{
+		for (char byte : bytes)
+		{
+			hash ^= static_cast<unsigned char>(byte);
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	// read a whole file, returning false if it cannot be read
+	bool ReadFile(const std::string& filename, std::string& contents)
+	{
+		std::ifstream file(filename, std::ios::binary);
+		if (!file)
+		{
+			return false;
+		}
+		std::ostringstream stream;
+		stream << file.rdbuf();
+		contents = stream.str();
+		return true;
+	}
+
+	// a GL string, or an empty string if the context has none
+	std::string GetGLString(GLenum name)
+	{
+		const GLubyte* value = glGetString(name);
+		return (nullptr != value) ? reinterpret_cast<const char*>(value) : "";
+	}
+}
+
+/***********************************************************
+ *  ShaderCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderCache::ShaderCache(const std::string& directory)
+{
+	m_directory = directory;
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method returns true if the current context supports
+ *  program binaries and offers at least one binary format.
+ ***********************************************************/
+bool ShaderCache::IsSupported()
+{
+	if (!(GLEW_VERSION_4_1 || GLEW_ARB_get_program_binary))
+	{
+		return false;
+	}
+
+	GLint formatCount = 0;
+	glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+	return formatCount > 0;
+}
+
+/***********************************************************
+ *  HashProgramKey()
+ *
+ *  This method returns the hash identifying a program built
+ *  from the passed in shader files by the current driver, or
+ *  0 if a shader file cannot be read.
+ ***********************************************************/
+uint64_t ShaderCache::HashProgramKey(const std::string& vertexShaderFile, const std::string& fragmentShaderFile)
+{
+	std::string vertexSource;
+	std::string fragmentSource;
+	if (!ReadFile(vertexShaderFile, vertexSource) || !ReadFile(fragmentShaderFile, fragmentSource))
+	{
+		return 0;
+	}
+
+	// separate the parts so that moving text between them changes the key
+	uint64_t hash = 14695981039346656037ull;
+	hash = HashBytes(hash, vertexSource);
+	hash = HashBytes(hash, std::string(1, '\0'));
+	hash = HashBytes(hash, fragmentSource);
+	hash = HashBytes(hash, std::string(1, '\0'));
+	hash = HashBytes(hash, GetGLString(GL_VENDOR));
+	hash = HashBytes(hash, std::string(1, '\0'));
+	hash = HashBytes(hash, GetGLString(GL_RENDERER));
+	hash = HashBytes(hash, std::string(1, '\0'));
+	hash = HashBytes(hash, GetGLString(GL_VERSION));
+	return hash;
+}
+
+/***********************************************************
+ *  GetEntryPath()
+ *
+ *  This method returns the path of the cache entry for the
+ *  passed in key hash.
+ ***********************************************************/
+std::string ShaderCache::GetEntryPath(uint64_t keyHash) const
+{
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(keyHash));
+	return m_directory + "/" + name + CACHE_EXTENSION;
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method creates a program from the cache entry of the
+ *  passed in shader files. It returns 0, so that the caller
+ *  builds the program from source instead, if there is no
+ *  entry, if a source or the driver has changed, or if the
+ *  driver does not accept the binary.
+ ***********************************************************/
+GLuint ShaderCache::Load(const std::string& vertexShaderFile, const std::string& fragmentShaderFile) const
+{
+	if (!IsSupported())
+	{
+		return 0;
+	}
+
+	const uint64_t keyHash = HashProgramKey(vertexShaderFile, fragmentShaderFile);
+	if (0 == keyHash)
+	{
+		return 0;
+	}
+
+	std::ifstream file(GetEntryPath(keyHash), std::ios::binary);
+	if (!file)
+	{
+		return 0;
+	}
+
+	CACHE_HEADER header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		!std::equal(std::begin(CACHE_MAGIC), std::end(CACHE_MAGIC), header.magic) ||
+		(header.version != CACHE_VERSION) ||
+		(header.keyHash != keyHash) ||
+		(header.binaryLength == 0))
+	{
+		return 0;
+	}
+
+	// a corrupt length must not size the allocation, so check it
+	// against what is left of the file first
+	const std::streamoff binaryStart = file.tellg();
+	file.seekg(0, std::ios::end);
+	const std::streamoff fileSize = file.tellg();
+	file.seekg(binaryStart);
+	if ((binaryStart < 0) || (fileSize - binaryStart < static_cast<std::streamoff>(header.binaryLength)))
+	{
+		std::cout << "Corrupt shader cache entry for:" << vertexShaderFile << std::endl;
+		return 0;
+	}
+
+	std::vector<char> binary(header.binaryLength);
+	if (!file.read(binary.data(), header.binaryLength))
+	{
+		std::cout << "Corrupt shader cache entry for:" << vertexShaderFile << std::endl;
+		return 0;
+	}
+
+	GLuint programID = glCreateProgram();
+	glProgramBinary(programID, header.binaryFormat, binary.data(), static_cast<GLsizei>(header.binaryLength));
+
+	// drivers may reject binaries they wrote, e.g. after an update
+	GLint bLinked = GL_FALSE;
+	glGetProgramiv(programID, GL_LINK_STATUS, &bLinked);
+	if (GL_FALSE == bLinked)
+	{
+		glDeleteProgram(programID);
+		return 0;
+	}
+
+	std::cout << "Loaded cached shader program:" << GetEntryPath(keyHash) << std::endl;
+	return programID;
+}
+
+/***********************************************************
+ *  Save()
+ *
+ *  This method writes the binary of the passed in program,
+ *  linked from the passed in shader files, to the cache.
+ *  The program is linked again with the retrievable hint
+ *  first, as drivers may otherwise return an empty binary
+ *  or one they refuse to load. Call it before any uniform is
+ *  set, since linking resets them. Returns false if the
+ *  binary cannot be retrieved or the entry cannot be written.
+ ***********************************************************/
+bool ShaderCache::Save(const std::string& vertexShaderFile, const std::string& fragmentShaderFile, GLuint programID) const
+{
+	if ((0 == programID) || !IsSupported())
+	{
+		return false;
+	}
+
+	const uint64_t keyHash = HashProgramKey(vertexShaderFile, fragmentShaderFile);
+	if (0 == keyHash)
+	{
+		return false;
+	}
+
+	// relinking needs the shaders, which are still attached unless
+	// they were detached after the first link
+	GLint attachedShaders = 0;
+	glGetProgramiv(programID, GL_ATTACHED_SHADERS, &attachedShaders);
+	if (attachedShaders > 0)
+	{
+		glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		glLinkProgram(programID);
+
+		GLint bLinked = GL_FALSE;
+		glGetProgramiv(programID, GL_LINK_STATUS, &bLinked);
+		if (GL_FALSE == bLinked)
+		{
+			std::cout << "Could not relink shader program for the cache:" << vertexShaderFile << std::endl;
+			return false;
+		}
+	}
+
+	GLint binaryLength = 0;
+	glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+	if (binaryLength <= 0)
+	{
+		return false;
+	}
+
+	std::vector<char> binary(binaryLength);
+	GLenum binaryFormat = 0;
+	GLsizei writtenLength = 0;
+	glGetProgramBinary(programID, binaryLength, &writtenLength, &binaryFormat, binary.data());
+	if (writtenLength <= 0)
+	{
+		return false;
+	}
+
+#ifdef _WIN32
+	_mkdir(m_directory.c_str());
+#else
+	mkdir(m_directory.c_str(), 0755);
+#endif
+	const std::string entryPath = GetEntryPath(keyHash);
+	std::ofstream file(entryPath, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write shader cache entry:" << entryPath << std::endl;
+		return false;
+	}
+
+	CACHE_HEADER header;
+	std::copy(std::begin(CACHE_MAGIC), std::end(CACHE_MAGIC), header.magic);
+	header.version = CACHE_VERSION;
+	header.keyHash = keyHash;
+	header.binaryFormat = binaryFormat;
+	header.binaryLength = static_cast<uint32_t>(writtenLength);
+	file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	file.write(binary.data(), writtenLength);
+
+	std::cout << "Wrote shader cache entry:" << entryPath << std::endl;
+	return true;
+}
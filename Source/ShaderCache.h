@@ -0,0 +1,49 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercache.h
+// ============
+// cache linked shader program binaries between runs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *  ShaderCache
+ *
+ *  This class keeps the driver's binary of a linked shader
+ *  program in a cache directory, so later runs can load it
+ *  with glProgramBinary() instead of compiling and linking
+ *  the GLSL sources. Entries are keyed by a hash of both
+ *  source files and the GL vendor, renderer and version
+ *  strings, so an edited shader or a driver update misses
+ *  the cache and the program is built from source again.
+ ***********************************************************/
+class ShaderCache
+{
+public:
+	// constructor
+	explicit ShaderCache(const std::string& directory);
+
+	// true if the context can save and load program binaries
+	static bool IsSupported();
+
+	// create a program from the cache entry of the shader sources,
+	// returning 0 if there is no entry or the driver rejects it
+	GLuint Load(const std::string& vertexShaderFile, const std::string& fragmentShaderFile) const;
+	// write the binary of a program linked from the shader sources
+	bool Save(const std::string& vertexShaderFile, const std::string& fragmentShaderFile, GLuint programID) const;
+
+private:
+	// directory holding the cache entries
+	std::string m_directory;
+
+	// hash of the shader sources and the driver identity (0 if unreadable)
+	static uint64_t HashProgramKey(const std::string& vertexShaderFile, const std::string& fragmentShaderFile);
+	// path of the cache entry for a key hash
+	std::string GetEntryPath(uint64_t keyHash) const;
+};
@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderuniforms.cpp
+// ============
+// cache the uniform locations of the scene shader program
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderUniforms.h"
+
+#include <string>
+
+/***********************************************************
+ *  ShaderUniforms()
+ *
+ *  The constructor for the class. All locations start as -1,
+ *  which OpenGL silently ignores, until Resolve() is called.
+ ***********************************************************/
+ShaderUniforms::ShaderUniforms()
+{
+	programID = 0;
+	model = normalMatrix = view = projection = viewPosition = -1;
+	objectColor = objectTexture = bUseTexture = bUseLighting = UVscale = UVoffset = -1;
+	objectTextureArray = textureLayer = objectTextureHandle = -1;
+	material = { -1, -1, -1, -1, -1 };
+	materialIndex = -1;
+	materialBlock = GL_INVALID_INDEX;
+	instanceModel = -1;
+	for (int i = 0; i < MAX_LIGHTS; i++)
+	{
+		lightSources[i] = { -1, -1, -1, -1, -1, -1 };
+	}
+	lightBlock = GL_INVALID_INDEX;
+}
+
+/***********************************************************
+ *  Resolve()
+ *
+ *  This method looks up the location of every uniform used
+ *  by the scene in the passed in linked shader program. It
+ *  must be called again if the program is relinked.
+ ***********************************************************/
+void ShaderUniforms::Resolve(GLuint program)
+{
+	programID = program;
+
+	model = glGetUniformLocation(program, "model");
+	normalMatrix = glGetUniformLocation(program, "normalMatrix");
+	view = glGetUniformLocation(program, "view");
+	projection = glGetUniformLocation(program, "projection");
+	viewPosition = glGetUniformLocation(program, "viewPosition");
+
+	objectColor = glGetUniformLocation(program, "objectColor");
+	objectTexture = glGetUniformLocation(program, "objectTexture");
+	objectTextureArray = glGetUniformLocation(program, "objectTextureArray");
+	textureLayer = glGetUniformLocation(program, "textureLayer");
+	objectTextureHandle = glGetUniformLocation(program, "objectTextureHandle");
+	bUseTexture = glGetUniformLocation(program, "bUseTexture");
+	bUseLighting = glGetUniformLocation(program, "bUseLighting");
+	UVscale = glGetUniformLocation(program, "UVscale");
+	UVoffset = glGetUniformLocation(program, "UVoffset");
+
+	material.ambientColor = glGetUniformLocation(program, "material.ambientColor");
+	material.ambientStrength = glGetUniformLocation(program, "material.ambientStrength");
+	material.diffuseColor = glGetUniformLocation(program, "material.diffuseColor");
+	material.specularColor = glGetUniformLocation(program, "material.specularColor");
+	material.shininess = glGetUniformLocation(program, "material.shininess");
+	materialIndex = glGetUniformLocation(program, "materialIndex");
+
+	instanceModel = glGetAttribLocation(program, "instanceModel");
+
+	for (int i = 0; i < MAX_LIGHTS; i++)
+	{
+		std::string base = "lightSources[" + std::to_string(i) + "]";
+		lightSources[i].position = glGetUniformLocation(program, (base + ".position").c_str());
+		lightSources[i].ambientColor = glGetUniformLocation(program, (base + ".ambientColor").c_str());
+		lightSources[i].diffuseColor = glGetUniformLocation(program, (base + ".diffuseColor").c_str());
+		lightSources[i].specularColor = glGetUniformLocation(program, (base + ".specularColor").c_str());
+		lightSources[i].focalStrength = glGetUniformLocation(program, (base + ".focalStrength").c_str());
+		lightSources[i].specularIntensity = glGetUniformLocation(program, (base + ".specularIntensity").c_str());
+	}
+
+	// route the light block, if the shader has one, to its buffer binding
+	lightBlock = glGetUniformBlockIndex(program, "LightBlock");
+	if (lightBlock != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(program, lightBlock, LIGHT_BLOCK_BINDING);
+	}
+
+	// likewise for the material table
+	materialBlock = glGetUniformBlockIndex(program, "MaterialBlock");
+	if (materialBlock != GL_INVALID_INDEX)
+	{
+		glUniformBlockBinding(program, materialBlock, MATERIAL_BLOCK_BINDING);
+	}
+}
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+// shaderuniforms.h
+// ============
+// cache the uniform locations of the scene shader program
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  ShaderUniforms
+ *
+ *  This class holds the locations of every uniform that the
+ *  scene and view managers write, resolved once after the
+ *  shader program is linked so that per-draw uploads do not
+ *  need a glGetUniformLocation() string lookup.
+ ***********************************************************/
+class ShaderUniforms
+{
+public:
+	// constructor
+	ShaderUniforms();
+
+	// number of entries in the lightSources[] array (TOTAL_LIGHTS in fragmentShader.glsl)
+	static constexpr int MAX_LIGHTS = 5;
+
+	// uniform buffer binding point of the light block. A fragment shader
+	// can declare its lights as
+	//   layout(std140) uniform LightBlock { LightSource lightSources[TOTAL_LIGHTS]; };
+	// to receive them from a buffer instead of individual uniforms
+	static constexpr GLuint LIGHT_BLOCK_BINDING = 0;
+
+	// uniform buffer binding point and capacity of the material table. A
+	// fragment shader can declare
+	//   layout(std140) uniform MaterialBlock { Material materials[MAX_MATERIALS]; };
+	//   uniform int materialIndex;
+	// and read materials[materialIndex] in place of the material uniform
+	static constexpr GLuint MATERIAL_BLOCK_BINDING = 1;
+	static constexpr int MAX_MATERIALS = 64;
+
+	struct MATERIAL_LOCATIONS
+	{
+		GLint ambientColor;
+		GLint ambientStrength;
+		GLint diffuseColor;
+		GLint specularColor;
+		GLint shininess;
+	};
+
+	struct LIGHT_LOCATIONS
+	{
+		GLint position;
+		GLint ambientColor;
+		GLint diffuseColor;
+		GLint specularColor;
+		GLint focalStrength;
+		GLint specularIntensity;
+	};
+
+	// look up all uniform locations in the linked shader program
+	void Resolve(GLuint programID);
+
+	// program the locations were resolved from
+	GLuint programID;
+
+	// transform and camera uniforms
+	GLint model;
+	GLint normalMatrix;   // optional mat3, -1 if the shader derives it from model
+	GLint view;
+	GLint projection;
+	GLint viewPosition;
+
+	// surface uniforms
+	GLint objectColor;
+	GLint objectTexture;
+	// a fragment shader can select textures without rebinding by declaring
+	//   uniform sampler2DArray objectTextureArray;
+	//   uniform int textureLayer;
+	// or, with ARB_bindless_texture,
+	//   layout(bindless_sampler) uniform sampler2D objectTextureHandle;
+	GLint objectTextureArray;
+	GLint textureLayer;
+	GLint objectTextureHandle;
+	GLint bUseTexture;
+	GLint bUseLighting;
+	GLint UVscale;
+	// optional vec2 added to the scaled texture coordinate,
+	//   texCoord = fragmentTextureCoordinate * UVscale + UVoffset;
+	// which lets draws sample one image of a texture atlas
+	GLint UVoffset;
+	MATERIAL_LOCATIONS material;
+	// index into the material table
+	GLint materialIndex;
+	// index of the MaterialBlock uniform block (GL_INVALID_INDEX if not declared)
+	GLuint materialBlock;
+
+	// location of the per-instance model matrix attribute (see
+	// InstancedMeshes), -1 if the shader reads the model uniform
+	GLint instanceModel;
+
+	// lighting uniforms
+	LIGHT_LOCATIONS lightSources[MAX_LIGHTS];
+	// index of the LightBlock uniform block (GL_INVALID_INDEX if not declared)
+	GLuint lightBlock;
+};
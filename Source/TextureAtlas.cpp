@@ -0,0 +1,163 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureatlas.cpp
+// ============
+// pack small texture images into one shared atlas texture
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureAtlas.h"
+
+#include <algorithm>
+
+// declaration of global variables and constants
+namespace
+{
+	// round a texel count up to the cell alignment
+	int AlignToCell(int texels)
+	{
+		return (texels + TextureAtlas::CELL_ALIGNMENT - 1) / TextureAtlas::CELL_ALIGNMENT * TextureAtlas::CELL_ALIGNMENT;
+	}
+}
+
+/***********************************************************
+ *  TextureAtlas()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureAtlas::TextureAtlas(int size)
+{
+	m_size = size;
+	m_shelfX = 0;
+	m_shelfY = 0;
+	m_shelfHeight = 0;
+	m_imageCount = 0;
+}
+
+/***********************************************************
+ *  IsPackable()
+ *
+ *  This method returns true if an image of the passed in
+ *  size is small enough to be packed.
+ ***********************************************************/
+bool TextureAtlas::IsPackable(int width, int height)
+{
+	return (width > 0) && (height > 0) && (width <= MAX_IMAGE_SIZE) && (height <= MAX_IMAGE_SIZE);
+}
+
+/***********************************************************
+ *  Add()
+ *
+ *  This method packs the passed in image into the next free
+ *  cell of the current shelf, starting a new shelf when the
+ *  current one is full. The image's edge texels are repeated
+ *  out to the cell border. Returns false, leaving the atlas
+ *  unchanged, if the image is too big or does not fit.
+ ***********************************************************/
+bool TextureAtlas::Add(const unsigned char* pixels, int width, int height, int colorChannels, REGION& region)
+{
+	if (!IsPackable(width, height) || ((colorChannels != 3) && (colorChannels != 4)))
+	{
+		return false;
+	}
+
+	const int cellWidth = AlignToCell(width + 2 * BORDER);
+	const int cellHeight = AlignToCell(height + 2 * BORDER);
+
+	// move to a new shelf if the image does not fit on this one
+	if (m_shelfX + cellWidth > m_size)
+	{
+		m_shelfX = 0;
+		m_shelfY += m_shelfHeight;
+		m_shelfHeight = 0;
+	}
+	if ((cellWidth > m_size) || (m_shelfY + cellHeight > m_size))
+	{
+		return false;
+	}
+
+	if (m_pixels.empty())
+	{
+		m_pixels.assign(static_cast<size_t>(m_size) * m_size * 4, 0);
+	}
+
+	// copy the image and clamp its edges out across the border
+	const int imageX = m_shelfX + BORDER;
+	const int imageY = m_shelfY + BORDER;
+	for (int y = -BORDER; y < height + BORDER; y++)
+	{
+		int sourceY = std::min(std::max(y, 0), height - 1);
+		for (int x = -BORDER; x < width + BORDER; x++)
+		{
+			int sourceX = std::min(std::max(x, 0), width - 1);
+			CopyTexel(pixels, width, colorChannels, sourceX, sourceY, imageX + x, imageY + y);
+		}
+	}
+
+	region.offset = glm::vec2(static_cast<float>(imageX) / m_size, static_cast<float>(imageY) / m_size);
+	region.scale = glm::vec2(static_cast<float>(width) / m_size, static_cast<float>(height) / m_size);
+
+	m_shelfX += cellWidth;
+	m_shelfHeight = std::max(m_shelfHeight, cellHeight);
+	m_imageCount++;
+	return true;
+}
+
+/***********************************************************
+ *  CopyTexel()
+ *
+ *  This method copies one texel of a source image into the
+ *  atlas, adding an opaque alpha to RGB texels.
+ ***********************************************************/
+void TextureAtlas::CopyTexel(const unsigned char* pixels, int width, int colorChannels,
+	int sourceX, int sourceY, int atlasX, int atlasY)
+{
+	const unsigned char* source = pixels + (static_cast<size_t>(sourceY) * width + sourceX) * colorChannels;
+	unsigned char* target = &m_pixels[(static_cast<size_t>(atlasY) * m_size + atlasX) * 4];
+
+	target[0] = source[0];
+	target[1] = source[1];
+	target[2] = source[2];
+	target[3] = (colorChannels == 4) ? source[3] : 255;
+}
+
+/***********************************************************
+ *  GetImageCount()
+ *
+ *  This method returns the number of images packed so far.
+ ***********************************************************/
+int TextureAtlas::GetImageCount() const
+{
+	return m_imageCount;
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method creates the OpenGL texture holding the packed
+ *  images. Its mip chain stops at the deepest level whose
+ *  texels do not span two cells. Returns 0 if nothing has
+ *  been packed.
+ ***********************************************************/
+GLuint TextureAtlas::CreateGLTexture() const
+{
+	if (0 == m_imageCount)
+	{
+		return 0;
+	}
+
+	GLuint textureID = 0;
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, MAX_MIP_LEVEL);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_size, m_size, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_pixels.data());
+	glGenerateMipmap(GL_TEXTURE_2D);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return textureID;
+}
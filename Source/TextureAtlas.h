@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureatlas.h
+// ============
+// pack small texture images into one shared atlas texture
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  TextureAtlas
+ *
+ *  This class packs small images into rows (shelves) of one
+ *  square RGBA atlas, so that objects using them share one
+ *  texture and select their image with a UV offset and
+ *  scale. Every image is surrounded by a guard border of
+ *  copies of its edge texels and starts on an aligned cell,
+ *  so filtering and the first few mip levels never blend in
+ *  a neighboring image. Packed images cannot be tiled with a
+ *  UV scale above 1.
+ ***********************************************************/
+class TextureAtlas
+{
+public:
+	// constructor
+	explicit TextureAtlas(int size);
+
+	// largest image width or height that is packed
+	static constexpr int MAX_IMAGE_SIZE = 256;
+	// guard border on each side of an image, in texels
+	static constexpr int BORDER = 8;
+	// image cells start on multiples of this many texels
+	static constexpr int CELL_ALIGNMENT = 2 * BORDER;
+	// deepest mip level whose texels stay inside one cell
+	static constexpr int MAX_MIP_LEVEL = 4;
+
+	// where an image was placed, in atlas texture coordinates
+	struct REGION
+	{
+		glm::vec2 offset;
+		glm::vec2 scale;
+	};
+
+	// true if an image of the passed in size is small enough to pack
+	static bool IsPackable(int width, int height);
+
+	// pack an RGB or RGBA image, returning false if it does not fit
+	bool Add(const unsigned char* pixels, int width, int height, int colorChannels, REGION& region);
+	// number of images packed so far
+	int GetImageCount() const;
+	// create the OpenGL texture holding the packed images
+	GLuint CreateGLTexture() const;
+
+private:
+	// width and height of the atlas, in texels
+	int m_size;
+	// RGBA texels, allocated by the first Add()
+	std::vector<unsigned char> m_pixels;
+
+	// shelf being filled and the next free position on it
+	int m_shelfX;
+	int m_shelfY;
+	int m_shelfHeight;
+	int m_imageCount;
+
+	// copy a source texel to an atlas texel
+	void CopyTexel(const unsigned char* pixels, int width, int colorChannels,
+		int sourceX, int sourceY, int atlasX, int atlasY);
+};
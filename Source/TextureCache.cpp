@@ -0,0 +1,372 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.cpp
+// ============
+// cache textures as GPU-compressed mip chains between runs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureCache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#endif
+
+// declaration of global variables and constants
+namespace
+{
+	// identifies a cache entry and its layout version
+	const char CACHE_MAGIC[4] = { 'G', 'L', 'T', 'C' };
+	const uint32_t CACHE_VERSION = 1;
+	const char* const CACHE_EXTENSION = ".gltex";
+
+	// entry header, followed by one LEVEL_HEADER and its
+	// compressed blocks per mip level, largest level first
+	struct CACHE_HEADER
+	{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceHash;
+		uint32_t internalFormat;
+		uint32_t levelCount;
+	};
+
+	struct LEVEL_HEADER
+	{
+		uint32_t width;
+		uint32_t height;
+		uint32_t dataSize;
+	};
+
+	// a full mip chain of a texture up to 32768 texels wide
+	const uint32_t MAX_LEVEL_COUNT = 16;
+
+	// the texture parameters used for every scene texture
+	void SetTextureParameters(GLint levelCount)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+	}
+
+	// true if the current context can sample the passed in format
+	bool IsFormatSupported(GLenum internalFormat)
+	{
+		switch (internalFormat)
+		{
+		case GL_COMPRESSED_RGBA_BPTC_UNORM:
+			return (GLEW_VERSION_4_2 || GLEW_ARB_texture_compression_bptc);
+		case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+		case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+			return GLEW_EXT_texture_compression_s3tc;
+		default:
+			return false;
+		}
+	}
+
+	// bytes in one 4x4 block of the passed in format
+	uint32_t GetBlockBytes(GLenum internalFormat)
+	{
+		return (GL_COMPRESSED_RGB_S3TC_DXT1_EXT == internalFormat) ? 8 : 16;
+	}
+}
+
+/***********************************************************
+ *  TextureCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureCache::TextureCache(const std::string& directory)
+{
+	m_directory = directory;
+}
+
+/***********************************************************
+ *  ChooseFormat()
+ *
+ *  This method picks the compressed format for an image with
+ *  the passed in channel count. BC7 (BPTC) keeps the most
+ *  detail at 8 bits per texel; without it, BC1 (DXT1) stores
+ *  opaque images at 4 bits per texel and BC3 (DXT5) images
+ *  with alpha at 8.
+ ***********************************************************/
+GLenum TextureCache::ChooseFormat(int colorChannels)
+{
+	if ((colorChannels != 3) && (colorChannels != 4))
+	{
+		return 0;
+	}
+	if (IsFormatSupported(GL_COMPRESSED_RGBA_BPTC_UNORM))
+	{
+		return GL_COMPRESSED_RGBA_BPTC_UNORM;
+	}
+	if (colorChannels == 3)
+	{
+		return IsFormatSupported(GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : 0;
+	}
+	return IsFormatSupported(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT) ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : 0;
+}
+
+/***********************************************************
+ *  HashFile()
+ *
+ *  This method returns the 64-bit FNV-1a hash of the contents
+ *  of the passed in file, or 0 if it cannot be read.
+ ***********************************************************/
+uint64_t TextureCache::HashFile(const std::string& filename)
+{
+	std::ifstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		return 0;
+	}
+
+	uint64_t hash = 14695981039346656037ull;
+	char buffer[64 * 1024];
+	while (file.read(buffer, sizeof(buffer)) || (file.gcount() > 0))
+	{
+		std::streamsize count = file.gcount();
+		for (std::streamsize i = 0; i < count; i++)
+		{
+			hash ^= static_cast<unsigned char>(buffer[i]);
+			hash *= 1099511628211ull;
+		}
+	}
+	return hash;
+}
+
+/***********************************************************
+ *  GetEntryPath()
+ *
+ *  This method returns the path of the cache entry for the
+ *  passed in source file hash.
+ ***********************************************************/
+std::string TextureCache::GetEntryPath(uint64_t sourceHash) const
+{
+	char name[17];
+	snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(sourceHash));
+	return m_directory + "/" + name + CACHE_EXTENSION;
+}
+
+/***********************************************************
+ *  Load()
+ *
+ *  This method creates a texture from the cache entry of the
+ *  passed in source image. It returns 0, so that the caller
+ *  decodes the image instead, if there is no entry, if the
+ *  source has changed, or if the entry's format cannot be
+ *  sampled by this context. Every level is checked against
+ *  the mip chain and the file size before anything is
+ *  allocated or uploaded, so a corrupt entry is skipped too.
+ ***********************************************************/
+GLuint TextureCache::Load(const std::string& sourceFile) const
+{
+	const uint64_t sourceHash = HashFile(sourceFile);
+	if (0 == sourceHash)
+	{
+		return 0;
+	}
+
+	std::ifstream file(GetEntryPath(sourceHash), std::ios::binary);
+	if (!file)
+	{
+		return 0;
+	}
+
+	CACHE_HEADER header;
+	if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+		!std::equal(std::begin(CACHE_MAGIC), std::end(CACHE_MAGIC), header.magic) ||
+		(header.version != CACHE_VERSION) ||
+		(header.sourceHash != sourceHash) ||
+		(header.levelCount == 0) ||
+		(header.levelCount > MAX_LEVEL_COUNT) ||
+		!IsFormatSupported(header.internalFormat))
+	{
+		return 0;
+	}
+
+	const std::streamoff levelsStart = file.tellg();
+	file.seekg(0, std::ios::end);
+	std::streamoff remaining = file.tellg() - levelsStart;
+	file.seekg(levelsStart);
+
+	LEVEL_HEADER levelHeaders[MAX_LEVEL_COUNT];
+	std::vector<std::vector<char>> levelBlocks(header.levelCount);
+	const uint32_t blockBytes = GetBlockBytes(header.internalFormat);
+	for (uint32_t level = 0; level < header.levelCount; level++)
+	{
+		LEVEL_HEADER& levelHeader = levelHeaders[level];
+		bool bValid = (remaining >= static_cast<std::streamoff>(sizeof(levelHeader))) &&
+			file.read(reinterpret_cast<char*>(&levelHeader), sizeof(levelHeader));
+		remaining -= sizeof(levelHeader);
+
+		if (bValid && (level > 0))
+		{
+			// each level halves the previous one, down to 1
+			const LEVEL_HEADER& previous = levelHeaders[level - 1];
+			bValid = (levelHeader.width == std::max(1u, previous.width / 2)) &&
+				(levelHeader.height == std::max(1u, previous.height / 2));
+		}
+		else if (bValid)
+		{
+			bValid = (levelHeader.width > 0) && (levelHeader.width < (1u << MAX_LEVEL_COUNT)) &&
+				(levelHeader.height > 0) && (levelHeader.height < (1u << MAX_LEVEL_COUNT));
+		}
+
+		// the data must be exactly the level's blocks and fit in the file
+		if (bValid)
+		{
+			const uint64_t expectedSize =
+				static_cast<uint64_t>((levelHeader.width + 3) / 4) * ((levelHeader.height + 3) / 4) * blockBytes;
+			bValid = (levelHeader.dataSize == expectedSize) &&
+				(static_cast<std::streamoff>(levelHeader.dataSize) <= remaining);
+		}
+		if (bValid)
+		{
+			levelBlocks[level].resize(levelHeader.dataSize);
+			bValid = static_cast<bool>(file.read(levelBlocks[level].data(), levelHeader.dataSize));
+			remaining -= levelHeader.dataSize;
+		}
+
+		if (!bValid)
+		{
+			std::cout << "Corrupt texture cache entry for:" << sourceFile << std::endl;
+			return 0;
+		}
+	}
+
+	GLuint textureID = 0;
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	for (uint32_t level = 0; level < header.levelCount; level++)
+	{
+		const LEVEL_HEADER& levelHeader = levelHeaders[level];
+		glCompressedTexImage2D(GL_TEXTURE_2D, level, header.internalFormat,
+			levelHeader.width, levelHeader.height, 0, levelHeader.dataSize, levelBlocks[level].data());
+	}
+
+	SetTextureParameters(header.levelCount);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	std::cout << "Loaded cached compressed texture:" << sourceFile << ", levels:" << header.levelCount << std::endl;
+	return textureID;
+}
+
+/***********************************************************
+ *  Transcode()
+ *
+ *  This method creates a compressed copy of the passed in
+ *  texture, which must have its full mip chain, by uploading
+ *  each level into a compressed texture so that the driver
+ *  compresses it. The compressed blocks are read back and
+ *  written to the cache entry of the source image. Returns
+ *  the compressed texture, or 0 if compression is not
+ *  available.
+ ***********************************************************/
+GLuint TextureCache::Transcode(const std::string& sourceFile, GLuint textureID, int colorChannels) const
+{
+	const GLenum internalFormat = ChooseFormat(colorChannels);
+	const uint64_t sourceHash = HashFile(sourceFile);
+	if ((0 == internalFormat) || (0 == sourceHash))
+	{
+		return 0;
+	}
+
+	GLint width = 0;
+	GLint height = 0;
+	glBindTexture(GL_TEXTURE_2D, textureID);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &width);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &height);
+
+	GLint levelCount = 1;
+	while ((std::max(width, height) >> levelCount) > 0)
+	{
+		levelCount++;
+	}
+
+	// read every level back as RGBA8
+	std::vector<std::vector<unsigned char>> levels(levelCount);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	for (GLint level = 0; level < levelCount; level++)
+	{
+		GLint levelWidth = std::max(1, width >> level);
+		GLint levelHeight = std::max(1, height >> level);
+		levels[level].resize(static_cast<size_t>(levelWidth) * levelHeight * 4);
+		glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, levels[level].data());
+	}
+	glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+	// let the driver compress each level
+	GLuint compressedID = 0;
+	glGenTextures(1, &compressedID);
+	glBindTexture(GL_TEXTURE_2D, compressedID);
+	for (GLint level = 0; level < levelCount; level++)
+	{
+		glTexImage2D(GL_TEXTURE_2D, level, internalFormat,
+			std::max(1, width >> level), std::max(1, height >> level), 0,
+			GL_RGBA, GL_UNSIGNED_BYTE, levels[level].data());
+	}
+	SetTextureParameters(levelCount);
+
+	GLint bCompressed = GL_FALSE;
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_COMPRESSED, &bCompressed);
+	if (GL_FALSE == bCompressed)
+	{
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glDeleteTextures(1, &compressedID);
+		return 0;
+	}
+
+	// write the compressed blocks to the cache entry
+#ifdef _WIN32
+	_mkdir(m_directory.c_str());
+#else
+	mkdir(m_directory.c_str(), 0755);
+#endif
+	const std::string entryPath = GetEntryPath(sourceHash);
+	std::ofstream file(entryPath, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write texture cache entry:" << entryPath << std::endl;
+	}
+	else
+	{
+		CACHE_HEADER header;
+		std::copy(std::begin(CACHE_MAGIC), std::end(CACHE_MAGIC), header.magic);
+		header.version = CACHE_VERSION;
+		header.sourceHash = sourceHash;
+		header.internalFormat = internalFormat;
+		header.levelCount = static_cast<uint32_t>(levelCount);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		std::vector<char> blocks;
+		for (GLint level = 0; level < levelCount; level++)
+		{
+			GLint dataSize = 0;
+			glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &dataSize);
+			blocks.resize(dataSize);
+			glGetCompressedTexImage(GL_TEXTURE_2D, level, blocks.data());
+
+			LEVEL_HEADER levelHeader;
+			levelHeader.width = static_cast<uint32_t>(std::max(1, width >> level));
+			levelHeader.height = static_cast<uint32_t>(std::max(1, height >> level));
+			levelHeader.dataSize = static_cast<uint32_t>(dataSize);
+			file.write(reinterpret_cast<const char*>(&levelHeader), sizeof(levelHeader));
+			file.write(blocks.data(), dataSize);
+		}
+		std::cout << "Wrote texture cache entry:" << entryPath << std::endl;
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	return compressedID;
+}
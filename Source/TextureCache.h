@@ -0,0 +1,54 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecache.h
+// ============
+// cache textures as GPU-compressed mip chains between runs
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <string>
+
+/***********************************************************
+ *  TextureCache
+ *
+ *  This class keeps a GPU-compressed copy of each texture,
+ *  with its complete mip chain, in a cache directory. Entries
+ *  are keyed by a hash of the source image file, so an edited
+ *  image is transcoded again. A cached texture is uploaded
+ *  with glCompressedTexImage2D() and needs no image decoding
+ *  or mipmap generation.
+ *
+ *  Entries are written on the first run by letting the driver
+ *  compress each level of an uploaded texture and reading the
+ *  compressed blocks back.
+ ***********************************************************/
+class TextureCache
+{
+public:
+	// constructor
+	explicit TextureCache(const std::string& directory);
+
+	// compressed format for images with the passed in channel
+	// count, or 0 if the context supports no suitable format
+	static GLenum ChooseFormat(int colorChannels);
+	// 64-bit FNV-1a hash of a file's contents (0 if unreadable)
+	static uint64_t HashFile(const std::string& filename);
+
+	// create a texture from the cache entry of a source image,
+	// returning 0 if there is no valid entry
+	GLuint Load(const std::string& sourceFile) const;
+	// create a compressed copy of an uploaded mipmapped texture
+	// and write it to the cache, returning 0 on failure
+	GLuint Transcode(const std::string& sourceFile, GLuint textureID, int colorChannels) const;
+
+private:
+	// directory holding the cache entries
+	std::string m_directory;
+
+	// path of the cache entry for a source file hash
+	std::string GetEntryPath(uint64_t sourceHash) const;
+};
@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// ============
+// decode texture image files on a pool of worker threads
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+// the stb_image implementation is compiled in SceneManager.cpp
+#include "stb_image.h"
+
+#include "Trace.h"
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class. It starts the workers,
+ *  which wait for files to be queued.
+ ***********************************************************/
+TextureLoader::TextureLoader(int workerCount)
+{
+	m_pendingCount = 0;
+	m_nextRequestIndex = 0;
+	m_bStopping = false;
+
+	if (workerCount <= 0)
+	{
+		workerCount = static_cast<int>(std::thread::hardware_concurrency());
+		if (workerCount <= 0)
+		{
+			workerCount = 1;
+		}
+	}
+
+	for (int i = 0; i < workerCount; i++)
+	{
+		m_workers.emplace_back(&TextureLoader::WorkerMain, this);
+	}
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class. Files still queued are not
+ *  decoded, and images never returned are freed.
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+		m_jobs.clear();
+	}
+	m_jobReady.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+
+	for (DECODED_IMAGE& image : m_decoded)
+	{
+		FreeImage(image);
+	}
+}
+
+/***********************************************************
+ *  Enqueue()
+ *
+ *  This method queues the passed in file for decoding and
+ *  returns its request index, which identifies the image
+ *  when WaitForNext() returns it.
+ ***********************************************************/
+int TextureLoader::Enqueue(const std::string& filename)
+{
+	DECODED_IMAGE job = DECODED_IMAGE();
+	job.filename = filename;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		job.requestIndex = m_nextRequestIndex++;
+		m_jobs.push_back(job);
+		m_pendingCount++;
+	}
+	m_jobReady.notify_one();
+
+	return job.requestIndex;
+}
+
+/***********************************************************
+ *  WaitForNext()
+ *
+ *  This method blocks until a queued file has been decoded
+ *  and returns it, in completion order. The caller owns the
+ *  returned pixels and frees them with FreeImage(). Returns
+ *  false when every queued file has been returned.
+ ***********************************************************/
+bool TextureLoader::WaitForNext(DECODED_IMAGE& image)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (0 == m_pendingCount)
+	{
+		return false;
+	}
+
+	m_imageReady.wait(lock, [this] { return !m_decoded.empty(); });
+
+	image = m_decoded.front();
+	m_decoded.pop_front();
+	m_pendingCount--;
+	return true;
+}
+
+/***********************************************************
+ *  FreeImage()
+ *
+ *  This method frees the pixels of a returned image.
+ ***********************************************************/
+void TextureLoader::FreeImage(DECODED_IMAGE& image)
+{
+	if (nullptr != image.pixels)
+	{
+		stbi_image_free(image.pixels);
+		image.pixels = nullptr;
+	}
+}
+
+/***********************************************************
+ *  GetWorkerCount()
+ *
+ *  This method returns the number of worker threads.
+ ***********************************************************/
+int TextureLoader::GetWorkerCount() const
+{
+	return static_cast<int>(m_workers.size());
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method is run by each worker thread. It decodes one
+ *  queued file at a time, outside the lock, until the loader
+ *  is destroyed. The vertical flip must be configured with
+ *  stbi_set_flip_vertically_on_load() before files are
+ *  queued, since that setting is shared by all threads.
+ ***********************************************************/
+void TextureLoader::WorkerMain()
+{
+	TRACE_THREAD_NAME("texture loader");
+	for (;;)
+	{
+		DECODED_IMAGE job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobReady.wait(lock, [this] { return m_bStopping || !m_jobs.empty(); });
+			if (m_bStopping)
+			{
+				return;
+			}
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		TRACE_SCOPE("DecodeTexture");
+		job.pixels = stbi_load(
+			job.filename.c_str(),
+			&job.width,
+			&job.height,
+			&job.colorChannels,
+			0);
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_decoded.push_back(job);
+		}
+		m_imageReady.notify_one();
+	}
+}
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture image files on a pool of worker threads
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class decodes image files with stb_image on worker
+ *  threads. The thread that owns the OpenGL context queues
+ *  the files, then collects each decoded image as soon as it
+ *  is ready and uploads it while the remaining files are
+ *  still being decoded. No OpenGL calls are made here.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// constructor (workerCount <= 0 uses one worker per hardware thread)
+	explicit TextureLoader(int workerCount);
+	// destructor, waits for the workers to finish
+	~TextureLoader();
+
+	// pixels decoded from one queued file
+	struct DECODED_IMAGE
+	{
+		int requestIndex;       // order in which the file was queued
+		std::string filename;
+		unsigned char* pixels;  // null if the file could not be decoded
+		int width;
+		int height;
+		int colorChannels;
+	};
+
+	// queue a file for decoding and return its request index
+	int Enqueue(const std::string& filename);
+	// wait for the next decoded image; false once every queued file was returned
+	bool WaitForNext(DECODED_IMAGE& image);
+	// free the pixels of a returned image
+	static void FreeImage(DECODED_IMAGE& image);
+
+	// number of worker threads
+	int GetWorkerCount() const;
+
+private:
+	// decode queued files until the loader is destroyed
+	void WorkerMain();
+
+	std::vector<std::thread> m_workers;
+
+	// guards every member below
+	std::mutex m_mutex;
+	// signalled when a file is queued or the loader is stopping
+	std::condition_variable m_jobReady;
+	// signalled when a decoded image is ready
+	std::condition_variable m_imageReady;
+
+	std::deque<DECODED_IMAGE> m_jobs;
+	std::deque<DECODED_IMAGE> m_decoded;
+	// files queued but not yet returned by WaitForNext()
+	int m_pendingCount;
+	int m_nextRequestIndex;
+	bool m_bStopping;
+};
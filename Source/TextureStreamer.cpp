@@ -0,0 +1,453 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.cpp
+// ============
+// load textures through a persistently mapped staging buffer while rendering
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureStreamer.h"
+
+// the stb_image implementation is compiled in SceneManager.cpp
+#include "stb_image.h"
+#include "Trace.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables and constants
+namespace
+{
+	// staging blocks start on this boundary
+	const size_t STAGING_ALIGNMENT = 256;
+	// streamed images are always expanded to RGBA
+	const int STREAMED_CHANNELS = 4;
+
+	// number of mip levels in a complete chain for the passed in size
+	GLsizei CountMipLevels(int width, int height)
+	{
+		GLsizei levels = 1;
+		while ((std::max(width, height) >> levels) > 0)
+		{
+			levels++;
+		}
+		return levels;
+	}
+}
+
+/***********************************************************
+ *  TextureStreamer()
+ *
+ *  The constructor for the class. It must be called on the
+ *  thread that owns the OpenGL context, which creates the
+ *  staging ring and maps it once for its whole life.
+ ***********************************************************/
+TextureStreamer::TextureStreamer(size_t stagingSize, int workerCount)
+{
+	m_stagingSize = stagingSize;
+	m_firstBlockID = 0;
+	m_head = 0;
+	m_tail = 0;
+	m_pendingCount = 0;
+	m_bStopping = false;
+
+	const GLbitfield mapFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glGenBuffers(1, &m_stagingBuffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer);
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, m_stagingSize, nullptr, mapFlags);
+	m_pStaging = static_cast<unsigned char*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, m_stagingSize, mapFlags));
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (nullptr == m_pStaging)
+	{
+		// every image is then uploaded directly
+		std::cout << "Could not map the texture staging buffer" << std::endl;
+		m_stagingSize = 0;
+	}
+
+	for (int i = 0; i < std::max(1, workerCount); i++)
+	{
+		m_workers.emplace_back(&TextureStreamer::WorkerMain, this);
+	}
+}
+
+/***********************************************************
+ *  ~TextureStreamer()
+ *
+ *  The destructor for the class. Requests still queued are
+ *  dropped, and textures never returned are deleted.
+ ***********************************************************/
+TextureStreamer::~TextureStreamer()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopping = true;
+		m_jobs.clear();
+	}
+	m_jobReady.notify_all();
+	m_stagingReleased.notify_all();
+
+	for (std::thread& worker : m_workers)
+	{
+		worker.join();
+	}
+
+	for (UPLOAD& upload : m_staged)
+	{
+		if (nullptr != upload.pixels)
+		{
+			stbi_image_free(upload.pixels);
+		}
+	}
+	for (UPLOAD& upload : m_inFlight)
+	{
+		glDeleteSync(upload.fence);
+		glDeleteTextures(1, &upload.textureID);
+	}
+	for (STREAMED_TEXTURE& texture : m_ready)
+	{
+		if (0 != texture.textureID)
+		{
+			glDeleteTextures(1, &texture.textureID);
+		}
+	}
+
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer);
+	if (nullptr != m_pStaging)
+	{
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		m_pStaging = nullptr;
+	}
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glDeleteBuffers(1, &m_stagingBuffer);
+	m_stagingBuffer = 0;
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method returns true if the current context can create
+ *  persistently mapped buffers.
+ ***********************************************************/
+bool TextureStreamer::IsSupported()
+{
+	return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+/***********************************************************
+ *  Request()
+ *
+ *  This method queues the passed in image file to be decoded
+ *  and uploaded. The texture is returned by PollReady() with
+ *  the passed in tag. Images are flipped according to the
+ *  shared stbi_set_flip_vertically_on_load() setting.
+ ***********************************************************/
+void TextureStreamer::Request(const std::string& filename, const std::string& tag)
+{
+	UPLOAD job = UPLOAD();
+	job.filename = filename;
+	job.tag = tag;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(job);
+		m_pendingCount++;
+	}
+	m_jobReady.notify_one();
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method must be called once per frame on the thread
+ *  that owns the OpenGL context. It starts the upload of
+ *  every image the workers have staged, then checks the
+ *  fences of the uploads in flight without waiting; uploads
+ *  whose fence has signalled become ready and release their
+ *  staging memory.
+ ***********************************************************/
+void TextureStreamer::Update()
+{
+	std::deque<UPLOAD> staged;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		staged.swap(m_staged);
+	}
+
+	for (UPLOAD& upload : staged)
+	{
+		if (!upload.bStaged && (nullptr == upload.pixels))
+		{
+			// the file could not be decoded
+			STREAMED_TEXTURE failed;
+			failed.tag = upload.tag;
+			failed.textureID = 0;
+			m_ready.push_back(failed);
+			continue;
+		}
+		StartUpload(upload);
+		m_inFlight.push_back(upload);
+	}
+
+	bool bReleased = false;
+	for (size_t i = 0; i < m_inFlight.size();)
+	{
+		UPLOAD& upload = m_inFlight[i];
+		GLint status = GL_UNSIGNALED;
+		glGetSynciv(upload.fence, GL_SYNC_STATUS, sizeof(status), nullptr, &status);
+		if (GL_SIGNALED != status)
+		{
+			i++;
+			continue;
+		}
+
+		glDeleteSync(upload.fence);
+		if (upload.bStaged)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_blocks[upload.blockID - m_firstBlockID].bReleased = true;
+			bReleased = true;
+		}
+
+		STREAMED_TEXTURE ready;
+		ready.tag = upload.tag;
+		ready.textureID = upload.textureID;
+		m_ready.push_back(ready);
+
+		m_inFlight.erase(m_inFlight.begin() + i);
+	}
+
+	if (bReleased)
+	{
+		RetireBlocks();
+	}
+}
+
+/***********************************************************
+ *  StartUpload()
+ *
+ *  This method creates the texture of the passed in upload
+ *  and queues the copy of its pixels, from the staging ring
+ *  or, for an image too big to stage, from the decoded
+ *  pixels, followed by mipmap generation and a fence.
+ ***********************************************************/
+void TextureStreamer::StartUpload(UPLOAD& upload)
+{
+	glGenTextures(1, &upload.textureID);
+	glBindTexture(GL_TEXTURE_2D, upload.textureID);
+	glTexStorage2D(GL_TEXTURE_2D, CountMipLevels(upload.width, upload.height), GL_RGBA8, upload.width, upload.height);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	if (upload.bStaged)
+	{
+		size_t offset = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			offset = m_blocks[upload.blockID - m_firstBlockID].offset;
+		}
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, upload.width, upload.height,
+			GL_RGBA, GL_UNSIGNED_BYTE, reinterpret_cast<const void*>(offset));
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+	else
+	{
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, upload.width, upload.height,
+			GL_RGBA, GL_UNSIGNED_BYTE, upload.pixels);
+		stbi_image_free(upload.pixels);
+		upload.pixels = nullptr;
+	}
+
+	glGenerateMipmap(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	upload.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	// make sure the fence reaches the GPU so polling it can succeed
+	glFlush();
+}
+
+/***********************************************************
+ *  RetireBlocks()
+ *
+ *  This method hands the staging memory at the front of the
+ *  ring back to the workers, up to the oldest block whose
+ *  upload is still in flight.
+ ***********************************************************/
+void TextureStreamer::RetireBlocks()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		while (!m_blocks.empty() && m_blocks.front().bReleased)
+		{
+			m_blocks.pop_front();
+			m_firstBlockID++;
+		}
+		m_tail = m_blocks.empty() ? m_head : m_blocks.front().offset;
+	}
+	m_stagingReleased.notify_all();
+}
+
+/***********************************************************
+ *  PollReady()
+ *
+ *  This method returns the next texture whose upload has
+ *  completed. The caller owns the returned texture. Returns
+ *  false if no texture is ready.
+ ***********************************************************/
+bool TextureStreamer::PollReady(STREAMED_TEXTURE& texture)
+{
+	if (m_ready.empty())
+	{
+		return false;
+	}
+
+	texture = m_ready.front();
+	m_ready.pop_front();
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_pendingCount--;
+	return true;
+}
+
+/***********************************************************
+ *  GetPendingCount()
+ *
+ *  This method returns the number of requested textures that
+ *  have not been returned by PollReady().
+ ***********************************************************/
+int TextureStreamer::GetPendingCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_pendingCount;
+}
+
+/***********************************************************
+ *  AllocateStaging()
+ *
+ *  This method reserves a block of the staging ring, waiting
+ *  until enough earlier uploads have retired if the ring is
+ *  full. A block that does not fit before the end of the ring
+ *  starts over at its beginning. Must be called with m_mutex
+ *  unlocked. Returns false if the streamer is stopping.
+ ***********************************************************/
+bool TextureStreamer::AllocateStaging(size_t size, uint64_t& blockID, size_t& offset)
+{
+	size = (size + STAGING_ALIGNMENT - 1) / STAGING_ALIGNMENT * STAGING_ALIGNMENT;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;)
+	{
+		if (m_bStopping)
+		{
+			return false;
+		}
+
+		if (m_blocks.empty())
+		{
+			m_head = 0;
+			m_tail = 0;
+		}
+
+		bool bFits = false;
+		if (m_blocks.empty() || (m_head > m_tail))
+		{
+			// free space at the end of the ring, then before the oldest block
+			if (m_stagingSize - m_head >= size)
+			{
+				offset = m_head;
+				bFits = true;
+			}
+			else if (m_tail >= size)
+			{
+				offset = 0;
+				bFits = true;
+			}
+		}
+		else if ((m_head < m_tail) && (m_tail - m_head >= size))
+		{
+			offset = m_head;
+			bFits = true;
+		}
+
+		if (bFits)
+		{
+			STAGING_BLOCK block;
+			block.offset = offset;
+			block.size = size;
+			block.bReleased = false;
+			m_blocks.push_back(block);
+			blockID = m_firstBlockID + m_blocks.size() - 1;
+			m_head = offset + size;
+			return true;
+		}
+
+		m_stagingReleased.wait(lock);
+	}
+}
+
+/***********************************************************
+ *  WorkerMain()
+ *
+ *  This method is run by each worker thread. It decodes one
+ *  requested file at a time and copies the pixels into the
+ *  staging ring, so that the render thread only has to start
+ *  the upload.
+ ***********************************************************/
+void TextureStreamer::WorkerMain()
+{
+	TRACE_THREAD_NAME("texture streamer");
+	for (;;)
+	{
+		UPLOAD job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_jobReady.wait(lock, [this] { return m_bStopping || !m_jobs.empty(); });
+			if (m_bStopping)
+			{
+				return;
+			}
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+
+		TRACE_SCOPE("StreamTexture");
+		int colorChannels = 0;
+		unsigned char* pixels = stbi_load(job.filename.c_str(), &job.width, &job.height, &colorChannels, STREAMED_CHANNELS);
+		if (nullptr == pixels)
+		{
+			std::cout << "Could not load image:" << job.filename << std::endl;
+			job.width = 0;
+			job.height = 0;
+		}
+		else
+		{
+			const size_t size = static_cast<size_t>(job.width) * job.height * STREAMED_CHANNELS;
+			size_t offset = 0;
+			if (size > m_stagingSize)
+			{
+				// too big to stage, Update() uploads the pixels directly
+				job.pixels = pixels;
+			}
+			else if (AllocateStaging(size, job.blockID, offset))
+			{
+				// the mapping is coherent, so the copy needs no flush
+				memcpy(m_pStaging + offset, pixels, size);
+				stbi_image_free(pixels);
+				job.bStaged = true;
+			}
+			else
+			{
+				stbi_image_free(pixels);
+				return;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_staged.push_back(job);
+		}
+	}
+}
@@ -0,0 +1,129 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturestreamer.h
+// ============
+// load textures through a persistently mapped staging buffer while rendering
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureStreamer
+ *
+ *  This class loads textures while the scene keeps rendering.
+ *  Worker threads decode the requested image files and copy
+ *  the pixels straight into a ring of staging memory in a
+ *  pixel unpack buffer that stays mapped for its whole life
+ *  (glBufferStorage() with GL_MAP_PERSISTENT_BIT). Once per
+ *  frame, Update() starts the uploads of the staged images as
+ *  buffer-to-texture copies, each followed by a fence, and
+ *  polls the fences of earlier uploads. A texture is returned
+ *  by PollReady() only after its fence has signalled, and its
+ *  staging memory is then handed back to the workers, so the
+ *  render thread never waits for the GPU or the decoder.
+ *
+ *  Requires OpenGL 4.4 or ARB_buffer_storage. Images bigger
+ *  than the staging ring are uploaded directly instead.
+ ***********************************************************/
+class TextureStreamer
+{
+public:
+	// constructor, creates and maps the staging ring
+	TextureStreamer(size_t stagingSize, int workerCount);
+	// destructor, stops the workers and frees everything not yet returned
+	~TextureStreamer();
+
+	// true if the context supports persistently mapped buffers
+	static bool IsSupported();
+
+	// a texture whose upload has completed
+	struct STREAMED_TEXTURE
+	{
+		std::string tag;
+		GLuint textureID;   // 0 if the file could not be decoded
+	};
+
+	// queue an image file to be decoded and uploaded
+	void Request(const std::string& filename, const std::string& tag);
+	// start staged uploads and retire completed ones, without waiting
+	void Update();
+	// take the next completed texture, false if none is ready
+	bool PollReady(STREAMED_TEXTURE& texture);
+	// number of requests not yet returned by PollReady()
+	int GetPendingCount() const;
+
+private:
+	// a span of the staging ring, released when its upload's fence signals
+	struct STAGING_BLOCK
+	{
+		size_t offset;
+		size_t size;
+		bool bReleased;
+	};
+
+	// one requested image on its way from the file to a texture
+	struct UPLOAD
+	{
+		std::string filename;
+		std::string tag;
+		int width;
+		int height;
+		bool bStaged;            // pixels are in the staging ring
+		uint64_t blockID;        // staging block holding the pixels
+		unsigned char* pixels;   // decoded pixels when not staged (too big)
+		GLuint textureID;
+		GLsync fence;
+	};
+
+	// decode requested files until the streamer is destroyed
+	void WorkerMain();
+	// reserve staging memory, waiting for uploads to retire if it is full
+	bool AllocateStaging(size_t size, uint64_t& blockID, size_t& offset);
+	// create the texture of an upload and start copying its pixels
+	void StartUpload(UPLOAD& upload);
+	// hand back staging memory in front of the ring whose uploads completed
+	void RetireBlocks();
+
+	// staging ring buffer and its persistent mapping
+	GLuint m_stagingBuffer;
+	unsigned char* m_pStaging;
+	size_t m_stagingSize;
+
+	std::vector<std::thread> m_workers;
+
+	// guards every member below
+	mutable std::mutex m_mutex;
+	// signalled when a file is requested or the streamer is stopping
+	std::condition_variable m_jobReady;
+	// signalled when staging memory is released
+	std::condition_variable m_stagingReleased;
+
+	std::deque<UPLOAD> m_jobs;
+	// decoded images waiting for Update() to start their upload
+	std::deque<UPLOAD> m_staged;
+	// staging blocks in ring order, the front one is the oldest
+	std::deque<STAGING_BLOCK> m_blocks;
+	// ID of the block at the front of m_blocks
+	uint64_t m_firstBlockID;
+	// next free byte of the ring and start of the oldest block
+	size_t m_head;
+	size_t m_tail;
+	// requests not yet returned by PollReady()
+	int m_pendingCount;
+	bool m_bStopping;
+
+	// owned by the thread calling Update(), no lock needed
+	std::vector<UPLOAD> m_inFlight;
+	std::deque<STREAMED_TEXTURE> m_ready;
+};
@@ -0,0 +1,239 @@
+///////////////////////////////////////////////////////////////////////////////
+// trace.cpp
+// ============
+// record CPU scopes and export them as a Chrome trace-event timeline
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Trace.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// declaration of global variables and constants
+namespace
+{
+	// events kept per thread; later events are dropped
+	const size_t MAX_EVENTS_PER_THREAD = 1 << 20;
+	// events reserved when a thread records its first event
+	const size_t INITIAL_EVENTS_PER_THREAD = 4096;
+
+	// one finished scope
+	struct TRACE_EVENT
+	{
+		const char* name;
+		int64_t startUs;
+		int64_t durationUs;
+	};
+
+	// events of one thread, only appended to by that thread
+	struct THREAD_BUFFER
+	{
+		int threadID;
+		std::string threadName;
+		std::vector<TRACE_EVENT> events;
+	};
+
+	std::atomic<bool> g_bRecording(false);
+	std::chrono::steady_clock::time_point g_traceStart;
+
+	// every thread's buffer, kept after the thread exits
+	std::mutex g_bufferMutex;
+	std::vector<std::unique_ptr<THREAD_BUFFER>> g_threadBuffers;
+	// the calling thread's buffer, once it has one
+	thread_local THREAD_BUFFER* t_pThreadBuffer = nullptr;
+
+	// the calling thread's buffer, registered on first use
+	THREAD_BUFFER* GetThreadBuffer()
+	{
+		if (nullptr == t_pThreadBuffer)
+		{
+			std::unique_ptr<THREAD_BUFFER> buffer(new THREAD_BUFFER());
+			buffer->events.reserve(INITIAL_EVENTS_PER_THREAD);
+
+			std::lock_guard<std::mutex> lock(g_bufferMutex);
+			buffer->threadID = static_cast<int>(g_threadBuffers.size()) + 1;
+			t_pThreadBuffer = buffer.get();
+			g_threadBuffers.push_back(std::move(buffer));
+		}
+		return t_pThreadBuffer;
+	}
+
+	// a JSON string literal of the passed in text
+	std::string QuoteJson(const std::string& text)
+	{
+		std::string quoted = "\"";
+		for (char c : text)
+		{
+			if ((c == '"') || (c == '\\'))
+			{
+				quoted += '\\';
+			}
+			quoted += c;
+		}
+		return quoted + "\"";
+	}
+}
+
+/***********************************************************
+ *  Start()
+ *
+ *  This method starts recording scopes. Timestamps in the
+ *  trace count from this call.
+ ***********************************************************/
+void Trace::Start()
+{
+	g_traceStart = std::chrono::steady_clock::now();
+	g_bRecording.store(true);
+}
+
+/***********************************************************
+ *  IsRecording()
+ *
+ *  This method returns true while scopes are recorded.
+ ***********************************************************/
+bool Trace::IsRecording()
+{
+	return g_bRecording.load(std::memory_order_relaxed);
+}
+
+/***********************************************************
+ *  NowUs()
+ *
+ *  This method returns the microseconds since Start().
+ ***********************************************************/
+int64_t Trace::NowUs()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - g_traceStart).count();
+}
+
+/***********************************************************
+ *  SetThreadName()
+ *
+ *  This method names the calling thread's track in the
+ *  written timeline.
+ ***********************************************************/
+void Trace::SetThreadName(const char* name)
+{
+	GetThreadBuffer()->threadName = name;
+}
+
+/***********************************************************
+ *  Scope()
+ *
+ *  The constructor for the class. It notes the start time if
+ *  a trace is recording.
+ ***********************************************************/
+Trace::Scope::Scope(const char* name)
+{
+	m_name = name;
+	m_startUs = IsRecording() ? NowUs() : -1;
+}
+
+/***********************************************************
+ *  ~Scope()
+ *
+ *  The destructor for the class. It appends the finished
+ *  scope to the calling thread's buffer.
+ ***********************************************************/
+Trace::Scope::~Scope()
+{
+	End();
+}
+
+/***********************************************************
+ *  Switch()
+ *
+ *  This method ends the scope recorded so far, unless it has
+ *  the passed in name already, and starts a new one.
+ ***********************************************************/
+void Trace::Scope::Switch(const char* name)
+{
+	if (name == m_name)
+	{
+		return;
+	}
+	End();
+	m_name = name;
+	m_startUs = IsRecording() ? NowUs() : -1;
+}
+
+/***********************************************************
+ *  End()
+ *
+ *  This method appends the scope, if it is named and was
+ *  started while recording, to the calling thread's buffer.
+ ***********************************************************/
+void Trace::Scope::End()
+{
+	if ((nullptr == m_name) || (m_startUs < 0) || !IsRecording())
+	{
+		return;
+	}
+
+	THREAD_BUFFER* buffer = GetThreadBuffer();
+	if (buffer->events.size() < MAX_EVENTS_PER_THREAD)
+	{
+		TRACE_EVENT event;
+		event.name = m_name;
+		event.startUs = m_startUs;
+		event.durationUs = NowUs() - m_startUs;
+		buffer->events.push_back(event);
+	}
+}
+
+/***********************************************************
+ *  Write()
+ *
+ *  This method stops recording and writes the events of all
+ *  threads as Chrome trace-event JSON, with the thread names
+ *  as metadata events. Threads must not be recording while
+ *  this runs. Returns false if the file cannot be written.
+ ***********************************************************/
+bool Trace::Write(const char* filename)
+{
+	g_bRecording.store(false);
+
+	std::ofstream file(filename);
+	if (!file)
+	{
+		std::cout << "Could not write trace:" << filename << std::endl;
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(g_bufferMutex);
+	size_t eventCount = 0;
+	bool bFirst = true;
+	file << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+	for (const std::unique_ptr<THREAD_BUFFER>& buffer : g_threadBuffers)
+	{
+		if (!buffer->threadName.empty())
+		{
+			file << (bFirst ? "" : ",\n")
+				<< "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << buffer->threadID
+				<< ", \"args\": {\"name\": " << QuoteJson(buffer->threadName) << "}}";
+			bFirst = false;
+		}
+
+		for (const TRACE_EVENT& event : buffer->events)
+		{
+			file << (bFirst ? "" : ",\n")
+				<< "{\"name\": " << QuoteJson(event.name) << ", \"cat\": \"cpu\", \"ph\": \"X\""
+				<< ", \"ts\": " << event.startUs << ", \"dur\": " << event.durationUs
+				<< ", \"pid\": 1, \"tid\": " << buffer->threadID << "}";
+			bFirst = false;
+		}
+		eventCount += buffer->events.size();
+	}
+	file << "\n]}\n";
+
+	std::cout << "Wrote trace of " << eventCount << " events:" << filename << std::endl;
+	return true;
+}
@@ -0,0 +1,89 @@
+///////////////////////////////////////////////////////////////////////////////
+// trace.h
+// ============
+// record CPU scopes and export them as a Chrome trace-event timeline
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+
+// scopes are compiled into debug builds, and into release builds
+// only when ENABLE_TRACING is defined
+#if defined(_DEBUG) || defined(ENABLE_TRACING)
+#define TRACING_COMPILED 1
+#endif
+
+/***********************************************************
+ *  Trace
+ *
+ *  This class records the start and duration of named CPU
+ *  scopes while a trace is running, and writes them as
+ *  Chrome trace-event JSON, which chrome://tracing and
+ *  Perfetto open as a timeline with one track per thread.
+ *
+ *  Every thread appends to its own buffer without locking;
+ *  the registry of buffers is locked only when a thread
+ *  records its first event and when the trace is written.
+ *  Write the trace once the worker threads have finished.
+ *
+ *  Instrument code with the macros rather than the class:
+ *    TRACE_SCOPE("RenderScene");        // until the end of the block
+ *    TRACE_THREAD_NAME("texture loader");
+ *  A loop whose iterations fall into runs, such as draws of
+ *  one render group, records one scope per run with:
+ *    TRACE_SPAN(groupSpan);             // records nothing yet
+ *    TRACE_SPAN_NAME(groupSpan, name);  // ends the run if the name changed
+ *  Scope names must be string literals or other strings that
+ *  outlive the trace, since only the pointer is recorded.
+ ***********************************************************/
+class Trace
+{
+public:
+	// start recording, with timestamps relative to now
+	static void Start();
+	// true while recording
+	static bool IsRecording();
+	// stop recording and write every event as trace-event JSON
+	static bool Write(const char* filename);
+
+	// name the calling thread's track in the timeline
+	static void SetThreadName(const char* name);
+
+	// records a scope from construction to destruction
+	class Scope
+	{
+	public:
+		explicit Scope(const char* name);
+		~Scope();
+		// end the scope unless it has the passed in name, and start
+		// recording a new one with that name
+		void Switch(const char* name);
+
+	private:
+		const char* m_name;  // null until named
+		int64_t m_startUs;   // -1 if not recording at construction
+
+		// append the scope to the calling thread's buffer
+		void End();
+	};
+
+private:
+	// microseconds since Start()
+	static int64_t NowUs();
+};
+
+#ifdef TRACING_COMPILED
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_SPAN(variable) Trace::Scope variable(nullptr)
+#define TRACE_SPAN_NAME(variable, name) variable.Switch(name)
+#define TRACE_THREAD_NAME(name) Trace::SetThreadName(name)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_SPAN(variable) ((void)0)
+#define TRACE_SPAN_NAME(variable, name) ((void)0)
+#define TRACE_THREAD_NAME(name) ((void)0)
+#endif
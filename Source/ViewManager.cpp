@@ -8,20 +8,22 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "ViewManager.h"
+#include "Trace.h"
 
 // GLM Math Header inclusions
 #include <glm/glm.hpp>
 #include <glm/gtx/transform.hpp>
 #include <glm/gtc/type_ptr.hpp>    
 
+#include <fstream>
+#include <vector>
+
 // declaration of the global variables and defines
 namespace
 {
 	// Window configuration constants
 	const int WINDOW_WIDTH = 1000;
 	const int WINDOW_HEIGHT = 800;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
 
 	// Camera movement configuration constants
 	const float DEFAULT_MOVEMENT_SPEED = 2.5f;
@@ -36,6 +38,13 @@ namespace
 	const float MAX_ORTHO_ZOOM = 20.0f;
 	const float ORTHO_ZOOM_INCREMENT = 0.5f;
 
+	// Scripted camera flight configuration constants
+	const glm::vec3 SCRIPTED_TARGET = glm::vec3(0.0f, 2.0f, 0.0f);  // desk center, monitor height
+	const float SCRIPTED_RADIUS = 12.0f;        // distance from the target
+	const float SCRIPTED_HEIGHT = 5.0f;         // camera height above the table
+	const float SCRIPTED_ARC_DEGREES = 120.0f;  // sweep from left to right of the desk
+	const float SCRIPTED_FRAME_TIME = 1.0f / 60.0f;
+
 	// camera object used for viewing and interacting with the 3D scene
 	Camera* g_pCamera = nullptr;
 
@@ -74,7 +83,20 @@ ViewManager::ViewManager(ShaderManager* pShaderManager)
 {
 	// initialize member variables
 	m_pShaderManager = pShaderManager;
+	m_pUniforms = nullptr;
+	m_pStateCache = nullptr;
 	m_pWindow = nullptr;
+	m_bHeadless = false;
+	m_offscreenFBO = 0;
+	m_offscreenColorRBO = 0;
+	m_offscreenDepthRBO = 0;
+	m_targetWidth = 0;
+	m_targetHeight = 0;
+	m_scriptedFrameCount = 0;
+	m_scriptedFrameIndex = 0;
+	m_uniformUploads = 0;
+	m_viewProjection = glm::mat4(1.0f);
+	m_debugView = DebugViews::VIEW_SHADED;
 
 	// create and configure camera with default parameters
 	g_pCamera = new Camera();
@@ -94,7 +116,18 @@ ViewManager::ViewManager(ShaderManager* pShaderManager)
 ViewManager::~ViewManager()
 {
 	// free up allocated memory
+	if (0 != m_offscreenFBO)
+	{
+		glDeleteFramebuffers(1, &m_offscreenFBO);
+		glDeleteRenderbuffers(1, &m_offscreenColorRBO);
+		glDeleteRenderbuffers(1, &m_offscreenDepthRBO);
+		m_offscreenFBO = 0;
+		m_offscreenColorRBO = 0;
+		m_offscreenDepthRBO = 0;
+	}
 	m_pShaderManager = nullptr;
+	m_pUniforms = nullptr;
+	m_pStateCache = nullptr;
 	m_pWindow = nullptr;
 	if (nullptr != g_pCamera)
 	{
@@ -108,11 +141,14 @@ ViewManager::~ViewManager()
  *
  *  Creates the main GLFW display window and configures input callbacks.
  *  Sets up mouse capture, transparency support, and input event handling.
+ *  In headless mode the window stays hidden and only owns the context;
+ *  no input is captured.
  *
  *  @param windowTitle - The title to display in the window title bar
+ *  @param bHeadless - True to skip input setup for offscreen rendering
  *  @return GLFWwindow* - Pointer to the created window, or nullptr on failure
  ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle, bool bHeadless)
 {
 	GLFWwindow* window = nullptr;
 
@@ -125,22 +161,117 @@ GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
 		return nullptr;
 	}
 	glfwMakeContextCurrent(window);
+	m_bHeadless = bHeadless;
+	// the default viewport covers the framebuffer at this size,
+	// and nothing resizes it later
+	glfwGetFramebufferSize(window, &m_targetWidth, &m_targetHeight);
 
-	// configure mouse input callbacks
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
-
-	// hide and lock cursor to window center for camera controls
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	if (!bHeadless)
+	{
+		// configure mouse input callbacks
+		glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+		glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
 
-	// enable alpha blending for transparent rendering support
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		// hide and lock cursor to window center for camera controls
+		glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+	}
 
 	m_pWindow = window;
 	return window;
 }
 
+/***********************************************************
+ *  CreateOffscreenTarget()
+ *
+ *  Creates a framebuffer object with color and depth
+ *  renderbuffers matching the window size and binds it as
+ *  the render target. Must be called after GLEW is initialized.
+ *
+ *  @return bool - True if the framebuffer is complete
+ ***********************************************************/
+bool ViewManager::CreateOffscreenTarget()
+{
+	glGenFramebuffers(1, &m_offscreenFBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_offscreenFBO);
+
+	// color attachment read back by SaveFrameImage()
+	glGenRenderbuffers(1, &m_offscreenColorRBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_offscreenColorRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, WINDOW_WIDTH, WINDOW_HEIGHT);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_offscreenColorRBO);
+
+	// depth attachment for z-buffered rendering
+	glGenRenderbuffers(1, &m_offscreenDepthRBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_offscreenDepthRBO);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, WINDOW_WIDTH, WINDOW_HEIGHT);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_offscreenDepthRBO);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+	{
+		std::cout << "Failed to create offscreen framebuffer" << std::endl;
+		return false;
+	}
+
+	// the framebuffer stays bound for the rest of the run
+	glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
+	m_targetWidth = WINDOW_WIDTH;
+	m_targetHeight = WINDOW_HEIGHT;
+	return true;
+}
+
+/***********************************************************
+ *  SaveFrameImage()
+ *
+ *  Reads back the color buffer of the current render target
+ *  and writes it to disk as a binary PPM (P6) image. With a
+ *  window, call it before the buffers are swapped, and the
+ *  image has the window's current framebuffer size.
+ *
+ *  @param filename - Path of the image file to write
+ *  @return bool - True if the image was written
+ ***********************************************************/
+bool ViewManager::SaveFrameImage(const char* filename)
+{
+	// the offscreen target keeps its size; a window may have been resized
+	int width = WINDOW_WIDTH;
+	int height = WINDOW_HEIGHT;
+	if (!m_bHeadless)
+	{
+		glfwGetFramebufferSize(m_pWindow, &width, &height);
+	}
+	if ((width <= 0) || (height <= 0))
+	{
+		std::cout << "Could not write image, the framebuffer is empty:" << filename << std::endl;
+		return false;
+	}
+
+	std::vector<unsigned char> pixels(static_cast<size_t>(width) * height * 3);
+
+	// wait for rendering to finish and read back tightly packed rows
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+	std::ofstream file(filename, std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write image:" << filename << std::endl;
+		return false;
+	}
+
+	file << "P6\n" << width << " " << height << "\n255\n";
+
+	// OpenGL rows start at the bottom, image rows start at the top
+	const size_t rowSize = static_cast<size_t>(width) * 3;
+	for (int row = height - 1; row >= 0; row--)
+	{
+		file.write(reinterpret_cast<const char*>(&pixels[row * rowSize]), rowSize);
+	}
+
+	std::cout << "Saved frame image:" << filename << std::endl;
+	return true;
+}
+
 /***********************************************************
  *  Mouse_Position_Callback()
  *
@@ -204,8 +335,9 @@ void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xoffset, doub
  *  ProcessKeyboardEvents()
  *
  *  Processes keyboard input for camera movement and projection mode switching.
- *  Handles WASD movement, Q/E vertical movement, ESC to exit, and P/O for
- *  projection mode toggling.
+ *  Handles WASD movement, Q/E vertical movement, ESC to exit, P/O for
+ *  projection mode toggling, and F1/F2/F3 for the shaded, overdraw and
+ *  draw order views.
  ***********************************************************/
 void ViewManager::ProcessKeyboardEvents()
 {
@@ -239,6 +371,103 @@ void ViewManager::ProcessKeyboardEvents()
 		g_isOrthographicMode = false;  // switch to perspective mode
 	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
 		g_isOrthographicMode = true;   // switch to orthographic mode
+
+	// debug view switching controls
+	if (glfwGetKey(m_pWindow, GLFW_KEY_F1) == GLFW_PRESS)
+		m_debugView = DebugViews::VIEW_SHADED;      // normal lit scene
+	if (glfwGetKey(m_pWindow, GLFW_KEY_F2) == GLFW_PRESS)
+		m_debugView = DebugViews::VIEW_OVERDRAW;    // shaded fragments heat map
+	if (glfwGetKey(m_pWindow, GLFW_KEY_F3) == GLFW_PRESS)
+		m_debugView = DebugViews::VIEW_DRAW_ORDER;  // submission order colors
+}
+
+/***********************************************************
+ *  SetShaderUniforms()
+ *
+ *  Sets the uniform locations, resolved after the shaders are
+ *  loaded, that the view and projection matrices are written to.
+ *
+ *  @param pUniforms - Resolved uniform locations of the scene shader
+ *  @param pStateCache - State cache the uniforms are written through
+ ***********************************************************/
+void ViewManager::SetShaderUniforms(const ShaderUniforms* pUniforms, GLStateCache* pStateCache)
+{
+	m_pUniforms = pUniforms;
+	m_pStateCache = pStateCache;
+}
+
+/***********************************************************
+ *  EnableScriptedCamera()
+ *
+ *  Replaces keyboard and mouse control with a fixed flight that
+ *  sweeps the camera in an arc around the desk over the given
+ *  number of frames, so that benchmark runs are repeatable.
+ *
+ *  @param frameCount - Number of frames the flight is spread over
+ ***********************************************************/
+void ViewManager::EnableScriptedCamera(int frameCount)
+{
+	m_scriptedFrameCount = frameCount;
+	m_scriptedFrameIndex = 0;
+}
+
+/***********************************************************
+ *  GetUniformUploadCount()
+ *
+ *  Returns the number of uniform values that were written by
+ *  the most recent PrepareSceneView() call; values unchanged
+ *  since the previous frame are not written.
+ ***********************************************************/
+int ViewManager::GetUniformUploadCount() const
+{
+	return m_uniformUploads;
+}
+
+/***********************************************************
+ *  GetViewProjection()
+ *
+ *  This method returns the combined projection and view
+ *  matrix built by the most recent PrepareSceneView() call,
+ *  from which the view frustum can be derived.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetViewProjection() const
+{
+	return m_viewProjection;
+}
+
+/***********************************************************
+ *  GetDebugView()
+ *
+ *  Returns the debug view selected with the function keys,
+ *  which the scene manager draws instead of the lit scene.
+ ***********************************************************/
+DebugViews::VIEW ViewManager::GetDebugView() const
+{
+	return m_debugView;
+}
+
+/***********************************************************
+ *  GetTargetFramebuffer()
+ *
+ *  Returns the framebuffer the scene is drawn into: the
+ *  offscreen target when rendering headless, otherwise 0 for
+ *  the window.
+ ***********************************************************/
+GLuint ViewManager::GetTargetFramebuffer() const
+{
+	return m_offscreenFBO;
+}
+
+/***********************************************************
+ *  GetTargetSize()
+ *
+ *  Returns the size in pixels of the framebuffer the scene is
+ *  drawn into, which the viewport covers.
+ ***********************************************************/
+void ViewManager::GetTargetSize(int& width, int& height) const
+{
+	width = m_targetWidth;
+	height = m_targetHeight;
 }
 
 /***********************************************************
@@ -250,16 +479,31 @@ void ViewManager::ProcessKeyboardEvents()
  ***********************************************************/
 void ViewManager::PrepareSceneView()
 {
+	TRACE_SCOPE("PrepareSceneView");
 	glm::mat4 view;
 	glm::mat4 projection;
 
-	// calculate per-frame timing for smooth, frame-rate independent movement
-	float currentFrame = glfwGetTime();
-	g_deltaTime = currentFrame - g_lastFrameTime;
-	g_lastFrameTime = currentFrame;
+	if (m_scriptedFrameCount > 0)
+	{
+		// follow the scripted flight with a fixed time step
+		float progress = static_cast<float>(m_scriptedFrameIndex) / static_cast<float>(m_scriptedFrameCount);
+		float angle = glm::radians((progress - 0.5f) * SCRIPTED_ARC_DEGREES);
+		g_pCamera->Position = SCRIPTED_TARGET + glm::vec3(
+			SCRIPTED_RADIUS * sinf(angle), SCRIPTED_HEIGHT, SCRIPTED_RADIUS * cosf(angle));
+		g_pCamera->Front = glm::normalize(SCRIPTED_TARGET - g_pCamera->Position);
+		g_deltaTime = SCRIPTED_FRAME_TIME;
+		m_scriptedFrameIndex++;
+	}
+	else
+	{
+		// calculate per-frame timing for smooth, frame-rate independent movement
+		float currentFrame = glfwGetTime();
+		g_deltaTime = currentFrame - g_lastFrameTime;
+		g_lastFrameTime = currentFrame;
 
-	// process keyboard and mouse input events
-	ProcessKeyboardEvents();
+		// process keyboard and mouse input events
+		ProcessKeyboardEvents();
+	}
 
 	// get current camera view matrix
 	view = g_pCamera->GetViewMatrix();
@@ -280,11 +524,14 @@ void ViewManager::PrepareSceneView()
 		                            0.1f, 100.0f);
 	}
 
+	m_viewProjection = projection * view;
+
 	// update shader uniforms with current matrices and camera position
-	if (nullptr != m_pShaderManager)
+	m_uniformUploads = 0;
+	if ((nullptr != m_pUniforms) && (nullptr != m_pStateCache))
 	{
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
+		m_uniformUploads += m_pStateCache->SetMat4(m_pUniforms->view, view) ? 1 : 0;
+		m_uniformUploads += m_pStateCache->SetMat4(m_pUniforms->projection, projection) ? 1 : 0;
+		m_uniformUploads += m_pStateCache->SetVec3(m_pUniforms->viewPosition, g_pCamera->Position) ? 1 : 0;
 	}
 }
\ No newline at end of file
@@ -9,7 +9,10 @@
 
 #pragma once
 
+#include "DebugViews.h"
+#include "GLStateCache.h"
 #include "ShaderManager.h"
+#include "ShaderUniforms.h"
 #include "camera.h"
 
 // GLFW library
@@ -32,15 +35,56 @@ public:
 private:
 	// pointer to shader manager object
 	ShaderManager* m_pShaderManager;
+	// pointer to the resolved shader uniform locations
+	const ShaderUniforms* m_pUniforms;
+	// state cache the view uniforms are written through
+	GLStateCache* m_pStateCache;
 	// active OpenGL display window
 	GLFWwindow* m_pWindow;
+	// true when rendering offscreen with no visible window
+	bool m_bHeadless;
+	// offscreen framebuffer and its color/depth attachments
+	GLuint m_offscreenFBO;
+	GLuint m_offscreenColorRBO;
+	GLuint m_offscreenDepthRBO;
+	// size of the render target, which is also the viewport
+	int m_targetWidth;
+	int m_targetHeight;
+	// scripted camera flight used for benchmarking
+	int m_scriptedFrameCount;
+	int m_scriptedFrameIndex;
+	// uniform values written by the last PrepareSceneView()
+	int m_uniformUploads;
+	// projection * view built by the last PrepareSceneView()
+	glm::mat4 m_viewProjection;
+	// debug view selected with the function keys
+	DebugViews::VIEW m_debugView;
 
 	// process keyboard events for interaction with the 3D scene
 	void ProcessKeyboardEvents();
 
 public:
 	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle, bool bHeadless = false);
+	// create the framebuffer object used as the headless render target
+	bool CreateOffscreenTarget();
+	// save the current contents of the render target to an image file
+	bool SaveFrameImage(const char* filename);
+	
+	// set the uniform locations used for the view uploads, and the
+	// state cache that drops them while the camera is still
+	void SetShaderUniforms(const ShaderUniforms* pUniforms, GLStateCache* pStateCache);
+	// replace user input with a fixed camera flight over the given frames
+	void EnableScriptedCamera(int frameCount);
+	// number of uniform values written by the last PrepareSceneView()
+	int GetUniformUploadCount() const;
+	// projection * view matrix of the last PrepareSceneView()
+	const glm::mat4& GetViewProjection() const;
+	// debug view selected with the F1 to F3 keys
+	DebugViews::VIEW GetDebugView() const;
+	// framebuffer the scene is drawn into (0 = the window) and its size
+	GLuint GetTargetFramebuffer() const;
+	void GetTargetSize(int& width, int& height) const;
 	
 	// prepare the conversion from 3D object display to 2D scene display
 	void PrepareSceneView();